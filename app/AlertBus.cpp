@@ -0,0 +1,152 @@
+/**
+ * @file AlertBus.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Alert Bus definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <exception>
+
+#include "../include/AlertBus.hpp"
+
+namespace {
+
+/**
+ * @brief Empty polls a handler yields for before it starts sleeping
+ * 
+ */
+const int spin_polls = 64;
+
+}  // namespace
+
+bool AlertBus::Subscription::poll(AlertEvent* event) {
+    std::uint64_t skipped;
+    bool got = bus->ring.read(&cursor, event, &skipped);
+    if (skipped) bus->lost.fetch_add(skipped, std::memory_order_relaxed);
+    if (!got) return false;
+    bus->delivered.fetch_add(1, std::memory_order_relaxed);
+    if (event->arrival_ns != 0) {
+        bus->latency.record(std::chrono::steady_clock::now() -
+            std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(event->arrival_ns)));
+    }
+    return true;
+}
+
+AlertBus::AlertBus(std::size_t capacity,
+        std::chrono::microseconds _poll_interval) :
+        ring{capacity}, poll_interval{_poll_interval} {}
+
+AlertBus::~AlertBus() {
+    try {
+        finish();
+    } catch (...) {}
+}
+
+void AlertBus::handler_loop(Handler handler, Subscription subscription) {
+    AlertEvent event;
+    int idle = 0;
+    try {
+        while (true) {
+            if (subscription.poll(&event)) {
+                handler(event);
+                idle = 0;
+            } else if (finishing.load(std::memory_order_acquire)) {
+                // Everything published before finish() is visible now
+                while (subscription.poll(&event)) handler(event);
+                return;
+            } else if (++idle < spin_polls) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(poll_interval);
+            }
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(handler_mtx);
+        if (!handler_error) handler_error = std::current_exception();
+    }
+}
+
+std::uint64_t AlertBus::publish(AlertEvent event) {
+    event.sequence = ring.size() + 1;
+    ring.publish(event);
+    return event.sequence;
+}
+
+AlertBus::Subscription AlertBus::subscribe() {
+    return Subscription(this, ring.tail());
+}
+
+void AlertBus::subscribe(Handler handler) {
+    std::lock_guard<std::mutex> lock(handler_mtx);
+    handlers.emplace_back(&AlertBus::handler_loop, this, std::move(handler),
+        subscribe());
+}
+
+void AlertBus::finish() {
+    std::vector<std::thread> running;
+    {
+        std::lock_guard<std::mutex> lock(handler_mtx);
+        running.swap(handlers);
+    }
+    finishing.store(true, std::memory_order_release);
+    for (auto& handler : running) handler.join();
+    finishing.store(false, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(handler_mtx);
+    if (handler_error) {
+        auto error = handler_error;
+        handler_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+AlertBusStats AlertBus::get_stats() const {
+    AlertBusStats stats;
+    stats.published = ring.size();
+    stats.delivered = delivered.load(std::memory_order_relaxed);
+    stats.lost = lost.load(std::memory_order_relaxed);
+    stats.latency = latency.summary();
+    return stats;
+}
+
+AlertLevel AlertBus::classify(double distance, double low_threshold,
+        double high_threshold) {
+    if (distance < high_threshold) return AlertLevel::STOP;
+    if (distance <= low_threshold) return AlertLevel::REDIRECT;
+    return AlertLevel::CONTINUE;
+}
+
+AlertBus::Handler AlertBus::console(std::ostream& out) {
+    return [&out](const AlertEvent& event) {
+        if (event.people == 0) {
+            out << "No human detected. Robot will continue its current "
+                "path.\n";
+            return;
+        }
+        out << "Human is " << event.min_distance << " meters away";
+        switch (event.level) {
+        case AlertLevel::STOP:
+            out << ", danger!\nRobot needs to stop.\n";
+            break;
+        case AlertLevel::REDIRECT:
+            out << ".\nRobot needs to redirect its path.\n";
+            break;
+        case AlertLevel::CONTINUE:
+            out << ".\nRobot will continue its current path.\n";
+            break;
+        }
+    };
+}
@@ -0,0 +1,132 @@
+/**
+ * @file AnnotationSink.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Annotation Sink definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <array>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/AnnotationSink.hpp"
+
+AnnotationSink::AnnotationSink(const std::array<int, 2>& _img_dim,
+        Output _output, std::size_t capacity) :
+        img_dim{_img_dim}, output{std::move(_output)}, queue{capacity} {
+    worker = std::thread(&AnnotationSink::render_loop, this);
+}
+
+AnnotationSink::~AnnotationSink() {
+    queue.close();
+    if (worker.joinable()) worker.join();
+}
+
+void AnnotationSink::render_loop() {
+    Item item;
+    cv::Mat annotated;
+    while (queue.pop(&item)) {
+        try {
+            item.frame.copyTo(annotated);
+            if (item.detections) draw(*item.detections, img_dim, &annotated);
+            if (output) output(annotated);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(stats_mtx);
+            if (!worker_error) worker_error = std::current_exception();
+            queue.close();
+            continue;
+        }
+        {
+            // The previous frame's buffer is reused for the next drawing
+            std::lock_guard<std::mutex> lock(latest_mtx);
+            cv::swap(latest, annotated);
+            latest_taken = false;
+        }
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        stats.rendered++;
+    }
+}
+
+bool AnnotationSink::submit(const cv::Mat& frame,
+        std::shared_ptr<const std::vector<Detection> > detections) {
+    std::size_t dropped = queue.push_evict(Item{frame, std::move(detections)});
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    stats.submitted++;
+    stats.dropped += dropped;
+    return dropped == 0;
+}
+
+void AnnotationSink::finish() {
+    queue.close();
+    if (worker.joinable()) worker.join();
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    if (worker_error) std::rethrow_exception(worker_error);
+}
+
+bool AnnotationSink::take_latest(cv::Mat* frame) {
+    std::lock_guard<std::mutex> lock(latest_mtx);
+    if (latest_taken) return false;
+    latest.copyTo(*frame);
+    latest_taken = true;
+    return true;
+}
+
+AnnotationStats AnnotationSink::get_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    return stats;
+}
+
+void AnnotationSink::draw(const std::vector<Detection>& detections,
+        const std::array<int, 2>& img_dim, cv::Mat* frame) {
+    double scale_x = frame->cols/static_cast<double>(img_dim[0]);
+    double scale_y = frame->rows/static_cast<double>(img_dim[1]);
+    for (const auto& detection : detections) {
+        std::string label = "person";
+        if (detection.confidence > 0)
+            label += cv::format(":%.2f", detection.confidence);
+        int baseLine;
+        cv::Size labelSize = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX,
+            0.5, 1, &baseLine);
+
+        int left = static_cast<int>(std::lround(detection.x*scale_x));
+        int top = static_cast<int>(std::lround(detection.y*scale_y));
+        int right = static_cast<int>(std::lround(
+            (detection.x + detection.width)*scale_x));
+        int bottom = static_cast<int>(std::lround(
+            (detection.y + detection.height)*scale_y));
+        rectangle(*frame, cv::Point(left, top), cv::Point(right, bottom),
+            cv::Scalar(255, 178, 50), 3);
+
+        top = cv::max(top, labelSize.height);
+        rectangle(*frame, cv::Point(left,
+            top - std::round(1.5*labelSize.height)),
+            cv::Point(left + std::round(1.5*labelSize.width), top + baseLine),
+            cv::Scalar(255, 255, 255), cv::FILLED);
+        putText(*frame, label, cv::Point(left, top), cv::FONT_HERSHEY_SIMPLEX,
+            0.75, cv::Scalar(0, 0, 0), 1);
+    }
+}
+
+AnnotationSink::Output AnnotationSink::video(const std::string& path,
+        double fps) {
+    auto writer = std::make_shared<cv::VideoWriter>();
+    return [writer, path, fps](const cv::Mat& frame) {
+        if (!writer->isOpened() && !writer->open(path,
+                cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), fps,
+                frame.size()))
+            throw InvalidFile("Cannot write annotation video " + path + ".");
+        writer->write(frame);
+    };
+}
@@ -0,0 +1,131 @@
+/**
+ * @file CameraRig.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Multi-camera rig definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <array>
+#include <thread>
+#include <vector>
+#include <string>
+#include <exception>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/CameraRig.hpp"
+
+CameraRig::CameraRig(
+        const std::unordered_map<std::string, double>& robot_params) {
+    int num_cameras = static_cast<int>(robot_params.at("RIG_CAMERAS"));
+    if (num_cameras <= 0)
+        throw std::invalid_argument("A camera rig needs at least one "
+            "camera.");
+    merge_distance = get_param(robot_params, "RIG_MERGE_DISTANCE", 0.5);
+    for (int k = 0; k < num_cameras; k++)
+        estimators.emplace_back(camera_params(robot_params, k));
+    detections.resize(estimators.size());
+    camera_xyz.resize(estimators.size());
+}
+
+std::unordered_map<std::string, double> CameraRig::camera_params(
+        const std::unordered_map<std::string, double>& robot_params,
+        int camera) {
+    const std::string prefix = "CAMERA" + std::to_string(camera) + "_";
+    auto params = robot_params;
+    for (const auto& param : robot_params) {
+        if (param.first.compare(0, prefix.size(), prefix) == 0)
+            params[param.first.substr(prefix.size())] = param.second;
+    }
+    return params;
+}
+
+void CameraRig::check_frames(const std::vector<cv::Mat>& frames) const {
+    if (frames.size() != estimators.size())
+        throw std::invalid_argument("A camera rig needs exactly one frame "
+            "per camera.");
+}
+
+void CameraRig::get_xyz(HumanDetector* detector,
+        const std::vector<cv::Mat>& frames,
+        std::vector<std::array<double, 3> >* all_xyz) {
+    check_frames(frames);
+    auto per_frame = detector->detect_batch(frames);
+    for (std::size_t k = 0; k < estimators.size(); k++)
+        estimators[k].estimate_all_xyz(*per_frame[k], &camera_xyz[k]);
+    merge(camera_xyz, all_xyz);
+}
+
+void CameraRig::get_xyz(DetectorPool* pool,
+        const std::vector<cv::Mat>& frames,
+        std::vector<std::array<double, 3> >* all_xyz) {
+    check_frames(frames);
+    std::vector<std::exception_ptr> errors(estimators.size());
+    std::vector<std::thread> workers;
+    for (std::size_t k = 0; k < estimators.size(); k++) {
+        workers.emplace_back([this, pool, &frames, &errors, k]() {
+            try {
+                {
+                    auto detector = pool->acquire();
+                    detector->detect_frame(frames[k], &detections[k]);
+                }
+                estimators[k].estimate_all_xyz(detections[k], &camera_xyz[k]);
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    for (const auto& error : errors)
+        if (error) std::rethrow_exception(error);
+    merge(camera_xyz, all_xyz);
+}
+
+void CameraRig::merge(
+        const std::vector<std::vector<std::array<double, 3> > >& per_camera,
+        std::vector<std::array<double, 3> >* all_xyz) {
+    all_xyz->clear();
+    merged_count.clear();
+    merged_camera.clear();
+    const double max_dist2 = merge_distance*merge_distance;
+    for (std::size_t k = 0; k < per_camera.size(); k++) {
+        // Merged positions up to here hold earlier cameras only
+        const std::size_t earlier = all_xyz->size();
+        for (const auto& xyz : per_camera[k]) {
+            std::size_t best = earlier;
+            double best_dist2 = max_dist2;
+            for (std::size_t m = 0; m < earlier; m++) {
+                if (merged_camera[m] == static_cast<int>(k)) continue;
+                const auto& mean = (*all_xyz)[m];
+                double dx = xyz[0] - mean[0];
+                double dy = xyz[1] - mean[1];
+                double dz = xyz[2] - mean[2];
+                double dist2 = dx*dx + dy*dy + dz*dz;
+                if (dist2 < best_dist2) {
+                    best_dist2 = dist2;
+                    best = m;
+                }
+            }
+            if (best == earlier) {
+                all_xyz->push_back(xyz);
+                merged_count.push_back(1);
+                merged_camera.push_back(static_cast<int>(k));
+                continue;
+            }
+            // Running mean of every camera that saw this person
+            auto& mean = (*all_xyz)[best];
+            double weight = 1.0/++merged_count[best];
+            for (int i = 0; i < 3; i++)
+                mean[i] += weight*(xyz[i] - mean[i]);
+            merged_camera[best] = static_cast<int>(k);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * @file DarknetModel.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Darknet Model definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/DarknetModel.hpp"
+
+DarknetModel::DarknetModel(const std::string& cfg_path,
+        const std::string& weight_path,
+        std::chrono::steady_clock::time_point start) :
+        cfg{read_file(cfg_path)}, weights{weight_path} {
+    load_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<char> DarknetModel::read_file(const std::string& path) {
+    std::ifstream infile(path.c_str(), std::ios::binary);
+    if (!infile)
+        throw InvalidFile("Cannot read model file " + path + ".");
+    return std::vector<char>(std::istreambuf_iterator<char>(infile),
+        std::istreambuf_iterator<char>());
+}
+
+cv::dnn::Net DarknetModel::create_net() const {
+    cv::dnn::Net net = cv::dnn::readNetFromDarknet(cfg.data(), cfg.size(),
+        weights.data(), weights.size());
+
+    // Layers only read their blobs (fusion works on a copy), so pointing
+    // them at the first network's blobs frees this network's parsed copy.
+    std::vector<cv::String> names = net.getLayerNames();
+    std::lock_guard<std::mutex> lock(blobs_mtx);
+    bool first = shared_blobs.empty();
+    if (first) shared_blobs.resize(names.size());
+    for (std::size_t i = 0; i < names.size(); i++) {
+        auto layer = net.getLayer(net.getLayerId(names[i]));
+        if (first)
+            shared_blobs[i] = layer->blobs;
+        else
+            layer->blobs = shared_blobs[i];
+    }
+    return net;
+}
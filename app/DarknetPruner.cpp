@@ -0,0 +1,232 @@
+/**
+ * @file DarknetPruner.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Darknet Pruner definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "../include/utils.hpp"
+#include "../include/DarknetPruner.hpp"
+
+namespace {
+
+std::string trim(const std::string& s) {
+    auto first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    auto last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+
+int to_int(const std::string& value, const std::string& what) {
+    try {
+        return std::stoi(value);
+    } catch (const std::exception&) {
+        throw InvalidFile("Cannot read '" + what + "' from the model cfg.");
+    }
+}
+
+}  // namespace
+
+std::string CfgSection::get(const std::string& key,
+        const std::string& fallback) const {
+    for (const auto& line : lines) {
+        auto eq = line.find('=');
+        if (eq != std::string::npos && trim(line.substr(0, eq)) == key)
+            return trim(line.substr(eq + 1));
+    }
+    return fallback;
+}
+
+void CfgSection::set(const std::string& key, const std::string& value) {
+    for (auto& line : lines) {
+        auto eq = line.find('=');
+        if (eq != std::string::npos && trim(line.substr(0, eq)) == key) {
+            line = key + "=" + value;
+            return;
+        }
+    }
+    lines.push_back(key + "=" + value);
+}
+
+DarknetPruner::DarknetPruner(const std::string& cfg_path,
+        const std::string& weight_path) :
+        sections{read_cfg(cfg_path)}, weights{weight_path} {
+    index_weights();
+}
+
+std::vector<CfgSection> DarknetPruner::read_cfg(const std::string& path) {
+    std::ifstream infile(path.c_str());
+    if (!infile)
+        throw InvalidFile("Cannot read model file " + path + ".");
+
+    std::vector<CfgSection> cfg;
+    std::string line;
+    while (getline(infile, line)) {
+        std::string stripped = trim(line);
+        if (!stripped.empty() && stripped[0] == '[') {
+            cfg.push_back(CfgSection{});
+            cfg.back().type = stripped;
+        } else if (!cfg.empty()) {
+            cfg.back().lines.push_back(line);
+        }
+    }
+    if (cfg.empty() || cfg[0].type != "[net]")
+        throw InvalidFile("Model cfg " + path + " has no [net] section.");
+    return cfg;
+}
+
+void DarknetPruner::index_weights() {
+    if (weights.size() < 3*sizeof(int32_t))
+        throw InvalidFile("Model weights are too short.");
+    int32_t version[3];
+    std::memcpy(version, weights.data(), sizeof(version));
+    // Darknet widened the images-seen counter to 64 bits in version 0.2.
+    bool wide_seen = version[0]*10 + version[1] >= 2 &&
+        version[0] < 1000 && version[1] < 1000;
+    header_bytes = sizeof(version) + (wide_seen ? sizeof(int64_t) :
+        sizeof(int32_t));
+
+    // Output channels of every layer, [net] excluded.
+    std::vector<int> channels;
+    int in_channels = to_int(sections[0].get("channels", "3"), "channels");
+    std::size_t offset = header_bytes;
+    for (std::size_t i = 1; i < sections.size(); i++) {
+        const auto& section = sections[i];
+        int layer = static_cast<int>(channels.size());
+        int out_channels = in_channels;
+
+        if (section.type == "[convolutional]") {
+            int filters = to_int(section.get("filters", "1"), "filters");
+            int size = to_int(section.get("size", "1"), "size");
+            int groups = to_int(section.get("groups", "1"), "groups");
+            ConvBlock conv{i, offset, filters,
+                static_cast<std::size_t>(in_channels/groups)*size*size,
+                section.get("batch_normalize", "0") != "0", 0, 0};
+            offset += sizeof(float)*(static_cast<std::size_t>(filters)*
+                ((conv.batch_normalize ? 4 : 1) + conv.row_floats));
+            convs.push_back(conv);
+            out_channels = filters;
+        } else if (section.type == "[route]") {
+            auto layers = split(section.get("layers", ""), ',');
+            out_channels = 0;
+            for (const auto& value : layers) {
+                if (trim(value).empty()) continue;
+                int idx = to_int(value, "layers");
+                if (idx < 0) idx += layer;
+                if (idx < 0 || idx >= layer)
+                    throw InvalidFile("Route to a missing layer in the"
+                        " model cfg.");
+                out_channels += channels[idx];
+            }
+            out_channels /= to_int(section.get("groups", "1"), "groups");
+        } else if (section.type == "[yolo]") {
+            if (convs.empty() || convs.back().section != i - 1)
+                throw InvalidFile("A [yolo] layer does not follow a"
+                    " [convolutional] in the model cfg.");
+            auto& head = convs.back();
+            head.anchors = static_cast<int>(
+                split(section.get("mask", "0"), ',').size());
+            head.classes = to_int(section.get("classes", "80"), "classes");
+            if (head.filters != head.anchors*(5 + head.classes))
+                throw InvalidFile("YOLO head filters do not match its anchors"
+                    " and classes.");
+        } else if (section.type == "[shortcut]") {
+            if (section.get("weights_type", "none") != "none")
+                throw InvalidFile("Weighted shortcuts are not supported.");
+        } else if (section.type != "[maxpool]" &&
+                section.type != "[upsample]") {
+            throw InvalidFile("Unsupported model layer " + section.type + ".");
+        }
+
+        channels.push_back(out_channels);
+        in_channels = out_channels;
+    }
+
+    if (offset != weights.size())
+        throw InvalidFile("Model weights do not match the cfg: expected " +
+            std::to_string(offset) + " bytes, got " +
+            std::to_string(weights.size()) + ".");
+}
+
+PruneReport DarknetPruner::prune(int keep_class, const std::string& cfg_path,
+        const std::string& weight_path) const {
+    PruneReport report;
+    report.weight_bytes_before = weights.size();
+    for (const auto& conv : convs) {
+        if (!conv.anchors) continue;
+        if (keep_class < 0 || keep_class >= conv.classes)
+            throw std::invalid_argument("Class index " +
+                std::to_string(keep_class) + " is not in the model.");
+        report.heads++;
+        report.head_filters_before += conv.filters;
+        report.head_filters_after += 6*conv.anchors;
+    }
+
+    std::ofstream weight_file(weight_path.c_str(), std::ios::binary);
+    if (!weight_file)
+        throw InvalidFile("Cannot write model file " + weight_path + ".");
+    weight_file.write(weights.data(), header_bytes);
+
+    auto cfg = sections;
+    std::size_t copied = header_bytes;
+    for (const auto& conv : convs) {
+        if (!conv.anchors) continue;
+        weight_file.write(weights.data() + copied, conv.offset - copied);
+
+        // Per anchor: x, y, w, h, objectness, then the kept class.
+        std::vector<int> kept;
+        for (int a = 0; a < conv.anchors; a++) {
+            int first = a*(5 + conv.classes);
+            for (int c = 0; c < 5; c++) kept.push_back(first + c);
+            kept.push_back(first + 5 + keep_class);
+        }
+
+        const char* block = weights.data() + conv.offset;
+        std::size_t per_filter = conv.batch_normalize ? 4 : 1;
+        for (std::size_t array = 0; array < per_filter; array++)
+            for (int filter : kept)
+                weight_file.write(block + sizeof(float)*(
+                    array*conv.filters + filter), sizeof(float));
+        const char* rows = block + sizeof(float)*per_filter*conv.filters;
+        for (int filter : kept)
+            weight_file.write(rows + sizeof(float)*conv.row_floats*filter,
+                sizeof(float)*conv.row_floats);
+
+        copied = conv.offset + sizeof(float)*conv.filters*(per_filter +
+            conv.row_floats);
+        cfg[conv.section].set("filters", std::to_string(kept.size()));
+        cfg[conv.section + 1].set("classes", "1");
+    }
+    weight_file.write(weights.data() + copied, weights.size() - copied);
+    report.weight_bytes_after = static_cast<std::size_t>(weight_file.tellp());
+    if (!weight_file)
+        throw InvalidFile("Cannot write model file " + weight_path + ".");
+
+    std::ofstream cfg_file(cfg_path.c_str());
+    if (!cfg_file)
+        throw InvalidFile("Cannot write model file " + cfg_path + ".");
+    for (const auto& section : cfg) {
+        cfg_file << section.type << "\n";
+        for (const auto& line : section.lines) cfg_file << line << "\n";
+    }
+    return report;
+}
+
+std::size_t DarknetPruner::get_head_count() const {
+    std::size_t heads = 0;
+    for (const auto& conv : convs)
+        if (conv.anchors) heads++;
+    return heads;
+}
@@ -14,14 +14,6 @@
 
 #include "../include/Detection.hpp"
 
-Detection& Detection::operator=(const Detection& detect) {
-    this->x = detect.x;
-    this->y = detect.y;
-    this->width = detect.width;
-    this->height = detect.height;
-    return *this;
-}
-
 Detection Detection::operator+(const Detection& detect) const {
     Detection res;
     res.x = this->x + detect.x;
@@ -0,0 +1,76 @@
+/**
+ * @file DetectionBatch.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection Batch definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "../include/DetectionBatch.hpp"
+
+DetectionBatch::DetectionBatch(const std::vector<Detection>& detections,
+        int frame_id) {
+    append(detections, frame_id);
+}
+
+void DetectionBatch::clear() {
+    x_.clear();
+    y_.clear();
+    width_.clear();
+    height_.clear();
+    confidence_.clear();
+    class_id_.clear();
+    frame_id_.clear();
+}
+
+void DetectionBatch::reserve(std::size_t n) {
+    x_.reserve(n);
+    y_.reserve(n);
+    width_.reserve(n);
+    height_.reserve(n);
+    confidence_.reserve(n);
+    class_id_.reserve(n);
+    frame_id_.reserve(n);
+}
+
+void DetectionBatch::push_back(float x, float y, float width, float height,
+        float confidence, int class_id, int frame_id) {
+    x_.push_back(x);
+    y_.push_back(y);
+    width_.push_back(width);
+    height_.push_back(height);
+    confidence_.push_back(confidence);
+    class_id_.push_back(class_id);
+    frame_id_.push_back(frame_id);
+}
+
+void DetectionBatch::append(const std::vector<Detection>& detections,
+        int frame_id) {
+    reserve(size() + detections.size());
+    for (const auto& detection : detections)
+        push_back(static_cast<float>(detection.x),
+            static_cast<float>(detection.y),
+            static_cast<float>(detection.width),
+            static_cast<float>(detection.height), detection.confidence, 0,
+            frame_id);
+}
+
+Detection DetectionBatch::get(std::size_t i) const {
+    return Detection(static_cast<int>(std::lround(x_[i])),
+        static_cast<int>(std::lround(y_[i])),
+        static_cast<int>(std::lround(width_[i])),
+        static_cast<int>(std::lround(height_[i])), confidence_[i]);
+}
+
+void DetectionBatch::to_detections(std::vector<Detection>* detections)
+        const {
+    detections->resize(size());
+    for (std::size_t i = 0; i < size(); i++) (*detections)[i] = get(i);
+}
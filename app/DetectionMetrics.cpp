@@ -0,0 +1,83 @@
+/**
+ * @file DetectionMetrics.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection accuracy metrics definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <vector>
+#include <memory>
+
+#include "../include/DetectionMetrics.hpp"
+
+Detection get_closest_diff(const Detection& detection,
+        const std::vector<Detection>& all_true) {
+    int min_sum = 5000;
+    Detection closest_diff{};
+    for (const auto& single_true : all_true) {
+        Detection diff = detection - single_true;
+        int sum = diff.x + diff.y + diff.width + diff.height;
+        if (sum < min_sum) {
+            min_sum = sum;
+            closest_diff = diff;
+        }
+    }
+    return closest_diff;
+}
+
+Detection get_closest_diff(const Detection& detection,
+        const DetectionBatch& all_true) {
+    int min_sum = 5000;
+    Detection closest_diff{};
+    for (std::size_t i = 0; i < all_true.size(); i++) {
+        Detection diff = detection - all_true.get(i);
+        int sum = diff.x + diff.y + diff.width + diff.height;
+        if (sum < min_sum) {
+            min_sum = sum;
+            closest_diff = diff;
+        }
+    }
+    return closest_diff;
+}
+
+AccuracyReport evaluate_accuracy(HumanDetector* detector,
+        const std::vector<std::shared_ptr<TestImage> >& labels,
+        std::size_t max_imgs) {
+    AccuracyReport report;
+    int num_true_detections = 0;
+    int num_detected_detections = 0;
+    Detection sum_detect_diff{};
+    double detect_ms = 0;
+
+    for (const auto& label : labels) {
+        if (static_cast<std::size_t>(report.num_imgs) >= max_imgs) break;
+        auto prep_img = detector->prep_frame(label->img);
+        auto start = std::chrono::steady_clock::now();
+        auto output_detections = detector->detect(*prep_img);
+        detect_ms += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        num_true_detections += label->all_detections.size();
+        num_detected_detections += output_detections->size();
+        for (const auto& output_detection : *output_detections)
+            sum_detect_diff += get_closest_diff(output_detection,
+                label->all_detections);
+        report.num_imgs++;
+    }
+    if (num_true_detections == 0) return report;
+
+    double num_true = static_cast<double>(num_true_detections);
+    report.percent_detected = num_detected_detections/num_true;
+    report.average_x_diff = sum_detect_diff.x/num_true;
+    report.average_y_diff = sum_detect_diff.y/num_true;
+    report.average_width_diff = sum_detect_diff.width/num_true;
+    report.average_height_diff = sum_detect_diff.height/num_true;
+    report.ms_per_frame = detect_ms/report.num_imgs;
+    return report;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file DetectionTracker.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection Tracker definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/Detection.hpp"
+#include "../include/DetectionTracker.hpp"
+
+namespace {
+
+/**
+ * @brief Process noise of the position and velocity UNIT: [px^2]
+ * 
+ */
+const float position_noise = 1.0f;
+const float velocity_noise = 0.5f;
+
+/**
+ * @brief Measurement noise of the median flow center UNIT: [px^2]
+ * 
+ */
+const float measurement_noise = 2.0f;
+
+/**
+ * @brief Largest forward-backward round trip error of a reliable point UNIT: [px]
+ * 
+ */
+const float max_round_trip = 1.0f;
+
+float median(std::vector<float>* values) {
+    auto mid = values->begin() + values->size()/2;
+    std::nth_element(values->begin(), mid, values->end());
+    return *mid;
+}
+
+}  // namespace
+
+const int DetectionTracker::grid_size;
+
+void DetectionTracker::AxisFilter::predict() {
+    pos += vel;
+    p00 += 2*p01 + p11 + position_noise;
+    p01 += p11;
+    p11 += velocity_noise;
+}
+
+void DetectionTracker::AxisFilter::update(float measured) {
+    float s = p00 + measurement_noise;
+    float k0 = p00/s;
+    float k1 = p01/s;
+    float residual = measured - pos;
+    pos += k0*residual;
+    vel += k1*residual;
+    p11 -= k1*p01;
+    p01 -= k0*p01;
+    p00 -= k0*p00;
+}
+
+DetectionTracker::DetectionTracker(int _max_interval,
+        double _min_confidence) :
+        max_interval{_max_interval}, min_confidence{_min_confidence} {
+    if (max_interval < 1)
+        throw std::invalid_argument("Keyframe interval must be at least 1.");
+    if (min_confidence < 0 || min_confidence > 1)
+        throw std::invalid_argument("Tracking confidence must be in [0, 1].");
+}
+
+DetectionTracker::DetectionTracker(
+        const std::unordered_map<std::string, double>& robot_params) :
+        DetectionTracker(static_cast<int>(get_param(robot_params,
+            "TRACK_MAX_KEYFRAME_INTERVAL", 8)),
+            get_param(robot_params, "TRACK_MIN_CONFIDENCE", 0.5)) {}
+
+void DetectionTracker::add_grid_points(const Track& track) {
+    // Stay off the box border, which is mostly background.
+    float step_x = 0.8f*track.width/(grid_size - 1);
+    float step_y = 0.8f*track.height/(grid_size - 1);
+    float left = track.flow_x - 0.4f*track.width;
+    float top = track.flow_y - 0.4f*track.height;
+    for (int i = 0; i < grid_size; i++)
+        for (int j = 0; j < grid_size; j++)
+            prev_points.emplace_back(left + j*step_x, top + i*step_y);
+}
+
+void DetectionTracker::reset(const cv::Mat& gray,
+        const std::vector<Detection>& detections) {
+    gray.copyTo(prev_gray);
+    tracks.clear();
+    for (const auto& detection : detections) {
+        Track track;
+        track.cx.pos = track.flow_x = detection.x + 0.5f*detection.width;
+        track.cy.pos = track.flow_y = detection.y + 0.5f*detection.height;
+        track.width = static_cast<float>(detection.width);
+        track.height = static_cast<float>(detection.height);
+        track.score = detection.confidence;
+        tracks.push_back(track);
+    }
+
+    if (failed) {
+        interval = 1;
+    } else if (span_confidence >= 0.5*(1 + min_confidence)) {
+        interval = std::min(interval + 1, max_interval);
+    } else {
+        interval = std::max(1, interval/2);
+    }
+    frames_since_keyframe = 0;
+    failed = false;
+    confidence = 1;
+    span_confidence = 1;
+}
+
+bool DetectionTracker::track(const cv::Mat& gray,
+        std::vector<Detection>* detections) {
+    detections->clear();
+    frames_since_keyframe++;
+    if (prev_gray.empty() || gray.size() != prev_gray.size()) {
+        failed = true;
+        return false;
+    }
+
+    prev_points.clear();
+    for (const auto& track : tracks) add_grid_points(track);
+
+    double frame_confidence = 1;
+    if (!prev_points.empty()) {
+        cv::calcOpticalFlowPyrLK(prev_gray, gray, prev_points, next_points,
+            status, errors, cv::Size(15, 15), 2);
+        cv::calcOpticalFlowPyrLK(gray, prev_gray, next_points, back_points,
+            back_status, errors, cv::Size(15, 15), 2);
+    }
+
+    const int points_per_track = grid_size*grid_size;
+    std::vector<int> good;
+    std::vector<float> dx, dy, ratios;
+    for (std::size_t t = 0; t < tracks.size(); t++) {
+        good.clear();
+        dx.clear();
+        dy.clear();
+        for (int k = 0; k < points_per_track; k++) {
+            int i = static_cast<int>(t)*points_per_track + k;
+            if (!status[i] || !back_status[i]) continue;
+            float fb_x = back_points[i].x - prev_points[i].x;
+            float fb_y = back_points[i].y - prev_points[i].y;
+            if (fb_x*fb_x + fb_y*fb_y > max_round_trip*max_round_trip)
+                continue;
+            good.push_back(i);
+            dx.push_back(next_points[i].x - prev_points[i].x);
+            dy.push_back(next_points[i].y - prev_points[i].y);
+        }
+
+        double track_confidence = good.size()/
+            static_cast<double>(points_per_track);
+        frame_confidence = std::min(frame_confidence, track_confidence);
+        if (good.size() < 2) continue;
+
+        ratios.clear();
+        for (std::size_t a = 0; a < good.size(); a++) {
+            for (std::size_t b = a + 1; b < good.size(); b++) {
+                const auto& p0 = prev_points[good[a]];
+                const auto& p1 = prev_points[good[b]];
+                const auto& n0 = next_points[good[a]];
+                const auto& n1 = next_points[good[b]];
+                float before = std::hypot(p1.x - p0.x, p1.y - p0.y);
+                float after = std::hypot(n1.x - n0.x, n1.y - n0.y);
+                if (before > 0) ratios.push_back(after/before);
+            }
+        }
+        float scale = ratios.empty() ? 1.0f : median(&ratios);
+
+        Track& track = tracks[t];
+        track.flow_x += median(&dx);
+        track.flow_y += median(&dy);
+        track.cx.predict();
+        track.cy.predict();
+        track.cx.update(track.flow_x);
+        track.cy.update(track.flow_y);
+        track.width *= scale;
+        track.height *= scale;
+    }
+
+    confidence = frame_confidence;
+    span_confidence = std::min(span_confidence, confidence);
+    if (confidence < min_confidence) {
+        failed = true;
+        return false;
+    }
+
+    for (const auto& track : tracks)
+        detections->push_back({
+            static_cast<int>(std::lround(track.cx.pos - 0.5f*track.width)),
+            static_cast<int>(std::lround(track.cy.pos - 0.5f*track.height)),
+            static_cast<int>(std::lround(track.width)),
+            static_cast<int>(std::lround(track.height)), track.score});
+    gray.copyTo(prev_gray);
+    return true;
+}
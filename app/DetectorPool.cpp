@@ -0,0 +1,49 @@
+/**
+ * @file DetectorPool.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detector Pool definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/DetectorPool.hpp"
+
+std::vector<std::unique_ptr<HumanDetector> > DetectorPool::make_detectors(
+        const std::unordered_map<std::string, double>& robot_params,
+        const std::string& coco_name_path, const DarknetModel& model,
+        std::size_t num_instances) {
+    if (num_instances == 0)
+        throw std::invalid_argument("DetectorPool needs at least one instance");
+    std::vector<std::unique_ptr<HumanDetector> > detectors;
+    for (std::size_t i = 0; i < num_instances; i++)
+        detectors.emplace_back(new HumanDetector(robot_params,
+            coco_name_path, model));
+    return detectors;
+}
+
+DetectorPool::DetectorPool(
+        const std::unordered_map<std::string, double>& robot_params,
+        const std::string& coco_name_path, const std::string& yolo_cfg_path,
+        const std::string& yolo_weight_path, std::size_t num_instances) :
+        pool{make_detectors(robot_params, coco_name_path,
+            *WeightStore::get(yolo_cfg_path, yolo_weight_path),
+            num_instances)} {}
+
+void DetectorPool::set_stage_timers(StageTimers* timers) {
+    std::vector<Lease> leases;
+    for (std::size_t i = 0; i < pool.size(); i++) {
+        leases.push_back(pool.acquire());
+        leases.back()->set_stage_timers(timers);
+    }
+}
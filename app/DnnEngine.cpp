@@ -0,0 +1,72 @@
+/**
+ * @file DnnEngine.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief OpenCV DNN inference engines definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/DnnEngine.hpp"
+
+DnnEngine::DnnEngine(cv::dnn::Net _net, int backend, int target,
+        const std::string& format) : net{_net} {
+    auto targets = cv::dnn::getAvailableTargets(
+        static_cast<cv::dnn::Backend>(backend));
+    if (std::find(targets.begin(), targets.end(),
+            static_cast<cv::dnn::Target>(target)) == targets.end())
+        throw std::invalid_argument("DNN backend " + std::to_string(backend)
+            + " cannot run on target " + std::to_string(target) + ".");
+
+    net.setPreferableBackend(backend);
+    net.setPreferableTarget(target);
+    output_names = net.getUnconnectedOutLayersNames();
+
+    name = format + " (backend " + std::to_string(backend) + ", target " +
+        std::to_string(target) + ")";
+}
+
+void DnnEngine::set_input(const cv::Mat& blob) {
+    net.setInput(blob);
+}
+
+void DnnEngine::forward(std::vector<cv::Mat>* outputs) {
+    net.forward(*outputs, output_names);
+    // Darknet region layers are already 2D. ONNX exports usually keep a
+    // leading batch dimension, which is folded into the rows.
+    for (auto& output : *outputs) {
+        if (output.dims <= 2) continue;
+        int cols = output.size[output.dims - 1];
+        output = output.reshape(1, static_cast<int>(output.total() / cols));
+    }
+}
+
+int DnnEngine::get_backend(
+        const std::unordered_map<std::string, double>& robot_params) {
+    return static_cast<int>(get_param(robot_params, "DNN_BACKEND",
+        cv::dnn::DNN_BACKEND_DEFAULT));
+}
+
+int DnnEngine::get_target(
+        const std::unordered_map<std::string, double>& robot_params) {
+    return static_cast<int>(get_param(robot_params, "DNN_TARGET",
+        cv::dnn::DNN_TARGET_CPU));
+}
+
+cv::dnn::Net OnnxEngine::read_net(const std::string& model_path) {
+    if (!std::ifstream(model_path.c_str()))
+        throw InvalidFile("Cannot read model file " + model_path + ".");
+    return cv::dnn::readNetFromONNX(model_path);
+}
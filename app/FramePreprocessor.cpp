@@ -0,0 +1,225 @@
+/**
+ * @file FramePreprocessor.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame Preprocessor definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "../include/FramePreprocessor.hpp"
+
+namespace {
+
+/**
+ * @brief Bilinear source index and weight for one destination coordinate, following cv::resize INTER_LINEAR.
+ * 
+ * @param dst_idx destination coordinate
+ * @param scale source/destination size ratio
+ * @param src_len source length
+ * @param idx0 output: first source sample
+ * @param idx1 output: second source sample
+ * @param weight output: weight of the second sample
+ */
+void linear_coeffs(int dst_idx, double scale, int src_len, int* idx0,
+        int* idx1, float* weight) {
+    double src = (dst_idx + 0.5)*scale - 0.5;
+    int i0 = static_cast<int>(std::floor(src));
+    float w = static_cast<float>(src - i0);
+    if (i0 < 0) {
+        i0 = 0;
+        w = 0.f;
+    }
+    if (i0 >= src_len - 1) {
+        i0 = src_len - 1;
+        w = 0.f;
+    }
+    *idx0 = i0;
+    *idx1 = std::min(i0 + 1, src_len - 1);
+    *weight = w;
+}
+
+/**
+ * @brief out[i] = row0[i]*w0 + row1[i]*w1 over n bytes, converted to float.
+ * 
+ */
+void vertical_blend(const uint8_t* row0, const uint8_t* row1, float w0,
+        float w1, float* out, int n) {
+    int i = 0;
+#if defined(__AVX2__)
+    const __m256 vw0 = _mm256_set1_ps(w0);
+    const __m256 vw1 = _mm256_set1_ps(w1);
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(row0 + i))));
+        __m256 b = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(
+            reinterpret_cast<const __m128i*>(row1 + i))));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(a, vw0),
+            _mm256_mul_ps(b, vw1)));
+    }
+#elif defined(__SSE2__)
+    const __m128 vw0 = _mm_set1_ps(w0);
+    const __m128 vw1 = _mm_set1_ps(w1);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i a8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+            row0 + i));
+        __m128i b8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+            row1 + i));
+        __m128i a16[2] = {_mm_unpacklo_epi8(a8, zero),
+            _mm_unpackhi_epi8(a8, zero)};
+        __m128i b16[2] = {_mm_unpacklo_epi8(b8, zero),
+            _mm_unpackhi_epi8(b8, zero)};
+        for (int half = 0; half < 2; half++) {
+            __m128 a_lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(a16[half], zero));
+            __m128 a_hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(a16[half], zero));
+            __m128 b_lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(b16[half], zero));
+            __m128 b_hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(b16[half], zero));
+            _mm_storeu_ps(out + i + 8*half, _mm_add_ps(_mm_mul_ps(a_lo, vw0),
+                _mm_mul_ps(b_lo, vw1)));
+            _mm_storeu_ps(out + i + 8*half + 4, _mm_add_ps(
+                _mm_mul_ps(a_hi, vw0), _mm_mul_ps(b_hi, vw1)));
+        }
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t vw0 = vdupq_n_f32(w0);
+    const float32x4_t vw1 = vdupq_n_f32(w1);
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t a16 = vmovl_u8(vld1_u8(row0 + i));
+        uint16x8_t b16 = vmovl_u8(vld1_u8(row1 + i));
+        float32x4_t a_lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(a16)));
+        float32x4_t a_hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(a16)));
+        float32x4_t b_lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(b16)));
+        float32x4_t b_hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(b16)));
+        vst1q_f32(out + i, vmlaq_f32(vmulq_f32(a_lo, vw0), b_lo, vw1));
+        vst1q_f32(out + i + 4, vmlaq_f32(vmulq_f32(a_hi, vw0), b_hi, vw1));
+    }
+#endif
+    for (; i < n; i++)
+        out[i] = row0[i]*w0 + row1[i]*w1;
+}
+
+}  // namespace
+
+void FramePreprocessor::build_tables(int width, int height) {
+    src_w = width;
+    src_h = height;
+
+    content_w = dst_w;
+    content_h = dst_h;
+    if (letterbox) {
+        double scale = std::min(dst_w/static_cast<double>(width),
+            dst_h/static_cast<double>(height));
+        content_w = std::max(1, static_cast<int>(std::round(width*scale)));
+        content_h = std::max(1, static_cast<int>(std::round(height*scale)));
+    }
+    pad_x = (dst_w - content_w)/2;
+    pad_y = (dst_h - content_h)/2;
+
+    mapping.offset = {{pad_x/static_cast<float>(dst_w),
+        pad_y/static_cast<float>(dst_h)}};
+    mapping.gain = {{dst_w/static_cast<float>(content_w),
+        dst_h/static_cast<float>(content_h)}};
+
+    double scale_x = width/static_cast<double>(content_w);
+    x_ofs0.resize(content_w);
+    x_ofs1.resize(content_w);
+    x_wts.resize(content_w);
+    for (int dx = 0; dx < content_w; dx++) {
+        int x0, x1;
+        linear_coeffs(dx, scale_x, width, &x0, &x1, &x_wts[dx]);
+        x_ofs0[dx] = 3*x0;
+        x_ofs1[dx] = 3*x1;
+    }
+
+    double scale_y = height/static_cast<double>(content_h);
+    y_idx0.resize(content_h);
+    y_idx1.resize(content_h);
+    y_wts.resize(content_h);
+    for (int dy = 0; dy < content_h; dy++)
+        linear_coeffs(dy, scale_y, height, &y_idx0[dy], &y_idx1[dy],
+            &y_wts[dy]);
+
+    vertical_row.resize(3*static_cast<std::size_t>(width));
+}
+
+void FramePreprocessor::fill_padding(float* dst) const {
+    if (content_w == dst_w && content_h == dst_h) return;
+    const std::size_t plane = static_cast<std::size_t>(dst_w)*dst_h;
+    for (int c = 0; c < 3; c++) {
+        float* p = dst + c*plane;
+        for (int y = 0; y < dst_h; y++) {
+            float* row = p + static_cast<std::size_t>(y)*dst_w;
+            if (y < pad_y || y >= pad_y + content_h) {
+                std::fill(row, row + dst_w, pad_value);
+            } else {
+                std::fill(row, row + pad_x, pad_value);
+                std::fill(row + pad_x + content_w, row + dst_w, pad_value);
+            }
+        }
+    }
+}
+
+void FramePreprocessor::run(const uint8_t* bgr, int width, int height,
+        std::size_t step, float* dst) {
+    if (width != src_w || height != src_h)
+        build_tables(width, height);
+    fill_padding(dst);
+
+    const float norm = 1.f/255.f;
+    const std::size_t plane = static_cast<std::size_t>(dst_w)*dst_h;
+    float* const vrow = vertical_row.data();
+
+    for (int dy = 0; dy < content_h; dy++) {
+        float wy = y_wts[dy];
+        vertical_blend(bgr + y_idx0[dy]*step, bgr + y_idx1[dy]*step,
+            (1.f - wy)*norm, wy*norm, vrow, 3*width);
+
+        std::size_t row_start = static_cast<std::size_t>(pad_y + dy)*dst_w +
+            pad_x;
+        // Swap BGR -> RGB while splitting into planes.
+        float* out_r = dst + row_start;
+        float* out_g = dst + plane + row_start;
+        float* out_b = dst + 2*plane + row_start;
+
+        int dx = 0;
+#if defined(__AVX2__)
+        for (; dx + 8 <= content_w; dx += 8) {
+            __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                x_ofs0.data() + dx));
+            __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                x_ofs1.data() + dx));
+            __m256 wx = _mm256_loadu_ps(x_wts.data() + dx);
+            float* outs[3] = {out_b, out_g, out_r};
+            for (int c = 0; c < 3; c++) {
+                __m256 v0 = _mm256_i32gather_ps(vrow + c, i0, 4);
+                __m256 v1 = _mm256_i32gather_ps(vrow + c, i1, 4);
+                _mm256_storeu_ps(outs[c] + dx, _mm256_add_ps(v0,
+                    _mm256_mul_ps(wx, _mm256_sub_ps(v1, v0))));
+            }
+        }
+#endif
+        for (; dx < content_w; dx++) {
+            const float* p0 = vrow + x_ofs0[dx];
+            const float* p1 = vrow + x_ofs1[dx];
+            float wx = x_wts[dx];
+            out_b[dx] = p0[0] + wx*(p1[0] - p0[0]);
+            out_g[dx] = p0[1] + wx*(p1[1] - p0[1]);
+            out_r[dx] = p0[2] + wx*(p1[2] - p0[2]);
+        }
+    }
+}
@@ -0,0 +1,229 @@
+/**
+ * @file FrameSource.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame Source definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <ctype.h>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/FrameSource.hpp"
+
+namespace {
+
+/**
+ * @brief Compares file names with their digit runs as numbers, so 1_2.png comes before 1_10.png
+ * 
+ */
+bool natural_less(const std::string& a, const std::string& b) {
+    std::size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (isdigit(a[i]) && isdigit(b[j])) {
+            std::size_t end_a = i, end_b = j;
+            while (end_a < a.size() && isdigit(a[end_a])) end_a++;
+            while (end_b < b.size() && isdigit(b[end_b])) end_b++;
+            // Skip leading zeros, then the longer run is the larger number
+            while (i + 1 < end_a && a[i] == '0') i++;
+            while (j + 1 < end_b && b[j] == '0') j++;
+            if (end_a - i != end_b - j) return end_a - i < end_b - j;
+            int order = a.compare(i, end_a - i, b, j, end_b - j);
+            if (order != 0) return order < 0;
+            i = end_a;
+            j = end_b;
+        } else {
+            if (a[i] != b[j]) return a[i] < b[j];
+            i++;
+            j++;
+        }
+    }
+    return a.size() - i < b.size() - j;
+}
+
+bool is_image(const boost::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp";
+}
+
+}  // namespace
+
+FrameSource::FrameSource(Decoder _decode, bool _live, std::size_t capacity) :
+        decode{std::move(_decode)}, live{_live},
+        ring(capacity > 0 ? capacity : 1),
+        start_time{std::chrono::steady_clock::now()} {
+    worker = std::thread(&FrameSource::decode_loop, this);
+}
+
+FrameSource::~FrameSource() {
+    close();
+    if (worker.joinable()) worker.join();
+}
+
+void FrameSource::decode_loop() {
+    cv::Mat spare;
+    double timestamp = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            not_full.wait(lock, [this]() {
+                return closed || live || unread < ring.size(); });
+            if (closed) break;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool decoded = false;
+        try {
+            decoded = decode(&spare, &timestamp);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mtx);
+            worker_error = std::current_exception();
+        }
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!decoded || closed) break;
+        if (unread == ring.size()) {
+            // Only a live source gets here: the oldest frame is stale
+            head = (head + 1) % ring.size();
+            unread--;
+            stats.dropped++;
+        }
+        // The slot's old buffer becomes the next one decoded into
+        Slot& slot = ring[(head + unread) % ring.size()];
+        cv::swap(slot.image, spare);
+        slot.timestamp = timestamp;
+        slot.arrival = start;
+        unread++;
+        stats.decoded++;
+        stats.decode_ms += ms;
+        not_empty.notify_one();
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    finished = true;
+    not_empty.notify_all();
+}
+
+bool FrameSource::read(cv::Mat* frame, double* timestamp,
+        std::chrono::steady_clock::time_point* arrival) {
+    std::unique_lock<std::mutex> lock(mtx);
+    not_empty.wait(lock, [this]() { return finished || unread > 0; });
+    if (unread == 0) {
+        if (worker_error) std::rethrow_exception(worker_error);
+        return false;
+    }
+    Slot& slot = ring[head];
+    cv::swap(*frame, slot.image);
+    *timestamp = slot.timestamp;
+    if (arrival) *arrival = slot.arrival;
+    head = (head + 1) % ring.size();
+    unread--;
+    stats.delivered++;
+    not_full.notify_one();
+    return true;
+}
+
+void FrameSource::close() {
+    std::lock_guard<std::mutex> lock(mtx);
+    closed = true;
+    not_full.notify_all();
+}
+
+FrameSourceStats FrameSource::get_stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    FrameSourceStats ret = stats;
+    if (stats.decode_ms > 0)
+        ret.decode_fps = 1000*stats.decoded/stats.decode_ms;
+    double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    if (elapsed > 0) ret.throughput_fps = stats.delivered/elapsed;
+    return ret;
+}
+
+std::unique_ptr<FrameSource> FrameSource::directory(const std::string& path,
+        double fps, std::size_t capacity) {
+    if (fps <= 0)
+        throw std::invalid_argument("A directory source needs a positive "
+            "frame rate.");
+    if (!boost::filesystem::is_directory(path))
+        throw InvalidFile("Cannot find image directory " + path + ".");
+    auto files = std::make_shared<std::vector<std::string> >();
+    for (const auto& entry : boost::filesystem::directory_iterator(path)) {
+        if (is_image(entry.path()))
+            files->push_back(entry.path().filename().string());
+    }
+    std::sort(files->begin(), files->end(), natural_less);
+    for (auto& file : *files)
+        file = (boost::filesystem::path(path) / file).string();
+
+    // The file is read into a reused buffer and decoded in place, so
+    // neither the bytes nor the pixels are reallocated frame to frame
+    auto bytes = std::make_shared<std::vector<uchar> >();
+    auto next = std::make_shared<std::size_t>(0);
+    Decoder decode = [files, bytes, next, fps](cv::Mat* image,
+            double* timestamp) {
+        if (*next == files->size()) return false;
+        const std::string& file = (*files)[*next];
+        std::ifstream in(file.c_str(), std::ios::binary | std::ios::ate);
+        if (!in) throw InvalidFile("Cannot read image " + file + ".");
+        bytes->resize(static_cast<std::size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(bytes->data()), bytes->size());
+        cv::imdecode(*bytes, cv::IMREAD_COLOR, image);
+        if (image->empty())
+            throw InvalidFile("Cannot decode image " + file + ".");
+        *timestamp = *next/fps;
+        ++*next;
+        return true;
+    };
+    return std::unique_ptr<FrameSource>(
+        new FrameSource(std::move(decode), false, capacity));
+}
+
+std::unique_ptr<FrameSource> FrameSource::video(const std::string& path,
+        std::size_t capacity) {
+    auto capture = std::make_shared<cv::VideoCapture>(path);
+    if (!capture->isOpened())
+        throw InvalidFile("Cannot open video " + path + ".");
+    Decoder decode = [capture](cv::Mat* image, double* timestamp) {
+        if (!capture->read(*image) || image->empty()) return false;
+        *timestamp = capture->get(cv::CAP_PROP_POS_MSEC)/1000;
+        return true;
+    };
+    return std::unique_ptr<FrameSource>(
+        new FrameSource(std::move(decode), false, capacity));
+}
+
+std::unique_ptr<FrameSource> FrameSource::camera(int device,
+        std::size_t capacity) {
+    auto capture = std::make_shared<cv::VideoCapture>(device);
+    if (!capture->isOpened())
+        throw InvalidFile("Cannot open camera " + std::to_string(device) +
+            ".");
+    Decoder decode = [capture](cv::Mat* image, double* timestamp) {
+        if (!capture->grab()) return false;
+        *timestamp = std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        return capture->retrieve(*image) && !image->empty();
+    };
+    return std::unique_ptr<FrameSource>(
+        new FrameSource(std::move(decode), true, capacity));
+}
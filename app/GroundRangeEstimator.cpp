@@ -0,0 +1,145 @@
+/**
+ * @file GroundRangeEstimator.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Ground-plane range estimator definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <eigen3/Eigen/Dense>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "../include/utils.hpp"
+#include "../include/GroundRangeEstimator.hpp"
+
+GroundRangeEstimator::GroundRangeEstimator(
+        const Eigen::Matrix<double, 4, 4>& cam2robot, double _focal_px,
+        double center_y, int _img_h, double _cam_height,
+        double _height_rel_stddev, double foot_stddev_px) :
+        cam_height{_cam_height}, focal_px{_focal_px}, img_h{_img_h},
+        height_rel_stddev{_height_rel_stddev} {
+    if (img_h <= 0 || focal_px <= 0 || cam_height <= 0 ||
+            foot_stddev_px <= 0)
+        throw std::invalid_argument("Ground range needs a positive frame "
+            "height, focal length, camera height and foot deviation.");
+    // Downward (robot y) component of a camera ray is vertical.dot(ray)
+    vertical = {{cam2robot(1, 0), cam2robot(1, 1), cam2robot(1, 2)}};
+
+    // descent/cam_height with the row's ray y = (v - center_y)/focal_px
+    row_slope = vertical[1]/(focal_px*cam_height);
+    row_offset = (vertical[2] - vertical[1]*center_y/focal_px)/cam_height;
+    double foot_inv_stddev = foot_stddev_px*row_slope;
+    ground_inv_var = foot_inv_stddev*foot_inv_stddev;
+}
+
+GroundRangeEstimator::GroundRangeEstimator(
+        const Eigen::Matrix<double, 4, 4>& cam2robot, double _focal_px,
+        double center_y, int _img_h,
+        const std::unordered_map<std::string, double>& robot_params) :
+        GroundRangeEstimator(cam2robot, _focal_px, center_y, _img_h,
+            robot_params.at("CAM_HEIGHT"),
+            get_param(robot_params, "HUMAN_HEIGHT_STDDEV", 0.15)/
+                robot_params.at("AVG_HUMAN_HEIGHT"),
+            get_param(robot_params, "FOOT_PIXEL_STDDEV", 2)) {}
+
+void GroundRangeEstimator::fuse_heights(const float* top, const float* height,
+        std::size_t n, float scale, float* fused_top,
+        float* fused_height) const {
+    const float inv_scale = 1.f/scale;
+    std::size_t i = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    const __m256 slope = _mm256_set1_ps(static_cast<float>(row_slope));
+    const __m256 offset = _mm256_set1_ps(static_cast<float>(row_offset));
+    const __m256 rel_sd = _mm256_set1_ps(static_cast<float>(
+        height_rel_stddev));
+    const __m256 ground_var = _mm256_set1_ps(static_cast<float>(
+        ground_inv_var));
+    const __m256 max_bottom = _mm256_set1_ps(static_cast<float>(img_h - 1));
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 half = _mm256_set1_ps(.5f);
+    for (; i + 8 <= n; i += 8) {
+        __m256 t = _mm256_loadu_ps(top + i);
+        __m256 h = _mm256_loadu_ps(height + i);
+        __m256 bottom = _mm256_add_ps(t, h);
+        __m256 ground_inv = _mm256_max_ps(zero,
+            _mm256_fmadd_ps(slope, bottom, offset));
+        __m256 height_inv = _mm256_mul_ps(h, _mm256_set1_ps(inv_scale));
+
+        __m256 use_ground = _mm256_and_ps(
+            _mm256_cmp_ps(ground_inv, zero, _CMP_GT_OQ),
+            _mm256_cmp_ps(bottom, max_bottom, _CMP_LT_OQ));
+        __m256 head_visible = _mm256_cmp_ps(t, one, _CMP_GT_OQ);
+
+        __m256 height_var = _mm256_mul_ps(rel_sd, height_inv);
+        height_var = _mm256_mul_ps(height_var, height_var);
+        __m256 fused = _mm256_div_ps(
+            _mm256_fmadd_ps(height_inv, ground_var,
+                _mm256_mul_ps(ground_inv, height_var)),
+            _mm256_add_ps(height_var, ground_var));
+        fused = _mm256_blendv_ps(ground_inv, fused, head_visible);
+        fused = _mm256_blendv_ps(height_inv, fused, use_ground);
+
+        __m256 h_out = _mm256_mul_ps(_mm256_set1_ps(scale), fused);
+        _mm256_storeu_ps(fused_height + i, h_out);
+        _mm256_storeu_ps(fused_top + i, _mm256_fmadd_ps(half,
+            _mm256_sub_ps(h, h_out), t));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t slope = vdupq_n_f32(static_cast<float>(row_slope));
+    const float32x4_t offset = vdupq_n_f32(static_cast<float>(row_offset));
+    const float rel_sd = static_cast<float>(height_rel_stddev);
+    const float32x4_t ground_var = vdupq_n_f32(static_cast<float>(
+        ground_inv_var));
+    const float32x4_t max_bottom = vdupq_n_f32(static_cast<float>(img_h - 1));
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t t = vld1q_f32(top + i);
+        float32x4_t h = vld1q_f32(height + i);
+        float32x4_t bottom = vaddq_f32(t, h);
+        float32x4_t ground_inv = vmaxq_f32(zero,
+            vfmaq_f32(offset, slope, bottom));
+        float32x4_t height_inv = vmulq_n_f32(h, inv_scale);
+
+        uint32x4_t use_ground = vandq_u32(vcgtq_f32(ground_inv, zero),
+            vcltq_f32(bottom, max_bottom));
+        uint32x4_t head_visible = vcgtq_f32(t, vdupq_n_f32(1.f));
+
+        float32x4_t height_var = vmulq_n_f32(height_inv, rel_sd);
+        height_var = vmulq_f32(height_var, height_var);
+        float32x4_t fused = vdivq_f32(
+            vfmaq_f32(vmulq_f32(ground_inv, height_var), height_inv,
+                ground_var),
+            vaddq_f32(height_var, ground_var));
+        fused = vbslq_f32(head_visible, fused, ground_inv);
+        fused = vbslq_f32(use_ground, fused, height_inv);
+
+        float32x4_t h_out = vmulq_n_f32(fused, scale);
+        vst1q_f32(fused_height + i, h_out);
+        vst1q_f32(fused_top + i, vfmaq_n_f32(t, vsubq_f32(h, h_out), .5f));
+    }
+#endif
+    for (; i < n; i++) {
+        float bottom = top[i] + height[i];
+        double fused = fuse_inverse(height[i]*inv_scale,
+            inverse_range(bottom), top[i], bottom);
+        fused_height[i] = static_cast<float>(scale*fused);
+        fused_top[i] = top[i] + .5f*(height[i] - fused_height[i]);
+    }
+}
@@ -10,14 +10,26 @@
  * 
  */
 
+#include <cmath>
 #include <vector>
+#include <string>
 #include <memory>
+#include <stdexcept>
+#include <fstream>
 #include <opencv2/opencv.hpp>
 
 #include "../include/Detection.hpp"
+#include "../include/FramePreprocessor.hpp"
+#include "../include/YoloDecoder.hpp"
+#include "../include/NMSEngine.hpp"
+#include "../include/TileLayout.hpp"
+#include "../include/InferenceEngine.hpp"
 #include "../include/HumanDetector.hpp"
+#include "../include/AnnotationSink.hpp"
+#include "../include/StageTimers.hpp"
 
 std::shared_ptr<cv::Mat> HumanDetector::prep_frame(const cv::Mat& img) {
+    STAGE_TIMER(timers, Stage::PREP_FRAME);
     std::array<int, 2> prepped_img_dims = get_img_dims();
     int prepped_img_width = prepped_img_dims[0];
     int prepped_img_height = prepped_img_dims[1];
@@ -27,88 +39,291 @@ std::shared_ptr<cv::Mat> HumanDetector::prep_frame(const cv::Mat& img) {
     return prepped_img;
 }
 
-std::shared_ptr<std::vector<Detection> >
-        HumanDetector::parse_dnn_output(const std::vector<cv::Mat>&
-        detections, cv::Mat* img, bool show_detections) {
-    std::vector<int> classIds;
-    std::vector<float> confidences;
-    std::vector<cv::Rect> boxes;
-    for (std::size_t i = 0; i < detections.size(); i++) {
-        auto data = reinterpret_cast<float*>(detections[i].data);
-        for (int j = 0; j < detections[i].rows; ++j, data+=detections[i].cols) {
-            cv::Mat scores = detections[i].row(j).colRange(5,
-                detections[i].cols);
-            cv::Point classIdPt;
-            double confidence;
-            cv::minMaxLoc(scores, 0, &confidence, 0, &classIdPt);
-            if ((confidence > detection_probability_threshold) &&
-                (classes[classIdPt.x] == "person")) {
-                int centerX = static_cast<int>(data[0] * img_dim_[0]);
-                int centerY = static_cast<int>(data[1] * img_dim_[1]);
-                int width = static_cast<int>(data[2] * img_dim_[0]);
-                int height = static_cast<int>(data[3] * img_dim_[1]);
-                int left = centerX - width / 2;
-                int top = centerY - height / 2;
-
-                classIds.push_back(classIdPt.x);
-                confidences.push_back(static_cast<float>(confidence));
-                boxes.push_back(cv::Rect(left, top, width, height));
-            }
-        }
+std::vector<std::string> HumanDetector::read_class_names(
+        const std::string& path) {
+    std::vector<std::string> names;
+    std::ifstream ifs(path.c_str());
+    std::string line;
+    while (getline(ifs, line)) names.push_back(line);
+    return names;
+}
+
+void HumanDetector::parse_dnn_output(const std::vector<cv::Mat>& outputs,
+        std::vector<Detection>* detections, const Letterbox& letterbox) {
+    decode_outputs(outputs, letterbox);
+    collect_kept(detections);
+}
+
+void HumanDetector::decode_outputs(const std::vector<cv::Mat>& outputs,
+        const Letterbox& letterbox) {
+    {
+        STAGE_TIMER(timers, Stage::DECODE);
+        candidate_boxes.clear();
+        candidate_scores.clear();
+        for (const auto& output : outputs)
+            decoder.decode(reinterpret_cast<const float*>(output.data),
+                output.rows, output.cols, letterbox, img_dim_,
+                &candidate_boxes, &candidate_scores);
     }
 
-    std::vector<int> indices;
-    cv::dnn::NMSBoxes(boxes, confidences, score_threshold,
-                      nms_threshold, indices);
+    suppress_candidates();
+}
 
-    auto ret_detections_ptr = std::make_shared<std::vector<Detection> >();
-    for (size_t i = 0; i < indices.size(); ++i) {
-        int idx = indices[i];
-        cv::Rect box = boxes[idx];
-        if (show_detections)
-            draw_pred(classIds[idx], confidences[idx], box.x, box.y,
-                     box.x + box.width, box.y + box.height, img);
-        ret_detections_ptr->push_back({box.x, box.y, box.width, box.height});
+void HumanDetector::collect_kept(std::vector<Detection>* detections) const {
+    detections->clear();
+    for (size_t i = 0; i < nms_indices.size(); ++i) {
+        int idx = nms_indices[i];
+        cv::Rect box = candidate_boxes[idx];
+        detections->push_back({box.x, box.y, box.width, box.height,
+            candidate_scores[idx]});
     }
-    return ret_detections_ptr;
+}
+
+void HumanDetector::suppress_candidates() {
+    STAGE_TIMER(timers, Stage::NMS);
+    if (soft_nms_sigma > 0) {
+        nms.soft_nms_boxes(candidate_boxes, candidate_scores,
+            static_cast<float>(score_threshold),
+            static_cast<float>(nms_threshold),
+            static_cast<float>(soft_nms_sigma), NMSEngine::GAUSSIAN,
+            &nms_indices, &nms_scores);
+        for (size_t i = 0; i < nms_indices.size(); ++i)
+            candidate_scores[nms_indices[i]] = nms_scores[i];
+    } else {
+        nms.nms_boxes(candidate_boxes, candidate_scores,
+            static_cast<float>(score_threshold),
+            static_cast<float>(nms_threshold), &nms_indices);
+    }
+}
+
+void HumanDetector::forward_blob(const cv::Mat& blob,
+        std::vector<cv::Mat>* outputs) {
+    STAGE_TIMER(timers, Stage::FORWARD);
+    engine->set_input(blob);
+    engine->forward(outputs);
+}
+
+std::vector<std::vector<cv::Mat> > HumanDetector::split_batched_output(
+        const std::vector<cv::Mat>& outputs, int batch_size) {
+    std::vector<std::vector<cv::Mat> > per_frame(batch_size,
+        std::vector<cv::Mat>(outputs.size()));
+    for (std::size_t i = 0; i < outputs.size(); i++) {
+        // Region layers output either [N*rows, cols] or [N, rows, cols].
+        int cols = outputs[i].size[outputs[i].dims - 1];
+        int rows = static_cast<int>(outputs[i].total() / cols) / batch_size;
+        auto data = reinterpret_cast<float*>(outputs[i].data);
+        for (int b = 0; b < batch_size; b++)
+            per_frame[b][i] = cv::Mat(rows, cols, CV_32F,
+                data + static_cast<std::size_t>(b)*rows*cols);
+    }
+    return per_frame;
 }
 
 std::shared_ptr<std::vector<Detection> > HumanDetector::detect(
         cv::Mat& prepped_img, bool show_detections) {
-    cv::Mat blob;
-    cv::dnn::blobFromImage(prepped_img, blob, 1/255.0,
-        cv::Size(img_dim_[0], img_dim_[1]), cv::Scalar(0, 0, 0), true, false);
-    net.setInput(blob);
+    cv::Mat blob = make_blob(prepped_img);
+
+    std::vector<cv::Mat> detections;
+    forward_blob(blob, &detections);
+    auto ret_detections_ptr = std::make_shared<std::vector<Detection> >();
+    parse_dnn_output(detections, ret_detections_ptr.get());
+    if (show_detections)
+        AnnotationSink::draw(*ret_detections_ptr, img_dim_, &prepped_img);
+
+    return ret_detections_ptr;
+}
+
+std::shared_ptr<std::vector<Detection> > HumanDetector::detect_frame(
+        const cv::Mat& img) {
+    auto ret_detections_ptr = std::make_shared<std::vector<Detection> >();
+    detect_frame(img, ret_detections_ptr.get());
+    return ret_detections_ptr;
+}
+
+void HumanDetector::detect_frame(const cv::Mat& img,
+        std::vector<Detection>* detections) {
+    infer_frame(img);
+    collect_kept(detections);
+}
+
+void HumanDetector::detect_frame(const cv::Mat& img, DetectionBatch* batch,
+        int frame_id) {
+    infer_frame(img);
+    for (int idx : nms_indices) {
+        const cv::Rect& box = candidate_boxes[idx];
+        batch->push_back(static_cast<float>(box.x), static_cast<float>(box.y),
+            static_cast<float>(box.width), static_cast<float>(box.height),
+            candidate_scores[idx], decoder.get_person_idx(), frame_id);
+    }
+}
+
+void HumanDetector::infer_frame(const cv::Mat& img) {
+    if (img.type() != CV_8UC3) {
+        forward_blob(make_blob(img), &output_mats);
+        decode_outputs(output_mats, Letterbox());
+        return;
+    }
+
+    {
+        STAGE_TIMER(timers, Stage::PREP_FRAME);
+        preprocessor.run(img.data, img.cols, img.rows, img.step,
+            input_tensor.ptr<float>());
+    }
+    forward_blob(input_tensor, &output_mats);
+    decode_outputs(output_mats, preprocessor.get_letterbox());
+}
+
+std::shared_ptr<std::vector<Detection> > HumanDetector::detect_tiled(
+        const cv::Mat& img) {
+    if (img.type() != CV_8UC3 || img.empty()) return detect_frame(img);
+
+    const auto& tiles = tile_layout.get_tiles(img.size());
+    int batch_size = 1 + static_cast<int>(tiles.size());
+    if (tile_tensor.empty() || tile_tensor.size[0] != batch_size) {
+        int tensor_dims[] = {batch_size, 3, net_dim_[1], net_dim_[0]};
+        tile_tensor.create(4, tensor_dims, CV_32F);
+    }
+
+    // The whole frame goes first, so people too large for a tile are kept.
+    std::size_t plane = static_cast<std::size_t>(3)*net_dim_[0]*net_dim_[1];
+    float* dst = tile_tensor.ptr<float>();
+    {
+        STAGE_TIMER(timers, Stage::PREP_FRAME);
+        preprocessor.run(img.data, img.cols, img.rows, img.step, dst);
+        for (std::size_t i = 0; i < tiles.size(); i++)
+            tile_preprocessor.run(img.ptr<uint8_t>(tiles[i].y) + 3*tiles[i].x,
+                tiles[i].width, tiles[i].height, img.step,
+                dst + (i + 1)*plane);
+    }
 
     std::vector<cv::Mat> detections;
-    net.forward(detections, detection_classes);
-    auto ret_detections_ptr = parse_dnn_output(detections, &prepped_img,
-        show_detections);
+    forward_blob(tile_tensor, &detections);
+    decode_tiles(split_batched_output(detections, batch_size), tiles,
+        img.size());
+    suppress_candidates();
 
+    double scale_x = img_dim_[0]/static_cast<double>(img.cols);
+    double scale_y = img_dim_[1]/static_cast<double>(img.rows);
+    auto ret_detections_ptr = std::make_shared<std::vector<Detection> >();
+    for (int idx : nms_indices) {
+        const cv::Rect& box = candidate_boxes[idx];
+        ret_detections_ptr->push_back({
+            static_cast<int>(std::lround(box.x*scale_x)),
+            static_cast<int>(std::lround(box.y*scale_y)),
+            static_cast<int>(std::lround(box.width*scale_x)),
+            static_cast<int>(std::lround(box.height*scale_y)),
+            candidate_scores[idx]});
+    }
     return ret_detections_ptr;
 }
 
-void HumanDetector::draw_pred(int classId, float conf, int left, int top,
-        int right, int bottom, cv::Mat* frame) {
-    rectangle(*frame, cv::Point(left, top), cv::Point(right, bottom),
-        cv::Scalar(255, 178, 50), 3);
-    std::string label = cv::format("%.2f", conf);
-    if (!classes.empty()) {
-        CV_Assert(classId < static_cast<int>(classes.size()));
-        label = classes[classId] + ":" + label;
+void HumanDetector::decode_tiles(
+        const std::vector<std::vector<cv::Mat> >& per_tile,
+        const std::vector<cv::Rect>& tiles, const cv::Size& frame_size) {
+    STAGE_TIMER(timers, Stage::DECODE);
+    candidate_boxes.clear();
+    candidate_scores.clear();
+    std::array<int, 2> frame_dim{{frame_size.width, frame_size.height}};
+    for (const auto& detection : per_tile[0])
+        decoder.decode(reinterpret_cast<const float*>(detection.data),
+            detection.rows, detection.cols, preprocessor.get_letterbox(),
+            frame_dim, &candidate_boxes, &candidate_scores);
+
+    const int seam_margin = 2;
+    for (std::size_t i = 0; i < tiles.size(); i++) {
+        const cv::Rect& tile = tiles[i];
+        std::size_t first = candidate_boxes.size();
+        std::array<int, 2> tile_dim{{tile.width, tile.height}};
+        for (const auto& detection : per_tile[i + 1])
+            decoder.decode(reinterpret_cast<const float*>(detection.data),
+                detection.rows, detection.cols, Letterbox(), tile_dim,
+                &candidate_boxes, &candidate_scores);
+
+        // Keep a box only if every tile edge it touches is a frame edge.
+        bool inner_left = tile.x > 0;
+        bool inner_top = tile.y > 0;
+        bool inner_right = tile.x + tile.width < frame_size.width;
+        bool inner_bottom = tile.y + tile.height < frame_size.height;
+        std::size_t kept = first;
+        for (std::size_t j = first; j < candidate_boxes.size(); j++) {
+            const cv::Rect& box = candidate_boxes[j];
+            if ((inner_left && box.x <= seam_margin) ||
+                (inner_top && box.y <= seam_margin) ||
+                (inner_right && box.x + box.width >= tile.width - seam_margin)
+                || (inner_bottom &&
+                    box.y + box.height >= tile.height - seam_margin))
+                continue;
+            candidate_boxes[kept] = cv::Rect(box.x + tile.x, box.y + tile.y,
+                box.width, box.height);
+            candidate_scores[kept++] = candidate_scores[j];
+        }
+        candidate_boxes.resize(kept);
+        candidate_scores.resize(kept);
+    }
+}
+
+std::vector<std::shared_ptr<std::vector<Detection> > >
+        HumanDetector::detect_batch(const std::vector<cv::Mat>& frames) {
+    std::vector<std::shared_ptr<std::vector<Detection> > > ret{};
+    if (frames.empty()) return ret;
+
+    cv::Mat blob;
+    {
+        STAGE_TIMER(timers, Stage::BLOB);
+        cv::dnn::blobFromImages(frames, blob, 1/255.0,
+            cv::Size(net_dim_[0], net_dim_[1]), cv::Scalar(0, 0, 0), true,
+            false);
     }
 
-    int baseLine;
-    cv::Size labelSize = cv::getTextSize(label, cv::FONT_HERSHEY_SIMPLEX,
-        0.5, 1, &baseLine);
-    top = cv::max(top, labelSize.height);
-    rectangle(*frame, cv::Point(left, top - std::round(1.5*labelSize.height)),
-        cv::Point(left + std::round(1.5*labelSize.width), top + baseLine),
-        cv::Scalar(255, 255, 255), cv::FILLED);
-    putText(*frame, label, cv::Point(left, top), cv::FONT_HERSHEY_SIMPLEX,
-        0.75, cv::Scalar(0, 0, 0), 1);
+    std::vector<cv::Mat> detections;
+    forward_blob(blob, &detections);
+
+    auto per_frame = split_batched_output(detections,
+        static_cast<int>(frames.size()));
+    for (const auto& frame_detections : per_frame) {
+        ret.push_back(std::make_shared<std::vector<Detection> >());
+        parse_dnn_output(frame_detections, ret.back().get());
+    }
+    return ret;
+}
+
+cv::Mat HumanDetector::make_blob(const cv::Mat& img) {
+    STAGE_TIMER(timers, Stage::BLOB);
+    cv::Mat blob;
+    cv::dnn::blobFromImage(img, blob, 1/255.0,
+        cv::Size(net_dim_[0], net_dim_[1]), cv::Scalar(0, 0, 0), true, false);
+    return blob;
+}
+
+std::vector<cv::Mat> HumanDetector::infer(const cv::Mat& blob) {
+    std::vector<cv::Mat> detections;
+    forward_blob(blob, &detections);
+    for (auto& detection : detections)
+        detection = detection.clone();
+    return detections;
+}
+
+std::shared_ptr<std::vector<Detection> > HumanDetector::parse_detections(
+        const std::vector<cv::Mat>& outputs) {
+    auto ret_detections_ptr = std::make_shared<std::vector<Detection> >();
+    parse_dnn_output(outputs, ret_detections_ptr.get());
+    return ret_detections_ptr;
 }
 
 std::array<int, 2> HumanDetector::get_img_dims() {
     return img_dim_;
 }
+
+void HumanDetector::set_input_size(int width, int height) {
+    if (width <= 0 || height <= 0 || width % 32 || height % 32)
+        throw std::invalid_argument("Network input size must be a positive"
+            " multiple of 32.");
+    if (width == net_dim_[0] && height == net_dim_[1]) return;
+
+    net_dim_ = {{width, height}};
+    preprocessor = FramePreprocessor(width, height, letterbox_input);
+    tile_preprocessor = FramePreprocessor(width, height);
+    int tensor_dims[] = {1, 3, height, width};
+    input_tensor.create(4, tensor_dims, CV_32F);
+    tile_tensor.release();
+}
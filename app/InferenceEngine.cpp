@@ -0,0 +1,51 @@
+/**
+ * @file InferenceEngine.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Inference Engine factory definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <memory>
+#include <unordered_map>
+
+#include "../include/utils.hpp"
+#include "../include/DnnEngine.hpp"
+#include "../include/Int8Engine.hpp"
+#include "../include/WeightStore.hpp"
+#include "../include/InferenceEngine.hpp"
+
+std::unique_ptr<InferenceEngine> InferenceEngine::create(
+        const std::unordered_map<std::string, double>& robot_params,
+        const std::string& cfg_path, const std::string& weight_path) {
+    const std::string onnx_ext = ".onnx";
+    if (weight_path.size() < onnx_ext.size() ||
+            weight_path.compare(weight_path.size() - onnx_ext.size(),
+            onnx_ext.size(), onnx_ext) != 0)
+        return create(robot_params, *WeightStore::get(cfg_path, weight_path));
+
+    int backend = DnnEngine::get_backend(robot_params);
+    int target = DnnEngine::get_target(robot_params);
+    if (get_param(robot_params, "INT8_INFERENCE", 0) != 0)
+        return std::unique_ptr<InferenceEngine>(new Int8Engine(weight_path,
+            Int8Engine::read_calibration_blobs(robot_params), backend, target));
+    return std::unique_ptr<InferenceEngine>(new OnnxEngine(weight_path,
+        backend, target));
+}
+
+std::unique_ptr<InferenceEngine> InferenceEngine::create(
+        const std::unordered_map<std::string, double>& robot_params,
+        const DarknetModel& model) {
+    int backend = DnnEngine::get_backend(robot_params);
+    int target = DnnEngine::get_target(robot_params);
+    if (get_param(robot_params, "INT8_INFERENCE", 0) != 0)
+        return std::unique_ptr<InferenceEngine>(new Int8Engine(model,
+            Int8Engine::read_calibration_blobs(robot_params), backend, target));
+    return std::unique_ptr<InferenceEngine>(new DarknetEngine(model, backend,
+        target));
+}
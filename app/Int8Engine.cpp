@@ -0,0 +1,74 @@
+/**
+ * @file Int8Engine.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief INT8 inference engine definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/LabelParser.hpp"
+#include "../include/Int8Engine.hpp"
+
+std::mutex Int8Engine::calibration_mtx;
+std::map<std::tuple<std::string, int, int, std::size_t>,
+    std::vector<cv::Mat> > Int8Engine::calibration_cache;
+
+cv::dnn::Net Int8Engine::quantize(cv::dnn::Net float_net,
+        const std::vector<cv::Mat>& calibration_blobs) {
+    if (calibration_blobs.empty())
+        throw std::invalid_argument("INT8 calibration needs at least one"
+            " frame.");
+    return float_net.quantize(calibration_blobs, CV_32F, CV_32F, false);
+}
+
+std::vector<cv::Mat> Int8Engine::read_calibration_blobs(
+        const std::unordered_map<std::string, double>& robot_params,
+        const std::string& labels_dir) {
+    std::size_t max_frames = static_cast<std::size_t>(
+        get_param(robot_params, "INT8_CALIBRATION_FRAMES", 32));
+    cv::Size input_size(static_cast<int>(robot_params.at("IMG_WIDTH_REQ")),
+        static_cast<int>(robot_params.at("IMG_HEIGHT_REQ")));
+    auto key = std::make_tuple(labels_dir, input_size.width,
+        input_size.height, max_frames);
+    std::lock_guard<std::mutex> lock(calibration_mtx);
+    auto it = calibration_cache.find(key);
+    if (it != calibration_cache.end()) return it->second;
+
+    LabelParser label_parser;
+    auto labels = label_parser.read_labeled_test_images(labels_dir);
+    labels.erase(std::remove_if(labels.begin(), labels.end(),
+        [](const std::shared_ptr<TestImage>& label) {
+            return label->all_detections.empty() || label->img.empty();
+        }), labels.end());
+    std::sort(labels.begin(), labels.end(),
+        [](const std::shared_ptr<TestImage>& a,
+                const std::shared_ptr<TestImage>& b) {
+            return a->name < b->name;
+        });
+
+    std::size_t num_frames = std::min(labels.size(), max_frames);
+    std::vector<cv::Mat> blobs;
+    for (std::size_t i = 0; i < num_frames; i++) {
+        const auto& label = labels[i*labels.size()/num_frames];
+        blobs.push_back(cv::dnn::blobFromImage(label->img, 1/255.0,
+            input_size, cv::Scalar(0, 0, 0), true, false));
+    }
+    calibration_cache[key] = blobs;
+    return blobs;
+}
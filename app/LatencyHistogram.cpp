@@ -0,0 +1,69 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Latency Histogram definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+
+#include "../include/LatencyHistogram.hpp"
+
+const int LatencyHistogram::sub_buckets;
+const int LatencyHistogram::num_buckets;
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+std::uint64_t LatencyHistogram::bucket_upper_ns(int index) {
+    if (index < 2*sub_buckets) return static_cast<std::uint64_t>(index);
+    int shift = index/sub_buckets - 1;
+    std::uint64_t lower = static_cast<std::uint64_t>(
+        sub_buckets + index % sub_buckets) << shift;
+    return lower + ((std::uint64_t{1} << shift) - 1);
+}
+
+LatencySummary LatencyHistogram::summary() const {
+    std::array<std::uint64_t, num_buckets> counts;
+    std::uint64_t total = 0;
+    for (int i = 0; i < num_buckets; i++) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    LatencySummary ret;
+    ret.count = total;
+    if (total == 0) return ret;
+    std::uint64_t max = max_ns.load(std::memory_order_relaxed);
+    ret.mean_ms = sum_ns.load(std::memory_order_relaxed)/1e6/
+        std::max<std::uint64_t>(count.load(std::memory_order_relaxed), 1);
+    ret.max_ms = max/1e6;
+
+    // Smallest bucket holding at least the quantile of the counts
+    const double quantiles[] = {0.5, 0.9, 0.99};
+    double* outputs[] = {&ret.p50_ms, &ret.p90_ms, &ret.p99_ms};
+    std::uint64_t seen = 0;
+    int q = 0;
+    for (int i = 0; i < num_buckets && q < 3; i++) {
+        seen += counts[i];
+        while (q < 3 && seen >= quantiles[q]*total) {
+            *outputs[q++] = std::min(bucket_upper_ns(i), max)/1e6;
+        }
+    }
+    return ret;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    sum_ns.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+}
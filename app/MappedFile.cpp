@@ -0,0 +1,52 @@
+/**
+ * @file MappedFile.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Mapped File definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <string>
+
+#include "../include/utils.hpp"
+#include "../include/MappedFile.hpp"
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw InvalidFile("Cannot read model file " + path + ".");
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw InvalidFile("Cannot read model file " + path + ".");
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    if (length == 0) {
+        close(fd);
+        return;
+    }
+
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    if (mapped == MAP_FAILED)
+        throw InvalidFile("Cannot map model file " + path + ".");
+    // The model is read front to back once per network, so let the kernel
+    // read ahead aggressively.
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    addr = static_cast<const char*>(mapped);
+}
+
+MappedFile::~MappedFile() {
+    if (addr) munmap(const_cast<char*>(addr), length);
+}
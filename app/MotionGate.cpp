@@ -0,0 +1,110 @@
+/**
+ * @file MotionGate.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Motion Gate definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/MotionGate.hpp"
+
+const int MotionGate::thumbnail_size;
+
+MotionGate::MotionGate(double _pixel_threshold, double _changed_fraction,
+        int _max_skipped) :
+        pixel_threshold{_pixel_threshold}, changed_fraction{_changed_fraction},
+        max_skipped{_max_skipped} {
+    if (pixel_threshold < 0 || pixel_threshold > 1 ||
+            changed_fraction < 0 || changed_fraction > 1)
+        throw std::invalid_argument("Motion gate thresholds must be in"
+            " [0, 1].");
+    if (max_skipped < 0)
+        throw std::invalid_argument("Motion gate max skipped frames must not"
+            " be negative.");
+}
+
+MotionGate::MotionGate(
+        const std::unordered_map<std::string, double>& robot_params) :
+        MotionGate(get_param(robot_params, "MOTION_PIXEL_THRESHOLD", 0.05),
+            get_param(robot_params, "MOTION_CHANGED_FRACTION", 0.01),
+            static_cast<int>(get_param(robot_params, "MOTION_MAX_SKIPPED",
+                15))) {}
+
+void MotionGate::make_thumbnail(const cv::Mat& frame) {
+    cv::resize(frame, small, cv::Size(thumbnail_size, thumbnail_size), 0, 0,
+        cv::INTER_AREA);
+    thumbnail.resize(thumbnail_size*thumbnail_size);
+    int channels = small.channels();
+    for (int y = 0; y < thumbnail_size; y++) {
+        const uint8_t* row = small.ptr<uint8_t>(y);
+        uint8_t* out = thumbnail.data() + y*thumbnail_size;
+        if (channels == 1) {
+            for (int x = 0; x < thumbnail_size; x++) out[x] = row[x];
+            continue;
+        }
+        // BGR to luma with the BT.601 weights in 8-bit fixed point.
+        for (int x = 0; x < thumbnail_size; x++) {
+            const uint8_t* px = row + x*channels;
+            out[x] = static_cast<uint8_t>((29*px[0] + 150*px[1] + 77*px[2] +
+                128) >> 8);
+        }
+    }
+}
+
+bool MotionGate::should_infer(const cv::Mat& frame) {
+    auto start = std::chrono::steady_clock::now();
+    make_thumbnail(frame);
+
+    bool changed = reference.size() != thumbnail.size() ||
+        skipped_in_row >= max_skipped;
+    if (!changed) {
+        int threshold = static_cast<int>(pixel_threshold*255);
+        std::size_t max_changed = static_cast<std::size_t>(
+            changed_fraction*thumbnail.size());
+        std::size_t num_changed = 0;
+        for (std::size_t i = 0; i < thumbnail.size(); i++) {
+            int diff = static_cast<int>(thumbnail[i]) - reference[i];
+            if (diff > threshold || -diff > threshold) num_changed++;
+        }
+        changed = num_changed > max_changed;
+    }
+
+    if (changed) {
+        reference.swap(thumbnail);
+        skipped_in_row = 0;
+    } else {
+        skipped_in_row++;
+        stats.skipped++;
+    }
+    stats.frames++;
+    stats.gate_ms += std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    return changed;
+}
+
+void MotionGate::record_inference_ms(double ms) {
+    num_inferences++;
+    inference_ms += ms;
+}
+
+MotionGateStats MotionGate::get_stats() const {
+    MotionGateStats ret = stats;
+    if (ret.frames) ret.skip_ratio = ret.skipped/static_cast<double>(ret.frames);
+    double avg_inference_ms = num_inferences ?
+        inference_ms/num_inferences : 0;
+    ret.saved_ms = ret.skipped*avg_inference_ms - ret.gate_ms;
+    return ret;
+}
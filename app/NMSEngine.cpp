@@ -0,0 +1,357 @@
+/**
+ * @file NMSEngine.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief NMS Engine definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "../include/NMSEngine.hpp"
+
+namespace {
+
+/**
+ * @brief Area of the intersection of two boxes, 0 if they do not intersect.
+ * 
+ */
+int intersection_area(const cv::Rect& a, const cv::Rect& b) {
+    int w = std::min(a.x + a.width, b.x + b.width) - std::max(a.x, b.x);
+    int h = std::min(a.y + a.height, b.y + b.height) - std::max(a.y, b.y);
+    if (w <= 0 || h <= 0) return 0;
+    return w*h;
+}
+
+}  // namespace
+
+float NMSEngine::overlap(int area_a, int area_b, int inter) {
+    // Same operations as cv::rectOverlap / cv::jaccardDistance.
+    if (area_a + area_b <= 0) return 1.f;
+    double inter_area = inter;
+    double distance = 1.0 - inter_area/(area_a + area_b - inter_area);
+    return 1.f - static_cast<float>(distance);
+}
+
+void NMSEngine::sort_candidates(const std::vector<float>& scores,
+        float score_threshold) {
+    order.clear();
+    for (std::size_t i = 0; i < scores.size(); i++)
+        if (scores[i] > score_threshold) order.push_back(static_cast<int>(i));
+    // order is ascending, so breaking ties by index matches a stable sort
+    // without the temporary buffer std::stable_sort allocates.
+    std::sort(order.begin(), order.end(), [&scores](int a, int b) {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b); });
+}
+
+void NMSEngine::build_grid(const std::vector<cv::Rect>& boxes) {
+    int64_t sum_w = 0, sum_h = 0;
+    int count = 0;
+    int max_x = 0, max_y = 0;
+    for (int idx : order) {
+        const cv::Rect& box = boxes[idx];
+        if (box.empty()) continue;
+        if (count == 0) {
+            min_x = box.x;
+            min_y = box.y;
+            max_x = box.x + box.width;
+            max_y = box.y + box.height;
+        }
+        min_x = std::min(min_x, box.x);
+        min_y = std::min(min_y, box.y);
+        max_x = std::max(max_x, box.x + box.width);
+        max_y = std::max(max_y, box.y + box.height);
+        sum_w += box.width;
+        sum_h += box.height;
+        count++;
+    }
+
+    grid_w = grid_h = 1;
+    cell_w = cell_h = 1;
+    if (count > 0) {
+        // About one cell per candidate, but never smaller than a typical box.
+        int axis_cells = std::min(128, std::max(1,
+            static_cast<int>(std::ceil(std::sqrt(count)))));
+        int range_w = max_x - min_x;
+        int range_h = max_y - min_y;
+        cell_w = std::max<int>({1, static_cast<int>(sum_w/count),
+            (range_w + axis_cells - 1)/axis_cells});
+        cell_h = std::max<int>({1, static_cast<int>(sum_h/count),
+            (range_h + axis_cells - 1)/axis_cells});
+        grid_w = std::max(1, (range_w + cell_w - 1)/cell_w);
+        grid_h = std::max(1, (range_h + cell_h - 1)/cell_h);
+    }
+
+    std::size_t num_cells = static_cast<std::size_t>(grid_w)*grid_h;
+    if (cells.size() < num_cells) cells.resize(num_cells);
+    for (std::size_t i = 0; i < num_cells; i++) {
+        cells[i].x1.clear();
+        cells[i].y1.clear();
+        cells[i].x2.clear();
+        cells[i].y2.clear();
+        cells[i].ids.clear();
+    }
+}
+
+std::array<int, 4> NMSEngine::cell_range(const cv::Rect& box) const {
+    auto clamp = [](int v, int hi) { return std::min(std::max(v, 0), hi); };
+    return {{clamp((box.x - min_x)/cell_w, grid_w - 1),
+        clamp((box.y - min_y)/cell_h, grid_h - 1),
+        clamp((box.x + box.width - 1 - min_x)/cell_w, grid_w - 1),
+        clamp((box.y + box.height - 1 - min_y)/cell_h, grid_h - 1)}};
+}
+
+void NMSEngine::insert(const cv::Rect& box, int id) {
+    auto range = cell_range(box);
+    for (int cy = range[1]; cy <= range[3]; cy++) {
+        for (int cx = range[0]; cx <= range[2]; cx++) {
+            Cell& cell = cells[static_cast<std::size_t>(cy)*grid_w + cx];
+            cell.x1.push_back(static_cast<float>(box.x));
+            cell.y1.push_back(static_cast<float>(box.y));
+            cell.x2.push_back(static_cast<float>(box.x + box.width));
+            cell.y2.push_back(static_cast<float>(box.y + box.height));
+            cell.ids.push_back(id);
+        }
+    }
+}
+
+template <typename Visit>
+bool NMSEngine::for_each_intersecting(const cv::Rect& box, Visit&& visit) {
+    const float bx1 = static_cast<float>(box.x);
+    const float by1 = static_cast<float>(box.y);
+    const float bx2 = static_cast<float>(box.x + box.width);
+    const float by2 = static_cast<float>(box.y + box.height);
+
+    auto range = cell_range(box);
+    for (int cy = range[1]; cy <= range[3]; cy++) {
+        for (int cx = range[0]; cx <= range[2]; cx++) {
+            const Cell& cell = cells[static_cast<std::size_t>(cy)*grid_w + cx];
+            const std::size_t n = cell.ids.size();
+            std::size_t i = 0;
+#if defined(__AVX__)
+            const __m256 vx1 = _mm256_set1_ps(bx1);
+            const __m256 vy1 = _mm256_set1_ps(by1);
+            const __m256 vx2 = _mm256_set1_ps(bx2);
+            const __m256 vy2 = _mm256_set1_ps(by2);
+            const __m256 zero = _mm256_setzero_ps();
+            for (; i + 8 <= n; i += 8) {
+                __m256 w = _mm256_sub_ps(
+                    _mm256_min_ps(vx2, _mm256_loadu_ps(&cell.x2[i])),
+                    _mm256_max_ps(vx1, _mm256_loadu_ps(&cell.x1[i])));
+                __m256 h = _mm256_sub_ps(
+                    _mm256_min_ps(vy2, _mm256_loadu_ps(&cell.y2[i])),
+                    _mm256_max_ps(vy1, _mm256_loadu_ps(&cell.y1[i])));
+                int mask = _mm256_movemask_ps(_mm256_and_ps(
+                    _mm256_cmp_ps(w, zero, _CMP_GT_OQ),
+                    _mm256_cmp_ps(h, zero, _CMP_GT_OQ)));
+                while (mask) {
+                    if (visit(cell.ids[i + __builtin_ctz(mask)])) return true;
+                    mask &= mask - 1;
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128 vx1 = _mm_set1_ps(bx1);
+            const __m128 vy1 = _mm_set1_ps(by1);
+            const __m128 vx2 = _mm_set1_ps(bx2);
+            const __m128 vy2 = _mm_set1_ps(by2);
+            const __m128 zero = _mm_setzero_ps();
+            for (; i + 4 <= n; i += 4) {
+                __m128 w = _mm_sub_ps(_mm_min_ps(vx2, _mm_loadu_ps(&cell.x2[i])),
+                    _mm_max_ps(vx1, _mm_loadu_ps(&cell.x1[i])));
+                __m128 h = _mm_sub_ps(_mm_min_ps(vy2, _mm_loadu_ps(&cell.y2[i])),
+                    _mm_max_ps(vy1, _mm_loadu_ps(&cell.y1[i])));
+                int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpgt_ps(w, zero),
+                    _mm_cmpgt_ps(h, zero)));
+                while (mask) {
+                    if (visit(cell.ids[i + __builtin_ctz(mask)])) return true;
+                    mask &= mask - 1;
+                }
+            }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            const float32x4_t vx1 = vdupq_n_f32(bx1);
+            const float32x4_t vy1 = vdupq_n_f32(by1);
+            const float32x4_t vx2 = vdupq_n_f32(bx2);
+            const float32x4_t vy2 = vdupq_n_f32(by2);
+            const float32x4_t zero = vdupq_n_f32(0.f);
+            for (; i + 4 <= n; i += 4) {
+                float32x4_t w = vsubq_f32(vminq_f32(vx2, vld1q_f32(&cell.x2[i])),
+                    vmaxq_f32(vx1, vld1q_f32(&cell.x1[i])));
+                float32x4_t h = vsubq_f32(vminq_f32(vy2, vld1q_f32(&cell.y2[i])),
+                    vmaxq_f32(vy1, vld1q_f32(&cell.y1[i])));
+                uint32x4_t hit = vandq_u32(vcgtq_f32(w, zero),
+                    vcgtq_f32(h, zero));
+                if (vmaxvq_u32(hit) == 0) continue;
+                uint32_t lanes[4];
+                vst1q_u32(lanes, hit);
+                for (int lane = 0; lane < 4; lane++)
+                    if (lanes[lane] && visit(cell.ids[i + lane])) return true;
+            }
+#endif
+            for (; i < n; i++) {
+                if (std::min(bx2, cell.x2[i]) - std::max(bx1, cell.x1[i]) > 0 &&
+                    std::min(by2, cell.y2[i]) - std::max(by1, cell.y1[i]) > 0 &&
+                    visit(cell.ids[i]))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void NMSEngine::nms_boxes(const std::vector<cv::Rect>& boxes,
+        const std::vector<float>& scores, float score_threshold,
+        float nms_threshold, std::vector<int>* indices) {
+    if (boxes.size() != scores.size() || score_threshold < 0 ||
+            nms_threshold < 0)
+        throw std::invalid_argument("NMS needs one score per box and "
+            "non-negative thresholds.");
+
+    indices->clear();
+    sort_candidates(scores, score_threshold);
+    build_grid(boxes);
+    kept.clear();
+    kept_degenerate.clear();
+
+    for (int idx : order) {
+        const cv::Rect& box = boxes[idx];
+        const int area = box.area();
+        auto suppresses = [&](int other, int inter) {
+            return overlap(area, boxes[other].area(), inter) > nms_threshold;
+        };
+
+        bool suppressed = false;
+        if (box.empty()) {
+            // Degenerate boxes intersect nothing but can still "overlap"
+            // through the area check, so compare with every kept box.
+            for (int other : kept)
+                if ((suppressed = suppresses(other, 0))) break;
+        } else {
+            for (int other : kept_degenerate)
+                if ((suppressed = suppresses(other, 0))) break;
+            if (!suppressed)
+                suppressed = for_each_intersecting(box, [&](int other) {
+                    return suppresses(other,
+                        intersection_area(box, boxes[other])); });
+        }
+
+        if (suppressed) continue;
+        indices->push_back(idx);
+        kept.push_back(idx);
+        if (box.empty())
+            kept_degenerate.push_back(idx);
+        else
+            insert(box, idx);
+    }
+}
+
+void NMSEngine::nms_boxes(const DetectionBatch& batch, float score_threshold,
+        float nms_threshold, std::vector<int>* indices) {
+    const std::size_t n = batch.size();
+    batch_boxes.resize(n);
+    batch_scores.assign(batch.confidence(), batch.confidence() + n);
+
+    for (std::size_t i = 0; i < n; i++) {
+        Detection box = batch.get(i);
+        batch_boxes[i] = cv::Rect(box.x, box.y, box.width, box.height);
+    }
+
+    // Frames are laid side by side, each shifted right by one frame span.
+    int left = 0, right = 0;
+    for (const cv::Rect& box : batch_boxes) {
+        left = std::min(left, box.x);
+        right = std::max(right, box.x + box.width);
+    }
+    const int span = right - left + 1;
+    for (std::size_t i = 0; i < n; i++)
+        batch_boxes[i].x += batch.frame_id()[i]*span;
+    nms_boxes(batch_boxes, batch_scores, score_threshold, nms_threshold,
+        indices);
+}
+
+void NMSEngine::soft_nms_boxes(const std::vector<cv::Rect>& boxes,
+        const std::vector<float>& scores, float score_threshold,
+        float nms_threshold, float sigma, SoftNMSMethod method,
+        std::vector<int>* indices, std::vector<float>* updated_scores) {
+    if (boxes.size() != scores.size() || score_threshold < 0 ||
+            (method == GAUSSIAN && sigma <= 0))
+        throw std::invalid_argument("Soft-NMS needs one score per box, a "
+            "non-negative score threshold and a positive sigma.");
+
+    indices->clear();
+    updated_scores->clear();
+    sort_candidates(scores, score_threshold);
+    build_grid(boxes);
+
+    rank.assign(boxes.size(), 0);
+    visit_stamp.assign(boxes.size(), -1);
+    done.assign(boxes.size(), 1);
+    soft_scores.assign(scores.begin(), scores.end());
+
+    heap.clear();
+    for (std::size_t r = 0; r < order.size(); r++) {
+        int idx = order[r];
+        rank[idx] = static_cast<int>(r);
+        done[idx] = 0;
+        heap.push_back({scores[idx], rank[idx], idx});
+        if (!boxes[idx].empty()) insert(boxes[idx], idx);
+    }
+
+    std::make_heap(heap.begin(), heap.end());
+
+    int iteration = 0;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        ScoredBox top = heap.back();
+        heap.pop_back();
+        // Entries whose box was already taken or decayed since are stale.
+        if (done[top.id] || top.score != soft_scores[top.id]) continue;
+
+        done[top.id] = 1;
+        indices->push_back(top.id);
+        updated_scores->push_back(top.score);
+
+        const cv::Rect& selected = boxes[top.id];
+        if (selected.empty()) continue;
+        const int area = selected.area();
+        for_each_intersecting(selected, [&](int other) {
+            if (done[other] || visit_stamp[other] == iteration) return false;
+            visit_stamp[other] = iteration;
+
+            float iou = overlap(area, boxes[other].area(),
+                intersection_area(selected, boxes[other]));
+            float decay = 1.f;
+            if (method == GAUSSIAN)
+                decay = std::exp(-iou*iou/sigma);
+            else if (iou > nms_threshold)
+                decay = 1.f - iou;
+            if (decay >= 1.f) return false;
+
+            float decayed = soft_scores[other]*decay;
+            soft_scores[other] = decayed;
+            if (decayed > score_threshold) {
+                heap.push_back({decayed, rank[other], other});
+                std::push_heap(heap.begin(), heap.end());
+            } else {
+                done[other] = 1;
+            }
+            return false;
+        });
+        iteration++;
+    }
+}
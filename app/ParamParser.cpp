@@ -75,6 +75,16 @@ std::array<std::string, 3> ParamParser::split_variable(
     return ret;
 }
 
+std::string ParamParser::get_base_name(const std::string& name) const {
+    static const std::string prefix = "CAMERA";
+    if (name.compare(0, prefix.size(), prefix) != 0) return name;
+    auto idx = prefix.size();
+    while (idx < name.size() && std::isdigit(name[idx])) idx++;
+    if (idx == prefix.size() || idx >= name.size() || name[idx] != '_')
+        return name;
+    return name.substr(idx + 1);
+}
+
 double ParamParser::set_variable(const std::array<std::string, 3>& var) {
     double out{};
     try {
@@ -95,8 +105,9 @@ double ParamParser::set_variable(const std::array<std::string, 3>& var) {
     }
 
     bool name_found{false};
+    const std::string base_name = get_base_name(var[0]);
     for (const auto &expected_var : _var_list) {
-        if (var[0] == expected_var.name) {
+        if (base_name == expected_var.name) {
             name_found = true;
             std::string upon_error = "Unnacceptable unit: '" + var[2] +
                 "'. " + var[0] + " should have units of ";
@@ -142,6 +153,21 @@ double ParamParser::set_variable(const std::array<std::string, 3>& var) {
                 else
                     throw InvalidFile(upon_error + "ppi, ppmm or ppm (i.e."
                         " pixels per inch, mm, or meter)." + upon_error_end);
+            } else if (expected_var.default_unit == "ms") {
+                if (var[2] == "" || var[2] == "ms") {}
+                else if (var[2] == "s") out *= 1000.0;
+                else
+                    throw InvalidFile(upon_error + "ms or s." +
+                        upon_error_end);
+            } else if (expected_var.default_unit == "s") {
+                if (var[2] == "" || var[2] == "s") {}
+                else if (var[2] == "ms") out /= 1000.0;
+                else
+                    throw InvalidFile(upon_error + "s or ms." +
+                        upon_error_end);
+            } else if (var[2] != "" && var[2] != expected_var.default_unit) {
+                throw InvalidFile(upon_error + expected_var.default_unit +
+                    "." + upon_error_end);
             }
             break;
         }
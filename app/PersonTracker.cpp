@@ -0,0 +1,279 @@
+/**
+ * @file PersonTracker.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Robot-frame multi-person tracker definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../include/utils.hpp"
+#include "../include/PersonTracker.hpp"
+
+namespace {
+
+/**
+ * @brief Velocity variance of a new track, about a brisk walk UNIT: [m^2/s^2]
+ * 
+ */
+const double initial_velocity_var = 4.0;
+
+/**
+ * @brief 99.99% quantile of the chi-squared distribution with 3 degrees of freedom. A tighter gate loses a few matches per frame in a crowd of hundreds, each restarting a young track under a new id.
+ * 
+ */
+const double gate_chi2 = 21.108;
+
+}  // namespace
+
+PersonTracker::PersonTracker(double accel_stddev, double position_stddev,
+        double _gate_distance, int _confirm_hits, int _max_misses) :
+        accel_var{accel_stddev*accel_stddev},
+        measurement_var{position_stddev*position_stddev},
+        gate_distance{_gate_distance}, confirm_hits{_confirm_hits},
+        max_misses{_max_misses} {
+    if (accel_stddev <= 0 || position_stddev <= 0 || gate_distance <= 0)
+        throw std::invalid_argument("Person tracking needs positive "
+            "acceleration and position deviations and gate distance.");
+    if (confirm_hits < 1 || max_misses < 0)
+        throw std::invalid_argument("Person tracks need at least one hit to "
+            "be confirmed and a non-negative miss limit.");
+}
+
+PersonTracker::PersonTracker(
+        const std::unordered_map<std::string, double>& robot_params) :
+        PersonTracker(get_param(robot_params, "PERSON_ACCEL_STDDEV", 2),
+            get_param(robot_params, "PERSON_POSITION_STDDEV", 0.3),
+            get_param(robot_params, "PERSON_GATE_DISTANCE", 1.5),
+            static_cast<int>(get_param(robot_params,
+                "PERSON_CONFIRM_HITS", 3)),
+            static_cast<int>(get_param(robot_params,
+                "PERSON_MAX_MISSES", 5))) {}
+
+void PersonTracker::predict(double dt) {
+    const double dt2 = dt*dt;
+    const double q00 = accel_var*dt2*dt2/4;
+    const double q01 = accel_var*dt2*dt/2;
+    const double q11 = accel_var*dt2;
+    for (auto& track : tracks) {
+        for (int i = 0; i < 3; i++)
+            track.pos[i] += dt*track.vel[i];
+        track.p00 += dt*(2*track.p01 + dt*track.p11) + q00;
+        track.p01 += dt*track.p11 + q01;
+        track.p11 += q11;
+    }
+}
+
+void PersonTracker::build_grid() {
+    double min_x = tracks[0].pos[0], max_x = min_x;
+    double min_z = tracks[0].pos[2], max_z = min_z;
+    for (const auto& track : tracks) {
+        min_x = std::min(min_x, track.pos[0]);
+        max_x = std::max(max_x, track.pos[0]);
+        min_z = std::min(min_z, track.pos[2]);
+        max_z = std::max(max_z, track.pos[2]);
+    }
+    // Cells at least gate_distance wide, so a gate spans 3x3 cells, and
+    // widened while there would be more than about 4 per track
+    grid_origin = {{min_x, min_z}};
+    grid_cell = gate_distance;
+    const double max_cells = 4.0*tracks.size() + 16;
+    while (true) {
+        double cols = std::floor((max_x - min_x)/grid_cell) + 1;
+        double rows = std::floor((max_z - min_z)/grid_cell) + 1;
+        if (cols*rows <= max_cells) {
+            grid_cols = static_cast<int>(cols);
+            grid_rows = static_cast<int>(rows);
+            break;
+        }
+        grid_cell *= 2;
+    }
+
+    // Counting sort of the tracks by cell, row by row
+    const std::size_t cells = static_cast<std::size_t>(grid_cols)*grid_rows;
+    cell_start.assign(cells + 1, 0);
+    track_cell.resize(tracks.size());
+    for (std::size_t t = 0; t < tracks.size(); t++) {
+        auto col = static_cast<int>((tracks[t].pos[0] - min_x)/grid_cell);
+        auto row = static_cast<int>((tracks[t].pos[2] - min_z)/grid_cell);
+        track_cell[t] = static_cast<std::uint32_t>(row*grid_cols + col);
+        cell_start[track_cell[t] + 1]++;
+    }
+    for (std::size_t c = 0; c < cells; c++)
+        cell_start[c + 1] += cell_start[c];
+    cell_tracks.resize(tracks.size());
+    cell_states.resize(tracks.size());
+    for (std::size_t t = 0; t < tracks.size(); t++) {
+        std::uint32_t i = cell_start[track_cell[t]]++;
+        const Track& track = tracks[t];
+        cell_tracks[i] = static_cast<std::uint32_t>(t);
+        cell_states[i] = {{track.pos[0], track.pos[1], track.pos[2],
+            1/(track.p00 + measurement_var)}};
+    }
+    // Filling moved every start to the next cell's start
+    for (std::size_t c = cells; c > 0; c--)
+        cell_start[c] = cell_start[c - 1];
+    cell_start[0] = 0;
+}
+
+void PersonTracker::associate(
+        const std::vector<std::array<double, 3> >& all_xyz) {
+    candidates.clear();
+    if (!tracks.empty()) build_grid();
+    const double max_dist2 = gate_distance*gate_distance;
+    const double inv_cell = 1/grid_cell;
+    std::size_t count = 0;
+    for (std::size_t j = 0; j < all_xyz.size() && !tracks.empty(); j++) {
+        const auto& xyz = all_xyz[j];
+        double col = std::floor((xyz[0] - grid_origin[0])*inv_cell);
+        double row = std::floor((xyz[2] - grid_origin[1])*inv_cell);
+        if (col < -1 || col > grid_cols || row < -1 || row > grid_rows)
+            continue;
+        int first_col = std::max(0, static_cast<int>(col) - 1);
+        int last_col = std::min(grid_cols - 1, static_cast<int>(col) + 1);
+        int first_row = std::max(0, static_cast<int>(row) - 1);
+        int last_row = std::min(grid_rows - 1, static_cast<int>(row) + 1);
+        for (int r = first_row; r <= last_row; r++) {
+            // The cells of a row are contiguous in the sorted tracks
+            std::uint32_t begin = cell_start[r*grid_cols + first_col];
+            std::uint32_t end = cell_start[r*grid_cols + last_col + 1];
+            if (candidates.size() < count + (end - begin))
+                candidates.resize(count + (end - begin));
+            // Written unconditionally and kept if gated, since whether a
+            // track passes the gate is unpredictable
+            for (std::uint32_t i = begin; i < end; i++) {
+                const auto& state = cell_states[i];
+                double dx = xyz[0] - state[0];
+                double dy = xyz[1] - state[1];
+                double dz = xyz[2] - state[2];
+                double dist2 = dx*dx + dy*dy + dz*dz;
+                double cost = dist2*state[3];
+                candidates[count] = {cost, cell_tracks[i],
+                    static_cast<std::uint32_t>(j)};
+                count += (dist2 <= max_dist2) & (cost <= gate_chi2);
+            }
+        }
+    }
+
+    // Greedy assignment always takes the pairs that are each other's
+    // cheapest, so those are matched in one pass. Only the contested rest
+    // is sorted, which is little unless the crowd is dense.
+    track_best.assign(tracks.size(), -1);
+    position_best.assign(all_xyz.size(), -1);
+    for (std::size_t c = 0; c < count; c++) {
+        const Candidate& candidate = candidates[c];
+        int& by_track = track_best[candidate.track];
+        int& by_position = position_best[candidate.position];
+        if (by_track < 0 || candidate.cost < candidates[by_track].cost)
+            by_track = static_cast<int>(c);
+        if (by_position < 0 || candidate.cost < candidates[by_position].cost)
+            by_position = static_cast<int>(c);
+    }
+    track_match.assign(tracks.size(), -1);
+    position_matched.assign(all_xyz.size(), 0);
+    for (std::size_t t = 0; t < tracks.size(); t++) {
+        int c = track_best[t];
+        if (c < 0 || position_best[candidates[c].position] != c) continue;
+        track_match[t] = static_cast<int>(candidates[c].position);
+        position_matched[candidates[c].position] = 1;
+    }
+
+    std::size_t contested = 0;
+    for (std::size_t c = 0; c < count; c++) {
+        const Candidate& candidate = candidates[c];
+        if (track_match[candidate.track] < 0 &&
+                !position_matched[candidate.position])
+            candidates[contested++] = candidate;
+    }
+    candidates.resize(contested);
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) {
+            return a.cost < b.cost;
+        });
+    for (const auto& candidate : candidates) {
+        if (track_match[candidate.track] >= 0 ||
+                position_matched[candidate.position])
+            continue;
+        track_match[candidate.track] = static_cast<int>(candidate.position);
+        position_matched[candidate.position] = 1;
+    }
+}
+
+void PersonTracker::update(const std::vector<std::array<double, 3> >& all_xyz,
+        double timestamp, std::vector<PersonTrack>* confirmed) {
+    double dt = has_time ? std::max(0., timestamp - last_time) : 0;
+    last_time = timestamp;
+    has_time = true;
+
+    predict(dt);
+    associate(all_xyz);
+
+    // Update matched tracks and drop lost ones, keeping creation order
+    std::size_t kept = 0;
+    for (std::size_t t = 0; t < tracks.size(); t++) {
+        Track track = tracks[t];
+        int match = track_match[t];
+        if (match >= 0) {
+            const auto& xyz = all_xyz[match];
+            double s = track.p00 + measurement_var;
+            double k0 = track.p00/s;
+            double k1 = track.p01/s;
+            for (int i = 0; i < 3; i++) {
+                double residual = xyz[i] - track.pos[i];
+                track.pos[i] += k0*residual;
+                track.vel[i] += k1*residual;
+            }
+            track.p11 -= k1*track.p01;
+            track.p01 -= k0*track.p01;
+            track.p00 -= k0*track.p00;
+            track.hits++;
+            track.misses = 0;
+        } else {
+            track.misses++;
+            bool tentative = track.hits < confirm_hits;
+            if (tentative || track.misses > max_misses) continue;
+        }
+        tracks[kept++] = track;
+    }
+    tracks.resize(kept);
+
+    for (std::size_t j = 0; j < all_xyz.size(); j++) {
+        if (position_matched[j]) continue;
+        Track track;
+        track.pos = all_xyz[j];
+        track.p00 = measurement_var;
+        track.p11 = initial_velocity_var;
+        track.id = next_id++;
+        track.hits = 1;
+        tracks.push_back(track);
+    }
+
+    confirmed->clear();
+    for (const auto& track : tracks) {
+        if (track.hits < confirm_hits) continue;
+        PersonTrack out;
+        out.id = track.id;
+        out.xyz = track.pos;
+        out.velocity = track.vel;
+        out.hits = track.hits;
+        out.misses = track.misses;
+        confirmed->push_back(out);
+    }
+}
+
+void PersonTracker::clear() {
+    tracks.clear();
+    has_time = false;
+}
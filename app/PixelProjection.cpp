@@ -0,0 +1,130 @@
+/**
+ * @file PixelProjection.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Batched pixel to robot frame projection definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <eigen3/Eigen/Dense>
+
+#include <array>
+#include <cstddef>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "../include/PixelProjection.hpp"
+
+PixelProjection::PixelProjection(const Eigen::Matrix<double, 4, 4>& cam2robot,
+        double f, double pix_density, double center_x, double center_y,
+        double avg_height) {
+    const double focal_px = f*pix_density;
+    for (int i = 0; i < 3; i++) {
+        coef[4*i] = avg_height*cam2robot(i, 0);
+        coef[4*i + 1] = avg_height*cam2robot(i, 1);
+        coef[4*i + 2] = avg_height*(cam2robot(i, 2)*focal_px -
+            cam2robot(i, 0)*center_x - cam2robot(i, 1)*center_y);
+        coef[4*i + 3] = cam2robot(i, 3);
+    }
+    for (std::size_t i = 0; i < coef.size(); i++)
+        coef_f[i] = static_cast<float>(coef[i]);
+}
+
+void PixelProjection::project(const float* x, const float* y,
+        const float* width, const float* height, std::size_t n,
+        double* out_x, double* out_y, double* out_z) const {
+    double* out[3] = {out_x, out_y, out_z};
+    std::size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    const __m256d half = _mm256_set1_pd(0.5);
+    for (; j + 4 <= n; j += 4) {
+        __m256d w = _mm256_cvtps_pd(_mm_loadu_ps(width + j));
+        __m256d h = _mm256_cvtps_pd(_mm_loadu_ps(height + j));
+        __m256d u = _mm256_fmadd_pd(w, half,
+            _mm256_cvtps_pd(_mm_loadu_ps(x + j)));
+        __m256d v = _mm256_fmadd_pd(h, half,
+            _mm256_cvtps_pd(_mm_loadu_ps(y + j)));
+        __m256d inv_h = _mm256_div_pd(_mm256_set1_pd(1.0), h);
+        for (int i = 0; i < 3; i++) {
+            __m256d p = _mm256_fmadd_pd(_mm256_set1_pd(coef[4*i]), u,
+                _mm256_fmadd_pd(_mm256_set1_pd(coef[4*i + 1]), v,
+                    _mm256_set1_pd(coef[4*i + 2])));
+            _mm256_storeu_pd(out[i] + j, _mm256_fmadd_pd(p, inv_h,
+                _mm256_set1_pd(coef[4*i + 3])));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; j + 2 <= n; j += 2) {
+        float64x2_t w = vcvt_f64_f32(vld1_f32(width + j));
+        float64x2_t h = vcvt_f64_f32(vld1_f32(height + j));
+        float64x2_t u = vfmaq_n_f64(vcvt_f64_f32(vld1_f32(x + j)), w, 0.5);
+        float64x2_t v = vfmaq_n_f64(vcvt_f64_f32(vld1_f32(y + j)), h, 0.5);
+        float64x2_t inv_h = vdivq_f64(vdupq_n_f64(1.0), h);
+        for (int i = 0; i < 3; i++) {
+            float64x2_t p = vfmaq_n_f64(vfmaq_n_f64(
+                vdupq_n_f64(coef[4*i + 2]), v, coef[4*i + 1]), u, coef[4*i]);
+            vst1q_f64(out[i] + j, vfmaq_f64(vdupq_n_f64(coef[4*i + 3]), p,
+                inv_h));
+        }
+    }
+#endif
+    for (; j < n; j++) {
+        auto xyz = project(x[j] + 0.5*width[j], y[j] + 0.5*height[j],
+            height[j]);
+        for (int i = 0; i < 3; i++) out[i][j] = xyz[i];
+    }
+}
+
+void PixelProjection::project(const float* x, const float* y,
+        const float* width, const float* height, std::size_t n,
+        float* out_x, float* out_y, float* out_z) const {
+    float* out[3] = {out_x, out_y, out_z};
+    std::size_t j = 0;
+#if defined(__AVX2__) && defined(__FMA__)
+    const __m256 half = _mm256_set1_ps(0.5f);
+    for (; j + 8 <= n; j += 8) {
+        __m256 h = _mm256_loadu_ps(height + j);
+        __m256 u = _mm256_fmadd_ps(_mm256_loadu_ps(width + j), half,
+            _mm256_loadu_ps(x + j));
+        __m256 v = _mm256_fmadd_ps(h, half, _mm256_loadu_ps(y + j));
+        __m256 inv_h = _mm256_div_ps(_mm256_set1_ps(1.f), h);
+        for (int i = 0; i < 3; i++) {
+            __m256 p = _mm256_fmadd_ps(_mm256_set1_ps(coef_f[4*i]), u,
+                _mm256_fmadd_ps(_mm256_set1_ps(coef_f[4*i + 1]), v,
+                    _mm256_set1_ps(coef_f[4*i + 2])));
+            _mm256_storeu_ps(out[i] + j, _mm256_fmadd_ps(p, inv_h,
+                _mm256_set1_ps(coef_f[4*i + 3])));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; j + 4 <= n; j += 4) {
+        float32x4_t h = vld1q_f32(height + j);
+        float32x4_t u = vfmaq_n_f32(vld1q_f32(x + j), vld1q_f32(width + j),
+            0.5f);
+        float32x4_t v = vfmaq_n_f32(vld1q_f32(y + j), h, 0.5f);
+        float32x4_t inv_h = vdivq_f32(vdupq_n_f32(1.f), h);
+        for (int i = 0; i < 3; i++) {
+            float32x4_t p = vfmaq_n_f32(vfmaq_n_f32(
+                vdupq_n_f32(coef_f[4*i + 2]), v, coef_f[4*i + 1]), u,
+                coef_f[4*i]);
+            vst1q_f32(out[i] + j, vfmaq_f32(vdupq_n_f32(coef_f[4*i + 3]), p,
+                inv_h));
+        }
+    }
+#endif
+    for (; j < n; j++) {
+        float u = x[j] + 0.5f*width[j];
+        float v = y[j] + 0.5f*height[j];
+        for (int i = 0; i < 3; i++)
+            out[i][j] = (coef_f[4*i]*u + coef_f[4*i + 1]*v +
+                coef_f[4*i + 2])/height[j] + coef_f[4*i + 3];
+    }
+}
@@ -16,8 +16,10 @@
 #include <array>
 #include <vector>
 #include <memory>
+#include <algorithm>
 
 #include "../include/PositionEstimator.hpp"
+#include "../include/StageTimers.hpp"
 
 void PositionEstimator::set_values(double x, double y, double z,
           double pitch, double f, double pix_density,
@@ -27,6 +29,8 @@ void PositionEstimator::set_values(double x, double y, double z,
      cam_pix_density = pix_density;
      avg_human_height = avg_height;
      img_center = {img_w/2.0, img_h/2.0};
+     projection = PixelProjection(cam2robot_transform, f, pix_density,
+          img_center[0], img_center[1], avg_height);
 }
 
 void PositionEstimator::compute_transform_from_xyzp(
@@ -41,31 +45,117 @@ void PositionEstimator::compute_transform_from_xyzp(
 }
 
 double PositionEstimator::approximate_camera_z(const Detection& detection) {
-     return avg_human_height*cam_focal_len*cam_pix_density/detection.height;
+     float u = detection.x + detection.width/2.f;
+     float top = detection.y;
+     float bottom = detection.y + detection.height;
+     double height_z;
+     if (undistortion)
+          height_z = avg_human_height/(undistortion->ray(u, bottom)[1] -
+               undistortion->ray(u, top)[1]);
+     else
+          height_z = avg_human_height*cam_focal_len*cam_pix_density/
+               detection.height;
+     return fused_camera_z(height_z, u, top, bottom);
+}
+
+double PositionEstimator::fused_camera_z(double height_z, float u, float top,
+          float bottom) const {
+     if (!ground) return height_z;
+     double ground_inv_z = undistortion ?
+          ground->inverse_range_from_ray(undistortion->ray(u, bottom)[1]) :
+          ground->inverse_range(bottom);
+     return 1/ground->fuse_inverse(1/height_z, ground_inv_z, top, bottom);
 }
 
 std::array<double, 3> PositionEstimator::estimate_xyz(
           const Detection& detection) {
-     auto camera_z = approximate_camera_z(detection);
+     if (undistortion)
+          return estimate_undistorted_xyz(detection.x + detection.width/2.f,
+               detection.y, detection.y + detection.height);
+
      double middle_detection_x = detection.x + detection.width/2;
      double middle_detection_y = detection.y + detection.height/2;
-
-     double camz_over_fxdensity = camera_z/(cam_focal_len*cam_pix_density);
-     double camera_x = (middle_detection_x - img_center[0])*camz_over_fxdensity;
-     double camera_y = (middle_detection_y - img_center[1])*camz_over_fxdensity;
-
-     Eigen::Vector4d camera_frame;
-     camera_frame << camera_x, camera_y, camera_z, 1;
-     auto rob_frame = cam2robot_transform*camera_frame;
-     return std::array<double, 3>{rob_frame[0], rob_frame[1], rob_frame[2]};
+     if (ground) {
+          // The projection takes depth as the box height a person at that
+          // depth would have.
+          double focal_px = cam_focal_len*cam_pix_density;
+          return projection.project(middle_detection_x, middle_detection_y,
+               avg_human_height*focal_px/approximate_camera_z(detection));
+     }
+     return projection.project(middle_detection_x, middle_detection_y,
+          detection.height);
 }
 
 std::shared_ptr<std::vector<std::array<double, 3> > >
           PositionEstimator::estimate_all_xyz(
           const std::vector<Detection>& detections) {
      auto all_xyz = std::make_shared<std::vector<std::array<double, 3> > >();
+     estimate_all_xyz(detections, all_xyz.get());
+     return all_xyz;
+}
+
+void PositionEstimator::estimate_all_xyz(
+          const std::vector<Detection>& detections,
+          std::vector<std::array<double, 3> >* all_xyz) {
+     STAGE_TIMER(timers, Stage::ESTIMATE_XYZ);
+     all_xyz->clear();
      for (const auto& detection : detections)
           all_xyz->push_back(estimate_xyz(detection));
+}
 
-     return all_xyz;
+void PositionEstimator::estimate_all_xyz(const DetectionBatch& batch,
+          std::vector<std::array<double, 3> >* all_xyz) {
+     STAGE_TIMER(timers, Stage::ESTIMATE_XYZ);
+     const std::size_t n = batch.size();
+     all_xyz->resize(n);
+     if (undistortion) {
+          for (std::size_t i = 0; i < n; i++)
+               (*all_xyz)[i] = estimate_undistorted_xyz(
+                    batch.x()[i] + 0.5f*batch.width()[i], batch.y()[i],
+                    batch.y()[i] + batch.height()[i]);
+          return;
+     }
+
+     // Project a chunk into stack arrays, then interleave into all_xyz.
+     constexpr std::size_t chunk = 256;
+     double x[chunk], y[chunk], z[chunk];
+     float fused_top[chunk], fused_height[chunk];
+     const double focal_px = cam_focal_len*cam_pix_density;
+     for (std::size_t start = 0; start < n; start += chunk) {
+          std::size_t count = std::min(chunk, n - start);
+          const float* top = batch.y() + start;
+          const float* height = batch.height() + start;
+          if (ground) {
+               // Replace each box by one of the height a person at the fused
+               // depth would have, about the same center.
+               ground->fuse_heights(top, height, count, static_cast<float>(
+                    avg_human_height*focal_px), fused_top, fused_height);
+               top = fused_top;
+               height = fused_height;
+          }
+          projection.project(batch.x() + start, top, batch.width() + start,
+               height, count, x, y, z);
+          for (std::size_t i = 0; i < count; i++)
+               (*all_xyz)[start + i] = {x[i], y[i], z[i]};
+     }
+}
+
+std::array<double, 3> PositionEstimator::estimate_undistorted_xyz(float u,
+          float top, float bottom) const {
+     auto top_ray = undistortion->ray(u, top);
+     auto bottom_ray = undistortion->ray(u, bottom);
+     // A standing person is at one depth, so the rays through their top
+     // and bottom span AVG_HUMAN_HEIGHT there, and their center is the
+     // midpoint of the rays.
+     double camera_z = avg_human_height/(bottom_ray[1] - top_ray[1]);
+     if (ground)
+          camera_z = 1/ground->fuse_inverse(1/camera_z,
+               ground->inverse_range_from_ray(bottom_ray[1]), top, bottom);
+     double camera_x = 0.5*(top_ray[0] + bottom_ray[0])*camera_z;
+     double camera_y = 0.5*(top_ray[1] + bottom_ray[1])*camera_z;
+
+     const auto& t = cam2robot_transform;
+     return {t(0, 0)*camera_x + t(0, 1)*camera_y + t(0, 2)*camera_z + t(0, 3),
+          t(1, 0)*camera_x + t(1, 1)*camera_y + t(1, 2)*camera_z + t(1, 3),
+          t(2, 0)*camera_x + t(2, 1)*camera_y + t(2, 2)*camera_z + t(2, 3)};
 }
@@ -0,0 +1,123 @@
+/**
+ * @file ResolutionController.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Resolution Controller definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../include/utils.hpp"
+#include "../include/ResolutionController.hpp"
+
+constexpr double ResolutionController::smoothing;
+const int ResolutionController::settle_frames;
+constexpr double ResolutionController::headroom;
+
+namespace {
+
+/**
+ * @brief Candidate widths from the min, max and step parameters
+ * 
+ */
+std::vector<int> make_widths(
+        const std::unordered_map<std::string, double>& robot_params) {
+    int width = static_cast<int>(robot_params.at("IMG_WIDTH_REQ"));
+    int min_width = static_cast<int>(get_param(robot_params,
+        "ADAPTIVE_MIN_WIDTH", width));
+    int max_width = static_cast<int>(get_param(robot_params,
+        "ADAPTIVE_MAX_WIDTH", width));
+    int step = std::max(32, static_cast<int>(get_param(robot_params,
+        "ADAPTIVE_WIDTH_STEP", 96)));
+
+    std::vector<int> widths;
+    for (int w = min_width; w <= max_width; w += step) widths.push_back(w);
+    return widths;
+}
+
+}  // namespace
+
+ResolutionController::ResolutionController(const std::vector<int>& _widths,
+        double _aspect, double _target_ms, int start_width) :
+        widths{_widths}, aspect{_aspect}, target_ms{_target_ms} {
+    if (widths.empty())
+        throw std::invalid_argument("Adaptive resolution needs at least one"
+            " input width.");
+    if (target_ms <= 0 || aspect <= 0)
+        throw std::invalid_argument("Latency target and aspect must be"
+            " positive.");
+    for (int width : widths)
+        if (width <= 0 || width % 32)
+            throw std::invalid_argument("Input widths must be positive"
+                " multiples of 32.");
+    std::sort(widths.begin(), widths.end());
+
+    current = 0;
+    for (std::size_t i = 1; i < widths.size(); i++)
+        if (std::abs(widths[i] - start_width) <
+                std::abs(widths[current] - start_width))
+            current = i;
+
+    stats.widths = widths;
+    stats.frames_at_size.assign(widths.size(), 0);
+    stats.ms_at_size.assign(widths.size(), 0);
+}
+
+ResolutionController::ResolutionController(
+        const std::unordered_map<std::string, double>& robot_params) :
+        ResolutionController(make_widths(robot_params),
+            robot_params.at("IMG_HEIGHT_REQ")/robot_params.at("IMG_WIDTH_REQ"),
+            get_param(robot_params, "LATENCY_TARGET", 100),
+            static_cast<int>(robot_params.at("IMG_WIDTH_REQ"))) {}
+
+void ResolutionController::change_to(std::size_t idx) {
+    // Predict the latency at the new size from its pixel count.
+    double area_ratio = std::pow(widths[idx]/static_cast<double>(
+        widths[current]), 2);
+    average_ms *= area_ratio;
+    current = idx;
+    frames_since_change = 0;
+    stats.changes++;
+}
+
+bool ResolutionController::record(double ms) {
+    stats.frames_at_size[current]++;
+    stats.ms_at_size[current] += ms;
+
+    average_ms = average_ms == 0 ? ms :
+        (1 - smoothing)*average_ms + smoothing*ms;
+    if (++frames_since_change < settle_frames) return false;
+
+    if (average_ms > target_ms && current > 0) {
+        change_to(current - 1);
+        return true;
+    }
+    if (current + 1 < widths.size()) {
+        double area_ratio = std::pow(widths[current + 1]/static_cast<double>(
+            widths[current]), 2);
+        if (average_ms*area_ratio < headroom*target_ms) {
+            change_to(current + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::array<int, 2> ResolutionController::get_input_size() const {
+    int width = widths[current];
+    int height = std::max(32, static_cast<int>(std::lround(
+        width*aspect/32))*32);
+    return {{width, height}};
+}
@@ -0,0 +1,176 @@
+/**
+ * @file StageTimers.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Per-stage latency timers definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cstdio>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <exception>
+#include <functional>
+
+#include "../include/StageTimers.hpp"
+#include "../include/utils.hpp"
+
+namespace {
+
+/**
+ * @brief Writes a file next to its path, then renames it over the path
+ * 
+ */
+void write_atomically(const std::string& path,
+        const std::function<void(std::ostream&)>& write) {
+    if (path.empty()) return;
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path.c_str());
+        if (!out) throw InvalidFile("Cannot write " + tmp_path);
+        write(out);
+        out.flush();
+        if (!out) throw InvalidFile("Cannot write " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+        throw InvalidFile("Cannot replace " + path);
+}
+
+}  // namespace
+
+const int StageTimers::num_stages;
+
+StageTimers::~StageTimers() {
+    try {
+        stop_dump();
+    } catch (...) {}
+}
+
+const char* StageTimers::stage_name(Stage stage) {
+    switch (stage) {
+    case Stage::PREP_FRAME:
+        return "prep_frame";
+    case Stage::BLOB:
+        return "blob";
+    case Stage::FORWARD:
+        return "forward";
+    case Stage::DECODE:
+        return "decode";
+    case Stage::NMS:
+        return "nms";
+    case Stage::ESTIMATE_XYZ:
+        return "estimate_xyz";
+    case Stage::FRAME:
+        return "frame";
+    }
+    return "unknown";
+}
+
+void StageTimers::reset() {
+    for (auto& histogram : histograms) histogram.reset();
+}
+
+void StageTimers::write_json(std::ostream& out) const {
+    out << "{\n  \"stages\": {";
+    for (int i = 0; i < num_stages; i++) {
+        Stage stage = static_cast<Stage>(i);
+        LatencySummary s = summary(stage);
+        out << (i ? ",\n" : "\n") << "    \"" << stage_name(stage)
+            << "\": {\"count\": " << s.count << ", \"mean_ms\": " << s.mean_ms
+            << ", \"p50_ms\": " << s.p50_ms << ", \"p90_ms\": " << s.p90_ms
+            << ", \"p99_ms\": " << s.p99_ms << ", \"max_ms\": " << s.max_ms
+            << "}";
+    }
+    out << "\n  }\n}\n";
+}
+
+void StageTimers::write_prometheus(std::ostream& out) const {
+    const char* name = "vision_stage_latency_seconds";
+    LatencySummary summaries[num_stages];
+    for (int i = 0; i < num_stages; i++)
+        summaries[i] = summary(static_cast<Stage>(i));
+
+    out << "# HELP " << name << " Latency of each stage of a frame.\n"
+        << "# TYPE " << name << " summary\n";
+    for (int i = 0; i < num_stages; i++) {
+        const LatencySummary& s = summaries[i];
+        std::string label = std::string("stage=\"") +
+            stage_name(static_cast<Stage>(i)) + "\"";
+        out << name << "{" << label << ",quantile=\"0.5\"} " << s.p50_ms/1e3
+            << "\n" << name << "{" << label << ",quantile=\"0.9\"} "
+            << s.p90_ms/1e3 << "\n" << name << "{" << label
+            << ",quantile=\"0.99\"} " << s.p99_ms/1e3 << "\n"
+            << name << "_sum{" << label << "} " << s.mean_ms*s.count/1e3
+            << "\n" << name << "_count{" << label << "} " << s.count << "\n";
+    }
+    out << "# HELP vision_stage_latency_max_seconds Slowest run of each "
+        "stage of a frame.\n"
+        << "# TYPE vision_stage_latency_max_seconds gauge\n";
+    for (int i = 0; i < num_stages; i++)
+        out << "vision_stage_latency_max_seconds{stage=\""
+            << stage_name(static_cast<Stage>(i)) << "\"} "
+            << summaries[i].max_ms/1e3 << "\n";
+}
+
+void StageTimers::dump(const std::string& _json_path,
+        const std::string& _prometheus_path) const {
+    write_atomically(_json_path, [this](std::ostream& out) {
+        write_json(out);
+    });
+    write_atomically(_prometheus_path, [this](std::ostream& out) {
+        write_prometheus(out);
+    });
+}
+
+void StageTimers::dump_loop() {
+    std::unique_lock<std::mutex> lock(dump_mtx);
+    while (true) {
+        bool stopping = dump_cv.wait_for(lock, dump_interval,
+            [this]() { return !dumping; });
+        try {
+            dump(json_path, prometheus_path);
+        } catch (...) {
+            if (!dump_error) dump_error = std::current_exception();
+        }
+        if (stopping) return;
+    }
+}
+
+void StageTimers::start_dump(const std::string& _json_path,
+        const std::string& _prometheus_path,
+        std::chrono::milliseconds interval) {
+    if (interval.count() <= 0)
+        throw std::invalid_argument("Dump interval must be positive.");
+    stop_dump();
+    std::lock_guard<std::mutex> lock(dump_mtx);
+    json_path = _json_path;
+    prometheus_path = _prometheus_path;
+    dump_interval = interval;
+    dumping = true;
+    dump_thread = std::thread(&StageTimers::dump_loop, this);
+}
+
+void StageTimers::stop_dump() {
+    {
+        std::lock_guard<std::mutex> lock(dump_mtx);
+        dumping = false;
+    }
+    dump_cv.notify_all();
+    if (dump_thread.joinable()) dump_thread.join();
+
+    std::lock_guard<std::mutex> lock(dump_mtx);
+    if (dump_error) {
+        auto error = dump_error;
+        dump_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
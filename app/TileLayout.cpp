@@ -0,0 +1,79 @@
+/**
+ * @file TileLayout.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Tile Layout definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/TileLayout.hpp"
+
+TileLayout::TileLayout(double _band_top, double _band_bottom,
+        double _overlap, const cv::Size& _tile_size) :
+        band_top{_band_top}, band_bottom{_band_bottom}, overlap{_overlap},
+        tile_size{_tile_size} {
+    if (band_top < 0 || band_bottom > 1 || band_bottom <= band_top)
+        throw std::invalid_argument("Tile band must satisfy 0 <= top < bottom"
+            " <= 1.");
+    if (overlap < 0 || overlap >= 1)
+        throw std::invalid_argument("Tile overlap must be in [0, 1).");
+    if (tile_size.width <= 0 || tile_size.height <= 0)
+        throw std::invalid_argument("Tile size must be positive.");
+}
+
+TileLayout::TileLayout(
+        const std::unordered_map<std::string, double>& robot_params) :
+        TileLayout(get_param(robot_params, "TILE_BAND_TOP", 0),
+            get_param(robot_params, "TILE_BAND_BOTTOM", 0.5),
+            get_param(robot_params, "TILE_OVERLAP", 0.2),
+            cv::Size(static_cast<int>(robot_params.at("IMG_WIDTH_REQ")),
+                static_cast<int>(robot_params.at("IMG_HEIGHT_REQ")))) {}
+
+std::vector<int> TileLayout::tile_starts(int begin, int end, int tile_len,
+        int frame_len) const {
+    std::vector<int> starts;
+    int len = end - begin;
+    if (len <= tile_len) {
+        // One tile, shifted back inside the frame if the range is at its end.
+        starts.push_back(std::max(0, std::min(begin, frame_len - tile_len)));
+        return starts;
+    }
+
+    double stride = tile_len*(1 - overlap);
+    int num_tiles = static_cast<int>(std::ceil((len - tile_len)/stride)) + 1;
+    for (int i = 0; i < num_tiles; i++)
+        starts.push_back(begin + static_cast<int>(std::lround(
+            static_cast<double>(i)*(len - tile_len)/(num_tiles - 1))));
+    return starts;
+}
+
+const std::vector<cv::Rect>& TileLayout::get_tiles(const cv::Size& frame) {
+    if (frame == frame_size) return tiles;
+    frame_size = frame;
+    tiles.clear();
+    if (frame.width <= 0 || frame.height <= 0) return tiles;
+
+    int tile_w = std::min(tile_size.width, frame.width);
+    int tile_h = std::min(tile_size.height, frame.height);
+    int top = static_cast<int>(std::floor(band_top*frame.height));
+    int bottom = std::max(top + 1,
+        static_cast<int>(std::ceil(band_bottom*frame.height)));
+
+    for (int y : tile_starts(top, bottom, tile_h, frame.height))
+        for (int x : tile_starts(0, frame.width, tile_w, frame.width))
+            tiles.emplace_back(x, y, tile_w, tile_h);
+    return tiles;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file UndistortionTable.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Lens undistortion lookup table definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../include/utils.hpp"
+#include "../include/UndistortionTable.hpp"
+
+CameraIntrinsics::CameraIntrinsics(
+        const std::unordered_map<std::string, double>& robot_params) {
+    width = static_cast<int>(robot_params.at("CAM_IMG_WIDTH"));
+    height = static_cast<int>(robot_params.at("CAM_IMG_HEIGHT"));
+    fx = robot_params.at("CAM_FX");
+    fy = robot_params.at("CAM_FY");
+    cx = get_param(robot_params, "CAM_CX", width/2.0);
+    cy = get_param(robot_params, "CAM_CY", height/2.0);
+    distortion = {{get_param(robot_params, "CAM_K1", 0),
+        get_param(robot_params, "CAM_K2", 0),
+        get_param(robot_params, "CAM_P1", 0),
+        get_param(robot_params, "CAM_P2", 0),
+        get_param(robot_params, "CAM_K3", 0)}};
+    if (width <= 0 || height <= 0 || fx <= 0 || fy <= 0)
+        throw std::invalid_argument("Camera intrinsics need a positive "
+            "image size and focal lengths.");
+}
+
+std::array<double, 2> CameraIntrinsics::distort(double x, double y) const {
+    const double k1 = distortion[0], k2 = distortion[1], p1 = distortion[2],
+        p2 = distortion[3], k3 = distortion[4];
+    double r2 = x*x + y*y;
+    double radial = 1 + ((k3*r2 + k2)*r2 + k1)*r2;
+    double xd = x*radial + 2*p1*x*y + p2*(r2 + 2*x*x);
+    double yd = y*radial + p1*(r2 + 2*y*y) + 2*p2*x*y;
+    return {{fx*xd + cx, fy*yd + cy}};
+}
+
+std::array<double, 2> CameraIntrinsics::undistort(double u, double v) const {
+    const double k1 = distortion[0], k2 = distortion[1], p1 = distortion[2],
+        p2 = distortion[3], k3 = distortion[4];
+    const double x0 = (u - cx)/fx;
+    const double y0 = (v - cy)/fy;
+    double x = x0, y = y0;
+    // Wide-angle lenses converge more slowly than the 5 iterations
+    // cv::undistortPoints defaults to; this only runs at startup.
+    for (int i = 0; i < 20; i++) {
+        double r2 = x*x + y*y;
+        double inv_radial = 1/(1 + ((k3*r2 + k2)*r2 + k1)*r2);
+        double dx = 2*p1*x*y + p2*(r2 + 2*x*x);
+        double dy = p1*(r2 + 2*y*y) + 2*p2*x*y;
+        x = (x0 - dx)*inv_radial;
+        y = (y0 - dy)*inv_radial;
+    }
+    return {{x, y}};
+}
+
+UndistortionTable::UndistortionTable(const CameraIntrinsics& intrinsics,
+        int img_w, int img_h, int _step) : step{_step} {
+    if (img_w <= 0 || img_h <= 0 || step <= 0)
+        throw std::invalid_argument("Undistortion table needs a positive "
+            "frame size and step.");
+    scale_x = static_cast<float>(intrinsics.width)/img_w;
+    scale_y = static_cast<float>(intrinsics.height)/img_h;
+    cols = (img_w + step - 1)/step + 1;
+    rows = (img_h + step - 1)/step + 1;
+    ray_x.resize(static_cast<std::size_t>(cols)*rows);
+    ray_y.resize(ray_x.size());
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            auto ray = intrinsics.undistort(c*step*scale_x, r*step*scale_y);
+            std::size_t idx = static_cast<std::size_t>(r)*cols + c;
+            ray_x[idx] = static_cast<float>(ray[0]);
+            ray_y[idx] = static_cast<float>(ray[1]);
+        }
+    }
+}
+
+std::array<float, 2> UndistortionTable::ray(float u, float v) const {
+    float gx = std::min(std::max(u/step, 0.f), cols - 1.f);
+    float gy = std::min(std::max(v/step, 0.f), rows - 1.f);
+    int c = std::min(static_cast<int>(gx), cols - 2);
+    int r = std::min(static_cast<int>(gy), rows - 2);
+    float fx = gx - c;
+    float fy = gy - r;
+
+    std::size_t i00 = static_cast<std::size_t>(r)*cols + c;
+    std::size_t i10 = i00 + cols;
+    auto lerp2 = [&](const std::vector<float>& t) {
+        float top = t[i00] + fx*(t[i00 + 1] - t[i00]);
+        float bottom = t[i10] + fx*(t[i10 + 1] - t[i10]);
+        return top + fy*(bottom - top);
+    };
+    return {{lerp2(ray_x), lerp2(ray_y)}};
+}
@@ -11,6 +11,9 @@
  */
 
 #include <math.h>
+#include <chrono>
+#include <limits>
+#include <string>
 #include <vector>
 #include <opencv2/opencv.hpp>
 
@@ -19,13 +22,160 @@
 std::shared_ptr<std::vector<std::array<double, 3> > >
     VisionAPI::get_xyz(
         const cv::Mat&  orig_frame, bool show_detection) {
+    auto all_xyz = std::make_shared<std::vector<std::array<double, 3> > >();
+    bool inferred = get_xyz(orig_frame, all_xyz.get());
+
+    if (show_detection && inferred) {
+        if (!annotations) start_annotations();
+        annotations->submit(orig_frame.clone(),
+            std::make_shared<std::vector<Detection> >(detection_buffer));
+    }
+    return all_xyz;
+}
+
+bool VisionAPI::get_xyz(const cv::Mat& orig_frame,
+        std::vector<std::array<double, 3> >* all_xyz) {
+    frame_arrival = std::chrono::steady_clock::now();
+    return infer_xyz(orig_frame, all_xyz);
+}
+
+bool VisionAPI::infer_xyz(const cv::Mat& orig_frame,
+        std::vector<std::array<double, 3> >* all_xyz) {
+    STAGE_TIMER(timers.get(), Stage::FRAME);
+    if (motion_gate_on && !gate.should_infer(orig_frame) && has_last_xyz) {
+        *all_xyz = last_xyz;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (tracking_mode)
+        detection_buffer = *detect_tracked(orig_frame);
+    else if (tiled_input)
+        detection_buffer = *detector.detect_tiled(orig_frame);
+    else
+        detector.detect_frame(orig_frame, &detection_buffer);
+    estimator.estimate_all_xyz(detection_buffer, all_xyz);
+    double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    if (motion_gate_on) {
+        gate.record_inference_ms(ms);
+        last_xyz = *all_xyz;
+        has_last_xyz = true;
+    }
+    if (adaptive_resolution && resolution.record(ms)) {
+        auto size = resolution.get_input_size();
+        detector.set_input_size(size[0], size[1]);
+    }
+    return true;
+}
+
+bool VisionAPI::get_xyz(FrameSource* source,
+        std::vector<std::array<double, 3> >* all_xyz, double* timestamp,
+        bool show_detection) {
+    if (!source->read(&source_frame, timestamp, &frame_arrival))
+        return false;
+    bool inferred = infer_xyz(source_frame, all_xyz);
+
+    // The source decodes into this buffer again, so the sink gets a copy
+    if (show_detection && inferred) {
+        if (!annotations) start_annotations();
+        annotations->submit(source_frame.clone(),
+            std::make_shared<std::vector<Detection> >(detection_buffer));
+    }
+    return true;
+}
+
+bool VisionAPI::get_rig_xyz(const std::vector<cv::Mat>& frames,
+        std::vector<std::array<double, 3> >* all_xyz) {
+    if (!rig) return false;
+    frame_arrival = std::chrono::steady_clock::now();
+    if (DnnEngine::get_target(robot_params) != cv::dnn::DNN_TARGET_CPU) {
+        rig->get_xyz(&detector, frames, all_xyz);
+        return true;
+    }
+
+    if (!rig_pool) {
+        rig_pool.reset(new DetectorPool(robot_params, coco_name_path,
+            yolo_cfg_path, yolo_weight_path, rig->size()));
+        rig_pool->set_stage_timers(timers.get());
+    }
+    rig->get_xyz(rig_pool.get(), frames, all_xyz);
+    return true;
+}
+
+bool VisionAPI::track_people(
+        const std::vector<std::array<double, 3> >& all_xyz, double timestamp,
+        std::vector<PersonTrack>* tracks) {
+    if (!people) return false;
+    people->update(all_xyz, timestamp, tracks);
+    return true;
+}
+
+std::shared_ptr<std::vector<Detection> > VisionAPI::detect_tracked(
+        const cv::Mat& orig_frame) {
     auto prep_img = detector.prep_frame(orig_frame);
-    auto detected = detector.detect(*prep_img, show_detection);
-    if (show_detection) {
-        cv::imshow("Frame", *prep_img);
+    cv::cvtColor(*prep_img, track_gray, cv::COLOR_BGR2GRAY);
+
+    auto detected = std::make_shared<std::vector<Detection> >();
+    if (tracker.needs_keyframe() ||
+            !tracker.track(track_gray, detected.get())) {
+        detected = tiled_input ? detector.detect_tiled(orig_frame) :
+            detector.detect(*prep_img);
+        tracker.reset(track_gray, *detected);
     }
-    auto ret = estimator.estimate_all_xyz(*detected);
-    return ret;
+    return detected;
+}
+
+void VisionAPI::start_annotations(AnnotationSink::Output output,
+        std::size_t capacity) {
+    annotations.reset();
+    annotations.reset(new AnnotationSink(detector.get_img_dims(),
+        std::move(output), capacity));
+}
+
+void VisionAPI::stop_annotations() {
+    if (!annotations) return;
+    annotations->finish();
+    annotations.reset();
+}
+
+void VisionAPI::start_stream(std::size_t queue_capacity) {
+    pipeline.reset();
+    pipeline.reset(new VisionPipeline(&detector, &estimator,
+        queue_capacity));
+}
+
+bool VisionAPI::push_frame(const cv::Mat& img) {
+    if (!pipeline) return false;
+    return pipeline->push(img);
+}
+
+bool VisionAPI::pop_xyz(
+        std::shared_ptr<std::vector<std::array<double, 3> > >* all_xyz) {
+    if (!pipeline) return false;
+    return pipeline->pop(all_xyz);
+}
+
+void VisionAPI::finish_stream() {
+    if (pipeline) pipeline->finish();
+}
+
+void VisionAPI::stop_stream() {
+    pipeline.reset();
+}
+
+bool VisionAPI::start_stage_dump(const std::string& json_path,
+        const std::string& prometheus_path) {
+    if (!timers) return false;
+    double interval = get_param(robot_params, "STAGE_DUMP_INTERVAL", 10);
+    timers->start_dump(json_path, prometheus_path,
+        std::chrono::milliseconds(static_cast<long>(1000*interval)));
+    return true;
+}
+
+PipelineStats VisionAPI::get_stream_stats() {
+    if (!pipeline) return PipelineStats{};
+    return pipeline->get_stats();
 }
 
 double VisionAPI::calculate_distance(std::array<double, 3> xyz) {
@@ -57,3 +207,57 @@ void VisionAPI::print_alerts(
     }
 }
 
+void VisionAPI::print_alerts(const std::vector<PersonTrack> &tracks) {
+    std::vector<std::array<double, 3> > all_xyz;
+    for (const auto& track : tracks) all_xyz.push_back(track.xyz);
+    print_alerts(all_xyz);
+}
+
+AlertEvent VisionAPI::publish_closest(const std::array<double, 3>* closest,
+        std::uint64_t track_id, std::size_t people, double timestamp) {
+    AlertEvent event;
+    event.people = static_cast<std::uint32_t>(people);
+    event.frame_timestamp = timestamp;
+    event.arrival_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        frame_arrival.time_since_epoch()).count();
+    event.min_distance = std::numeric_limits<double>::infinity();
+    if (closest) {
+        event.xyz = *closest;
+        event.track_id = track_id;
+        event.min_distance = calculate_distance(*closest);
+    }
+    event.level = AlertBus::classify(event.min_distance,
+        alert_thresholds[0], alert_thresholds[1]);
+    event.sequence = alerts.publish(event);
+    return event;
+}
+
+AlertEvent VisionAPI::publish_alerts(
+        const std::vector<std::array<double, 3> >& all_xyz,
+        double timestamp) {
+    const std::array<double, 3>* closest = nullptr;
+    double min_distance = 0;
+    for (const auto& xyz : all_xyz) {
+        double distance = calculate_distance(xyz);
+        if (!closest || distance < min_distance) {
+            closest = &xyz;
+            min_distance = distance;
+        }
+    }
+    return publish_closest(closest, 0, all_xyz.size(), timestamp);
+}
+
+AlertEvent VisionAPI::publish_alerts(const std::vector<PersonTrack>& tracks,
+        double timestamp) {
+    const PersonTrack* closest = nullptr;
+    double min_distance = 0;
+    for (const auto& track : tracks) {
+        double distance = calculate_distance(track.xyz);
+        if (!closest || distance < min_distance) {
+            closest = &track;
+            min_distance = distance;
+        }
+    }
+    return publish_closest(closest ? &closest->xyz : nullptr,
+        closest ? closest->id : 0, tracks.size(), timestamp);
+}
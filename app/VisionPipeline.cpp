@@ -0,0 +1,137 @@
+/**
+ * @file VisionPipeline.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Vision Pipeline definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <opencv2/opencv.hpp>
+
+#include "../include/VisionPipeline.hpp"
+
+VisionPipeline::VisionPipeline(HumanDetector* _detector,
+        PositionEstimator* _estimator, std::size_t queue_capacity) :
+        detector{*_detector}, estimator{*_estimator},
+        input_queue{queue_capacity}, preprocessed_queue{queue_capacity},
+        inferred_queue{queue_capacity}, output_queue{queue_capacity} {
+    workers.emplace_back(&VisionPipeline::preprocess_loop, this);
+    workers.emplace_back(&VisionPipeline::infer_loop, this);
+    workers.emplace_back(&VisionPipeline::estimate_loop, this);
+}
+
+VisionPipeline::~VisionPipeline() {
+    abort(nullptr);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void VisionPipeline::abort(std::exception_ptr error) {
+    if (error) {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        if (!worker_error) worker_error = error;
+    }
+    input_queue.close();
+    preprocessed_queue.close();
+    inferred_queue.close();
+    output_queue.close();
+}
+
+void VisionPipeline::preprocess_loop() {
+    try {
+        cv::Mat frame;
+        while (input_queue.pop(&frame)) {
+            if (!preprocessed_queue.push(detector.make_blob(frame))) break;
+        }
+        preprocessed_queue.close();
+    } catch (...) {
+        abort(std::current_exception());
+    }
+}
+
+void VisionPipeline::infer_loop() {
+    try {
+        cv::Mat blob;
+        while (preprocessed_queue.pop(&blob)) {
+            if (!inferred_queue.push(detector.infer(blob))) break;
+        }
+        inferred_queue.close();
+    } catch (...) {
+        abort(std::current_exception());
+    }
+}
+
+void VisionPipeline::estimate_loop() {
+    try {
+        std::vector<cv::Mat> outputs;
+        while (inferred_queue.pop(&outputs)) {
+            auto detections = detector.parse_detections(outputs);
+            if (!output_queue.push(estimator.estimate_all_xyz(*detections)))
+                break;
+        }
+        output_queue.close();
+    } catch (...) {
+        abort(std::current_exception());
+    }
+}
+
+bool VisionPipeline::push(const cv::Mat& frame) {
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        if (frames_in == 0)
+            first_frame_time = std::chrono::steady_clock::now();
+    }
+    // Callers commonly reuse their frame buffer, so queue a private copy.
+    if (!input_queue.push(frame.clone())) return false;
+
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    frames_in++;
+    return true;
+}
+
+bool VisionPipeline::pop(
+        std::shared_ptr<std::vector<std::array<double, 3> > >* all_xyz) {
+    bool popped = output_queue.pop(all_xyz);
+
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    if (popped) {
+        frames_out++;
+        last_result_time = std::chrono::steady_clock::now();
+    } else if (worker_error) {
+        std::rethrow_exception(worker_error);
+    }
+    return popped;
+}
+
+void VisionPipeline::finish() {
+    input_queue.close();
+}
+
+PipelineStats VisionPipeline::get_stats() {
+    PipelineStats stats;
+    stats.queue_depth = {input_queue.size(), preprocessed_queue.size(),
+        inferred_queue.size(), output_queue.size()};
+    stats.max_queue_depth = {input_queue.get_max_depth(),
+        preprocessed_queue.get_max_depth(), inferred_queue.get_max_depth(),
+        output_queue.get_max_depth()};
+
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    stats.frames_in = frames_in;
+    stats.frames_out = frames_out;
+    double elapsed = std::chrono::duration<double>(
+        last_result_time - first_frame_time).count();
+    if (frames_out > 0 && elapsed > 0)
+        stats.throughput_fps = frames_out/elapsed;
+    return stats;
+}
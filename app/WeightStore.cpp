@@ -0,0 +1,54 @@
+/**
+ * @file WeightStore.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Weight Store definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "../include/WeightStore.hpp"
+
+std::mutex WeightStore::mtx;
+std::map<std::pair<std::string, std::string>,
+    std::weak_ptr<const DarknetModel> > WeightStore::models;
+
+std::shared_ptr<const DarknetModel> WeightStore::get(
+        const std::string& cfg_path, const std::string& weight_path) {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto key = std::make_pair(cfg_path, weight_path);
+    auto it = models.find(key);
+    if (it != models.end()) {
+        auto model = it->second.lock();
+        if (model) return model;
+    }
+
+    auto model = std::make_shared<const DarknetModel>(cfg_path, weight_path);
+    models[key] = model;
+    return model;
+}
+
+void WeightStore::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    models.clear();
+}
+
+std::size_t WeightStore::size() {
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto it = models.begin(); it != models.end();) {
+        if (it->second.expired())
+            it = models.erase(it);
+        else
+            ++it;
+    }
+    return models.size();
+}
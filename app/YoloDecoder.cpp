@@ -0,0 +1,91 @@
+/**
+ * @file YoloDecoder.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief YOLO Decoder definition
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <cmath>
+#include <array>
+#include <limits>
+#include <vector>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../include/utils.hpp"
+#include "../include/YoloDecoder.hpp"
+
+YoloDecoder::YoloDecoder(const std::vector<std::string>& class_names,
+        double _threshold) : threshold{_threshold},
+        prefilter_threshold{static_cast<float>(_threshold)} {
+    if (prefilter_threshold > threshold)
+        prefilter_threshold = std::nextafter(prefilter_threshold,
+            -std::numeric_limits<float>::infinity());
+    for (std::size_t i = 0; i < class_names.size(); i++) {
+        if (class_names[i] == "person") {
+            person_idx = static_cast<int>(i);
+            break;
+        }
+    }
+    if (person_idx < 0)
+        throw InvalidFile("No 'person' class found in the class names file.");
+}
+
+void YoloDecoder::decode_row(const float* row, const Letterbox& letterbox,
+        const std::array<int, 2>& img_dim, std::vector<cv::Rect>* boxes,
+        std::vector<float>* scores) const {
+    float confidence = row[5 + person_idx];
+    if (!(confidence > threshold)) return;
+
+    float x = (row[0] - letterbox.offset[0])*letterbox.gain[0];
+    float y = (row[1] - letterbox.offset[1])*letterbox.gain[1];
+    float w = row[2]*letterbox.gain[0];
+    float h = row[3]*letterbox.gain[1];
+    int centerX = static_cast<int>(x * img_dim[0]);
+    int centerY = static_cast<int>(y * img_dim[1]);
+    int width = static_cast<int>(w * img_dim[0]);
+    int height = static_cast<int>(h * img_dim[1]);
+
+    boxes->emplace_back(centerX - width / 2, centerY - height / 2,
+        width, height);
+    scores->push_back(confidence);
+}
+
+void YoloDecoder::decode(const float* data, int rows, int cols,
+        const Letterbox& letterbox, const std::array<int, 2>& img_dim,
+        std::vector<cv::Rect>* boxes, std::vector<float>* scores) const {
+    if (cols <= 5 + person_idx) return;
+
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i row_offsets = _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(cols));
+    const __m256 thresh = _mm256_set1_ps(prefilter_threshold);
+    for (; j + 8 <= rows; j += 8) {
+        const float* block = data + static_cast<std::size_t>(j)*cols;
+        __m256 objectness = _mm256_i32gather_ps(block + 4, row_offsets, 4);
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(objectness, thresh,
+            _CMP_GT_OQ));
+        while (mask) {
+            int bit = __builtin_ctz(mask);
+            decode_row(block + static_cast<std::size_t>(bit)*cols, letterbox,
+                img_dim, boxes, scores);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; j < rows; j++) {
+        const float* row = data + static_cast<std::size_t>(j)*cols;
+        if (row[4] > prefilter_threshold)
+            decode_row(row, letterbox, img_dim, boxes, scores);
+    }
+}
@@ -10,11 +10,13 @@
  * 
  */
 
+#include <array>
 #include <vector>
 #include <iostream>
 #include <opencv2/opencv.hpp>
 
 #include "../include/VisionAPI.hpp"
+#include "../include/FrameSource.hpp"
 #include "../include/params_vec.hpp"
 #include "../include/ParamParser.hpp"
 
@@ -29,6 +31,8 @@ int main() {
     auto ret_params = parser.parse_robot_params(
         "../robot_params/robot_params.txt"
     );
+    // The demo reports its stage latencies
+    ret_params["STAGE_TIMING"] = 1;
 
     VisionAPI vision(ret_params,
                      coco_name_path,
@@ -36,18 +40,50 @@ int main() {
                      yolo_weights_path
     );
 
-    auto img = cv::imread("../dataset/1/1_269.png");
-    auto all_xyz = vision.get_xyz(img, true);
+    // Frames are decoded ahead on the source's thread
+    auto source = FrameSource::directory("../dataset/1", 30);
 
-    for (const auto& one_detect : *all_xyz) {
-        std::cout << "Position of Human: x\t: " 
-                  << one_detect[0] << "\ty: "
-                  << one_detect[1] << "\tz: "
-                  << one_detect[2]
-                  << std::endl;
+    // Alerts are printed on the bus's own thread, off the detection loop
+    vision.get_alert_bus().subscribe(AlertBus::console(std::cout));
+
+    // Stage latencies are written periodically, off the detection loop
+    vision.start_stage_dump("../stage_timings.json", "../stage_timings.prom");
+
+    vector<std::array<double, 3> > all_xyz;
+    double timestamp;
+    cv::Mat annotated;
+    while (vision.get_xyz(source.get(), &all_xyz, &timestamp, true)) {
+        std::cout << "Frame at " << timestamp << " s" << std::endl;
+        for (const auto& one_detect : all_xyz) {
+            std::cout << "Position of Human: x\t: "
+                      << one_detect[0] << "\ty: "
+                      << one_detect[1] << "\tz: "
+                      << one_detect[2]
+                      << std::endl;
+        }
+        vision.publish_alerts(all_xyz, timestamp);
+
+        // Detections are drawn on the sink's thread, the window is shown
+        // from this one
+        if (vision.get_annotated_frame(&annotated)) {
+            cv::imshow("Frame", annotated);
+            cv::waitKey(1);
+        }
     }
+    vision.stop_annotations();
+    vision.get_alert_bus().finish();
 
-    vision.print_alerts(*all_xyz);
+    auto stats = source->get_stats();
+    std::cout << "Decoded " << stats.decoded << " frames at "
+              << stats.decode_fps << " fps" << std::endl;
+    auto latency = vision.get_alert_bus().get_stats().latency;
+    std::cout << "Frame to alert latency: p50 " << latency.p50_ms
+              << " ms, p99 " << latency.p99_ms << " ms" << std::endl;
+    if (auto timers = vision.get_stage_timers()) {
+        timers->stop_dump();
+        timers->write_json(std::cout);
+    }
+    if (!annotated.empty()) cv::imshow("Frame", annotated);
     cv::waitKey(0);
     return 0;
 }
@@ -22,11 +22,60 @@ std::vector<Var> all_params::params = {
     {"AVG_HUMAN_HEIGHT", "m"},
     {"CAM_FOCAL_LEN", "m"},
     {"CAM_PIXEL_DENSITY", "ppm"},
+    {"LENS_UNDISTORT", "bool"},
+    {"CAM_IMG_WIDTH", "px"},
+    {"CAM_IMG_HEIGHT", "px"},
+    {"CAM_FX", "px"},
+    {"CAM_FY", "px"},
+    {"CAM_CX", "px"},
+    {"CAM_CY", "px"},
+    {"CAM_K1", "coefficient"},
+    {"CAM_K2", "coefficient"},
+    {"CAM_P1", "coefficient"},
+    {"CAM_P2", "coefficient"},
+    {"CAM_K3", "coefficient"},
+    {"UNDISTORT_TABLE_STEP", "px"},
+    {"GROUND_RANGE", "bool"},
+    {"CAM_HEIGHT", "m"},
+    {"HUMAN_HEIGHT_STDDEV", "m"},
+    {"FOOT_PIXEL_STDDEV", "px"},
     {"DETECTION_PROBABILITY_THRESHOLD", "fraction"},
     {"SCORE_THRESHOLD", "fraction"},
     {"NMS_THRESHOLD", "fraction"},
+    {"SOFT_NMS_SIGMA", "fraction"},
     {"IMG_WIDTH_REQ", "px"},
     {"IMG_HEIGHT_REQ", "px"},
+    {"LETTERBOX_INPUT", "bool"},
+    {"TILED_INPUT", "bool"},
+    {"TILE_BAND_TOP", "fraction"},
+    {"TILE_BAND_BOTTOM", "fraction"},
+    {"TILE_OVERLAP", "fraction"},
+    {"TRACKING_MODE", "bool"},
+    {"TRACK_MAX_KEYFRAME_INTERVAL", "frames"},
+    {"TRACK_MIN_CONFIDENCE", "fraction"},
+    {"MOTION_GATE", "bool"},
+    {"MOTION_PIXEL_THRESHOLD", "fraction"},
+    {"MOTION_CHANGED_FRACTION", "fraction"},
+    {"MOTION_MAX_SKIPPED", "frames"},
+    {"DNN_BACKEND", "id"},
+    {"DNN_TARGET", "id"},
+    {"INT8_INFERENCE", "bool"},
+    {"INT8_CALIBRATION_FRAMES", "frames"},
+    {"ADAPTIVE_RESOLUTION", "bool"},
+    {"LATENCY_TARGET", "ms"},
+    {"ADAPTIVE_MIN_WIDTH", "px"},
+    {"ADAPTIVE_MAX_WIDTH", "px"},
+    {"ADAPTIVE_WIDTH_STEP", "px"},
+    {"RIG_CAMERAS", "cameras"},
+    {"RIG_MERGE_DISTANCE", "m"},
+    {"PERSON_TRACKING", "bool"},
+    {"PERSON_ACCEL_STDDEV", "m/s^2"},
+    {"PERSON_POSITION_STDDEV", "m"},
+    {"PERSON_GATE_DISTANCE", "m"},
+    {"PERSON_CONFIRM_HITS", "frames"},
+    {"PERSON_MAX_MISSES", "frames"},
+    {"STAGE_TIMING", "bool"},
+    {"STAGE_DUMP_INTERVAL", "s"},
     {"LOW_ALERT_THRESHOLD", "m"},
     {"HIGH_ALERT_THRESHOLD", "m"}
 };
@@ -0,0 +1,62 @@
+/**
+ * @file prune_model.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Writes a person-only copy of the YOLO model
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+#include "../include/DarknetPruner.hpp"
+
+/**
+ * @brief Prunes ../robot_params/yolov4 down to one class ("person" unless
+ * another coco.names entry is given) and writes yolov4-<class>.cfg,
+ * yolov4-<class>.weights and <class>.names next to it.
+ * 
+ */
+int main(int argc, char** argv) {
+    std::string dir = "../robot_params/";
+    std::string keep_name = argc > 1 ? argv[1] : "person";
+
+    std::ifstream names(dir + "coco.names");
+    std::string line;
+    int keep_class = -1;
+    for (int i = 0; getline(names, line); i++) {
+        if (line == keep_name) {
+            keep_class = i;
+            break;
+        }
+    }
+    if (keep_class < 0) {
+        std::cerr << "'" << keep_name << "' is not in " << dir << "coco.names"
+            << std::endl;
+        return 1;
+    }
+
+    try {
+        DarknetPruner pruner(dir + "yolov4.cfg", dir + "yolov4.weights");
+        auto report = pruner.prune(keep_class,
+            dir + "yolov4-" + keep_name + ".cfg",
+            dir + "yolov4-" + keep_name + ".weights");
+        std::ofstream(dir + keep_name + ".names") << keep_name << "\n";
+
+        std::cout << "Pruned " << report.heads << " YOLO heads from "
+            << report.head_filters_before << " to "
+            << report.head_filters_after << " filters. Weights: "
+            << report.weight_bytes_before << " -> "
+            << report.weight_bytes_after << " bytes." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -10,9 +10,13 @@
  * 
  */
 
+#include <unistd.h>
+
 #include <string>
 #include <vector>
 #include <sstream>
+#include <fstream>
+#include <unordered_map>
 
 #include "../include/utils.hpp"
 
@@ -30,3 +34,17 @@ std::vector<std::string> split(const std::string &s, char delim /* =' ' */) {
     split(s, delim, std::back_inserter(elems));
     return elems;
 }
+
+double get_param(const std::unordered_map<std::string, double>& robot_params,
+        const std::string& name, double default_value) {
+    auto it = robot_params.find(name);
+    if (it == robot_params.end()) return default_value;
+    return it->second;
+}
+
+std::size_t resident_memory_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages*static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
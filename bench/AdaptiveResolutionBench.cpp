@@ -0,0 +1,89 @@
+/**
+ * @file AdaptiveResolutionBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Adaptive input resolution benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/ResolutionController.hpp"
+
+void bench::adaptive_resolution_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+
+    std::vector<cv::Mat> frames;
+    for (int i = 231; i <= 506; i++) {
+        std::string path = "../dataset/1/1_" + std::to_string(i) + ".png";
+        if (boost::filesystem::exists(path)) frames.push_back(cv::imread(path));
+    }
+    if (frames.empty()) return;
+
+    // Fixed-size latency, which the controller has to discover.
+    ResolutionController sizes(ret_params);
+    double fastest_ms = 0;
+    for (int width : sizes.get_stats().widths) {
+        detector.set_input_size(width, width);
+        detector.detect_frame(frames[0]);
+        double ms = time_ms([&] {
+            do_not_optimize(detector.detect_frame(frames[0]));
+        }, 5);
+        if (fastest_ms == 0) fastest_ms = ms;
+        std::cout << "input " << width << "x" << width << ":\t" << ms
+            << " ms/frame" << std::endl;
+    }
+
+    // Targets from just above the smallest size to well above the largest.
+    for (double scale : {1.2, 2.0, 4.0}) {
+        double target_ms = scale*fastest_ms;
+        ResolutionController controller(sizes.get_stats().widths, 1,
+            target_ms, static_cast<int>(ret_params.at("IMG_WIDTH_REQ")));
+        auto size = controller.get_input_size();
+        detector.set_input_size(size[0], size[1]);
+
+        std::size_t over_budget = 0;
+        for (const auto& frame : frames) {
+            auto start = std::chrono::steady_clock::now();
+            do_not_optimize(detector.detect_frame(frame));
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            if (ms > target_ms) over_budget++;
+            if (controller.record(ms)) {
+                size = controller.get_input_size();
+                detector.set_input_size(size[0], size[1]);
+            }
+        }
+
+        auto stats = controller.get_stats();
+        std::cout << "target " << target_ms << " ms\tover budget: "
+            << 100.0*over_budget/frames.size() << " %\tchanges: "
+            << stats.changes << "\tframes per size:";
+        for (std::size_t i = 0; i < stats.widths.size(); i++)
+            std::cout << " " << stats.widths[i] << ":"
+                << stats.frames_at_size[i];
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * @file AlertBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Alert publication benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+
+#include "./Benchmarks.hpp"
+#include "../include/AlertBus.hpp"
+
+namespace {
+
+AlertEvent frame_alert(int frame) {
+    AlertEvent event;
+    event.people = 2;
+    event.min_distance = 0.5 + (frame % 40)*0.1;
+    event.level = AlertBus::classify(event.min_distance, 3, 1);
+    event.frame_timestamp = frame/30.0;
+    event.arrival_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return event;
+}
+
+}  // namespace
+
+void bench::alert_bench() {
+    const int frames = 2000;
+    // Frames arrive every 2 ms, faster than any camera, so the cost on the
+    // perception thread is what is measured
+    const auto frame_period = std::chrono::milliseconds(2);
+    std::ofstream log("/dev/null");
+
+    // Before: formatting and flushing every line on the perception thread
+    auto print = AlertBus::console(log);
+    double print_max_us = 0;
+    int frame = 0;
+    double print_us = 1000*time_ms([&]() {
+        auto start = std::chrono::steady_clock::now();
+        AlertEvent event = frame_alert(frame++);
+        print(event);
+        log << std::flush;
+        double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count();
+        if (us > print_max_us) print_max_us = us;
+    }, frames);
+    std::cout << "print on the perception thread:\t" << print_us
+        << " us/frame (max " << print_max_us << " us)" << std::endl;
+
+    // After: publishing to a motor-control and a logging subscriber
+    AlertBus bus;
+    std::atomic<int> stops{0};
+    bus.subscribe([&stops](const AlertEvent& event) {
+        if (event.level == AlertLevel::STOP) stops++;
+    });
+    bus.subscribe(AlertBus::console(log));
+    double publish_max_us = 0, publish_total_us = 0;
+    for (frame = 0; frame < frames; frame++) {
+        auto start = std::chrono::steady_clock::now();
+        bus.publish(frame_alert(frame));
+        double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - start).count();
+        publish_total_us += us;
+        if (us > publish_max_us) publish_max_us = us;
+        std::this_thread::sleep_for(frame_period);
+    }
+    bus.finish();
+
+    auto stats = bus.get_stats();
+    std::cout << "AlertBus publish, 2 subscribers:\t"
+        << publish_total_us/frames << " us/frame (max " << publish_max_us
+        << " us)\tdelivered " << stats.delivered << "/" << 2*frames
+        << "\tlost " << stats.lost << std::endl;
+    std::cout << "publish to delivery:\tp50 " << 1000*stats.latency.p50_ms
+        << " us\tp90 " << 1000*stats.latency.p90_ms << " us\tp99 "
+        << 1000*stats.latency.p99_ms << " us\tmax "
+        << 1000*stats.latency.max_ms << " us" << std::endl;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file AnnotationBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Annotation sink caller-side cost benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/Detection.hpp"
+#include "../include/AnnotationSink.hpp"
+
+void bench::annotation_bench() {
+    const std::array<int, 2> img_dim{{416, 416}};
+    const int frames = 200;
+    cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(90, 120, 60));
+    auto detections = std::make_shared<std::vector<Detection> >();
+    for (int i = 0; i < 5; i++)
+        detections->emplace_back(40 + 70*i, 120, 40, 120);
+
+    // An output that needs 20 ms per frame, slower than the detector.
+    auto slow_output = [](const cv::Mat&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    };
+
+    cv::Mat annotated;
+    double sync_ms = time_ms([&]() {
+        frame.copyTo(annotated);
+        AnnotationSink::draw(*detections, img_dim, &annotated);
+        do_not_optimize(annotated.data);
+    }, frames);
+    std::cout << "draw on the caller thread:\t" << 1000*sync_ms
+        << " us/frame, plus the output" << std::endl;
+
+    AnnotationSink sink(img_dim, slow_output);
+    double max_ms = 0;
+    double submit_ms = time_ms([&]() {
+        auto start = std::chrono::steady_clock::now();
+        sink.submit(frame, detections);
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        if (ms > max_ms) max_ms = ms;
+        // Detection at roughly 200 fps.
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }, frames);
+    sink.finish();
+
+    auto stats = sink.get_stats();
+    std::cout << "AnnotationSink submit:\t" << 1000*max_ms << " us max\t"
+        << "loop " << submit_ms << " ms/frame\trendered "
+        << stats.rendered << "/" << stats.submitted << "\tdropped "
+        << stats.dropped << std::endl;
+}
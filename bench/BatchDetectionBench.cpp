@@ -0,0 +1,64 @@
+/**
+ * @file BatchDetectionBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Batched vs. looped detection benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+
+void bench::batch_detection_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < 8; i++) {
+        auto img = cv::imread("../dataset/1/1_" + std::to_string(260 + i) +
+            ".png");
+        frames.push_back(*detector.prep_frame(img));
+    }
+
+    const int iterations = 3;
+    // Warm up the network so lazy allocations are not timed.
+    detector.detect(frames[0]);
+
+    for (std::size_t batch_size : {1, 2, 4, 8}) {
+        std::vector<cv::Mat> batch(frames.begin(),
+            frames.begin() + batch_size);
+
+        double loop_ms = bench::time_ms([&]() {
+            for (auto& frame : batch)
+                bench::do_not_optimize(detector.detect(frame));
+        }, iterations);
+        double batch_ms = bench::time_ms([&]() {
+            bench::do_not_optimize(detector.detect_batch(batch));
+        }, iterations);
+
+        std::cout << "batch " << batch_size
+            << "\tloop: " << 1000.0*batch_size/loop_ms << " fps"
+            << "\tbatched: " << 1000.0*batch_size/batch_ms << " fps"
+            << "\tspeedup: " << loop_ms/batch_ms << "x" << std::endl;
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file Benchmarks.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Benchmark registry and timing helpers
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+
+namespace bench {
+
+/**
+ * @brief A named benchmark. Each benchmark prints its own results.
+ * 
+ */
+struct Benchmark {
+    std::string name;
+    std::function<void()> run;
+};
+
+/**
+ * @brief Times a callable over a number of iterations
+ * 
+ * @param func callable to be timed
+ * @param iterations number of times func is called
+ * @return average wall time per iteration UNIT: [ms]
+ */
+template <typename Func>
+double time_ms(Func&& func, int iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) func();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count()/
+        iterations;
+}
+
+/**
+ * @brief Prevents the compiler from optimizing away a benchmarked result.
+ * 
+ * @param value 
+ */
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+void batch_detection_bench();
+void preprocess_bench();
+void decoder_bench();
+void nms_bench();
+void detector_pool_bench();
+void inference_engine_bench();
+void startup_bench();
+void int8_bench();
+void tiled_bench();
+void tracking_bench();
+void motion_gate_bench();
+void adaptive_resolution_bench();
+void pruned_model_bench();
+void annotation_bench();
+void steady_state_bench();
+void projection_bench();
+void rig_bench();
+void person_tracker_bench();
+void frame_source_bench();
+void alert_bench();
+void stage_timers_bench();
+
+}  // namespace bench
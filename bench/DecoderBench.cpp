@@ -0,0 +1,144 @@
+/**
+ * @file DecoderBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief YOLO output decoding benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/YoloDecoder.hpp"
+#include "../include/HumanDetector.hpp"
+
+namespace {
+
+/**
+ * @brief The original per-row decoding loop: a Mat header and minMaxLoc over all classes for every row.
+ * 
+ */
+void legacy_decode(const std::vector<cv::Mat>& outputs,
+        const std::vector<std::string>& classes, double threshold,
+        const std::array<int, 2>& img_dim, std::vector<cv::Rect>* boxes,
+        std::vector<float>* scores) {
+    for (const auto& output : outputs) {
+        auto data = reinterpret_cast<float*>(output.data);
+        for (int j = 0; j < output.rows; ++j, data += output.cols) {
+            cv::Mat class_scores = output.row(j).colRange(5, output.cols);
+            cv::Point class_id;
+            double confidence;
+            cv::minMaxLoc(class_scores, 0, &confidence, 0, &class_id);
+            if (confidence > threshold && classes[class_id.x] == "person") {
+                int width = static_cast<int>(data[2] * img_dim[0]);
+                int height = static_cast<int>(data[3] * img_dim[1]);
+                boxes->emplace_back(
+                    static_cast<int>(data[0] * img_dim[0]) - width / 2,
+                    static_cast<int>(data[1] * img_dim[1]) - height / 2,
+                    width, height);
+                scores->push_back(static_cast<float>(confidence));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Synthetic 416x416 YOLOv4 outputs where roughly 1% of rows have a confident object.
+ * 
+ */
+std::vector<cv::Mat> synthetic_outputs(int num_classes) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    std::vector<cv::Mat> outputs;
+    for (int grid : {52, 26, 13}) {
+        cv::Mat output(grid*grid*3, 5 + num_classes, CV_32F);
+        for (int j = 0; j < output.rows; j++) {
+            float* row = output.ptr<float>(j);
+            for (int k = 0; k < 4; k++) row[k] = uniform(gen);
+            float objectness = uniform(gen) < 0.01f ? uniform(gen) :
+                0.05f*uniform(gen);
+            row[4] = objectness;
+            for (int k = 0; k < num_classes; k++)
+                row[5 + k] = objectness*uniform(gen)*uniform(gen);
+        }
+        outputs.push_back(output);
+    }
+    return outputs;
+}
+
+}  // namespace
+
+void bench::decoder_bench() {
+    std::vector<std::string> classes;
+    std::ifstream ifs("../robot_params/coco.names");
+    std::string line;
+    while (getline(ifs, line)) classes.push_back(line);
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    double threshold = ret_params.at("DETECTION_PROBABILITY_THRESHOLD");
+    std::array<int, 2> img_dim{{
+        static_cast<int>(ret_params.at("IMG_WIDTH_REQ")),
+        static_cast<int>(ret_params.at("IMG_HEIGHT_REQ"))}};
+
+    // Record real network outputs when the weights are available.
+    std::vector<std::vector<cv::Mat> > recorded;
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        HumanDetector detector(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+        for (int i = 0; i < 8; i++) {
+            auto img = cv::imread("../dataset/1/1_" + std::to_string(260 + i) +
+                ".png");
+            recorded.push_back(detector.infer(detector.make_blob(img)));
+        }
+        std::cout << "Using " << recorded.size() << " recorded frames."
+            << std::endl;
+    } else {
+        recorded.push_back(synthetic_outputs(
+            static_cast<int>(classes.size())));
+        std::cout << "yolov4.weights not found, using synthetic outputs."
+            << std::endl;
+    }
+
+    YoloDecoder decoder(classes, threshold);
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    const int iterations = 50;
+
+    double legacy_ms = bench::time_ms([&]() {
+        for (const auto& outputs : recorded) {
+            boxes.clear();
+            scores.clear();
+            legacy_decode(outputs, classes, threshold, img_dim, &boxes,
+                &scores);
+        }
+    }, iterations)/recorded.size();
+
+    double decoder_ms = bench::time_ms([&]() {
+        for (const auto& outputs : recorded) {
+            boxes.clear();
+            scores.clear();
+            for (const auto& output : outputs)
+                decoder.decode(output.ptr<float>(), output.rows, output.cols,
+                    Letterbox(), img_dim, &boxes, &scores);
+        }
+    }, iterations)/recorded.size();
+
+    std::cout << "per frame\tlegacy: " << legacy_ms << " ms"
+        << "\tYoloDecoder: " << decoder_ms << " ms"
+        << "\tspeedup: " << legacy_ms/decoder_ms << "x" << std::endl;
+}
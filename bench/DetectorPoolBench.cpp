@@ -0,0 +1,78 @@
+/**
+ * @file DetectorPoolBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detector pool scaling benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/DetectorPool.hpp"
+
+void bench::detector_pool_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    cv::Mat img = cv::imread("../dataset/1/1_260.png");
+
+    const int frames_per_config = 16;
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    for (std::size_t instances : {1, 2, 4}) {
+        // Split the cores between instances so they do not oversubscribe.
+        // The OpenCV thread count is process-wide, and one pool runs at a
+        // time here.
+        int threads_per_instance = std::max(1u,
+            cores/static_cast<unsigned int>(instances));
+        cv::setNumThreads(threads_per_instance);
+        DetectorPool pool(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights",
+            instances);
+        for (std::size_t i = 0; i < instances; i++)
+            pool.acquire()->detect_frame(img);
+
+        for (std::size_t callers : {instances, 2*instances}) {
+            std::atomic<int> remaining{frames_per_config};
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < callers; t++) {
+                threads.emplace_back([&]() {
+                    while (remaining.fetch_sub(1) > 0) {
+                        auto lease = pool.acquire();
+                        bench::do_not_optimize(lease->detect_frame(img));
+                    }
+                });
+            }
+            for (auto& thread : threads) thread.join();
+            double secs = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+
+            std::cout << "instances " << instances
+                << "\tthreads/instance " << threads_per_instance
+                << "\tcallers " << callers
+                << "\tthroughput: " << frames_per_config/secs << " fps"
+                << std::endl;
+        }
+    }
+}
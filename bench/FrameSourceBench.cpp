@@ -0,0 +1,76 @@
+/**
+ * @file FrameSourceBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame source decode-ahead benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/FrameSource.hpp"
+
+namespace {
+
+const int bench_frames = 100;
+
+/**
+ * @brief Keeps the thread busy for a while, standing in for detection
+ * 
+ */
+void busy_wait_ms(double ms) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count() < ms) {}
+}
+
+}  // namespace
+
+void bench::frame_source_bench() {
+    if (!boost::filesystem::exists("../dataset/1/1_231.png")) {
+        std::cout << "Skipped: dataset/1 not found." << std::endl;
+        return;
+    }
+
+    // Time the caller spends getting each frame, with no work per frame
+    // (raw decode rate) and with a detection-sized stage after it
+    for (double work_ms : {0.0, 20.0}) {
+        cv::Mat frame;
+        double sync_wait_ms = 0;
+        for (int i = 0; i < bench_frames; i++) {
+            auto start = std::chrono::steady_clock::now();
+            frame = cv::imread("../dataset/1/1_" + std::to_string(231 + i) +
+                ".png");
+            sync_wait_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            do_not_optimize(frame.data);
+            busy_wait_ms(work_ms);
+        }
+
+        auto source = FrameSource::directory("../dataset/1", 30);
+        double timestamp, source_wait_ms = 0;
+        for (int i = 0; i < bench_frames; i++) {
+            auto start = std::chrono::steady_clock::now();
+            if (!source->read(&frame, &timestamp)) break;
+            source_wait_ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            do_not_optimize(frame.data);
+            busy_wait_ms(work_ms);
+        }
+        auto stats = source->get_stats();
+
+        std::cout << work_ms << " ms work per frame\tframe wait: imread "
+            << sync_wait_ms/bench_frames << " ms, FrameSource "
+            << source_wait_ms/bench_frames << " ms\tdecode: "
+            << stats.decode_fps << " fps" << std::endl;
+    }
+}
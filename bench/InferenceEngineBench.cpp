@@ -0,0 +1,95 @@
+/**
+ * @file InferenceEngineBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Inference engine comparison benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/DnnEngine.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+
+namespace {
+
+/**
+ * @brief Times detect_frame over the same frames for one engine
+ * 
+ */
+void run_engine(const std::unordered_map<std::string, double>& ret_params,
+        std::unique_ptr<InferenceEngine> engine,
+        const std::vector<cv::Mat>& frames) {
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        std::move(engine));
+    // Warm up the network so lazy allocations are not timed.
+    detector.detect_frame(frames[0]);
+
+    std::size_t num_detections = 0;
+    double ms = bench::time_ms([&]() {
+        num_detections = 0;
+        for (const auto& frame : frames)
+            num_detections += detector.detect_frame(frame)->size();
+    }, 3)/frames.size();
+
+    std::cout << detector.get_engine_name() << "\t" << ms << " ms/frame\t"
+        << num_detections << " detections" << std::endl;
+}
+
+}  // namespace
+
+void bench::inference_engine_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < 8; i++)
+        frames.push_back(cv::imread("../dataset/1/1_" +
+            std::to_string(260 + i) + ".png"));
+
+    DarknetModel model("../robot_params/yolov4.cfg",
+        "../robot_params/yolov4.weights");
+    for (int backend : {cv::dnn::DNN_BACKEND_OPENCV,
+            cv::dnn::DNN_BACKEND_INFERENCE_ENGINE}) {
+        auto targets = cv::dnn::getAvailableTargets(
+            static_cast<cv::dnn::Backend>(backend));
+        if (std::find(targets.begin(), targets.end(),
+                cv::dnn::DNN_TARGET_CPU) == targets.end()) {
+            std::cout << "backend " << backend << "\tnot available on CPU"
+                << std::endl;
+            continue;
+        }
+        run_engine(ret_params, std::unique_ptr<InferenceEngine>(
+            new DarknetEngine(model, backend, cv::dnn::DNN_TARGET_CPU)),
+            frames);
+    }
+
+    // Exported with the same input size and YOLO region output rows.
+    if (boost::filesystem::exists("../robot_params/yolov4.onnx"))
+        run_engine(ret_params, std::unique_ptr<InferenceEngine>(
+            new OnnxEngine("../robot_params/yolov4.onnx",
+                DnnEngine::get_backend(ret_params),
+                DnnEngine::get_target(ret_params))), frames);
+    else
+        std::cout << "onnx\tskipped: yolov4.onnx not found." << std::endl;
+}
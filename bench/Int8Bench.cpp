@@ -0,0 +1,85 @@
+/**
+ * @file Int8Bench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief FP32 vs. INT8 speed and accuracy benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/LabelParser.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/DetectionMetrics.hpp"
+
+namespace {
+
+void print_report(const std::string& name, const AccuracyReport& report) {
+    std::cout << name
+        << "\t" << report.ms_per_frame << " ms/frame"
+        << "\tdetected: " << 100*report.percent_detected << " %"
+        << "\tdiff x/y/w/h: " << report.average_x_diff << "/"
+        << report.average_y_diff << "/" << report.average_width_diff << "/"
+        << report.average_height_diff << " px" << std::endl;
+}
+
+}  // namespace
+
+void bench::int8_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    LabelParser label_parser;
+    auto labels = label_parser.read_labeled_test_images("../dataset/labels");
+
+    ret_params["INT8_INFERENCE"] = 0;
+    HumanDetector fp32_detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+
+    ret_params["INT8_INFERENCE"] = 1;
+    auto start = std::chrono::steady_clock::now();
+    HumanDetector int8_detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+    std::cout << "calibration: " << std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count() << " s";
+    // Later engines reuse the calibration blobs and only run the passes
+    start = std::chrono::steady_clock::now();
+    {
+        HumanDetector cached_detector(ret_params,
+            "../robot_params/coco.names", "../robot_params/yolov4.cfg",
+            "../robot_params/yolov4.weights");
+    }
+    std::cout << "\twith cached frames: " << std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count() << " s"
+        << std::endl;
+
+    // Warm up both networks so lazy allocations are not timed.
+    auto warm_up = fp32_detector.prep_frame(labels.front()->img);
+    fp32_detector.detect(*warm_up);
+    int8_detector.detect(*warm_up);
+
+    auto fp32 = evaluate_accuracy(&fp32_detector, labels);
+    auto int8 = evaluate_accuracy(&int8_detector, labels);
+    print_report("fp32", fp32);
+    print_report("int8", int8);
+    std::cout << "speedup: " << fp32.ms_per_frame/int8.ms_per_frame << "x"
+        << "\tdetected change: "
+        << 100*(int8.percent_detected - fp32.percent_detected) << " %"
+        << std::endl;
+}
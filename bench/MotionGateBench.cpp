@@ -0,0 +1,94 @@
+/**
+ * @file MotionGateBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Motion gate skip ratio benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/MotionGate.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+
+namespace {
+
+/**
+ * @brief Reads the numbered frames of a dataset sequence, in order
+ * 
+ */
+std::vector<cv::Mat> read_sequence(const std::string& dir, int first,
+        int last) {
+    std::vector<cv::Mat> frames;
+    for (int i = first; i <= last; i++) {
+        std::string path = "../dataset/" + dir + "/" + dir + "_" +
+            std::to_string(i) + ".png";
+        if (boost::filesystem::exists(path)) frames.push_back(cv::imread(path));
+    }
+    return frames;
+}
+
+}  // namespace
+
+void bench::motion_gate_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+
+    struct Sequence {
+        std::string name;
+        std::vector<cv::Mat> frames;
+    };
+    std::vector<Sequence> sequences{
+        {"dataset/0 (no humans)", read_sequence("0", 0, 230)},
+        {"dataset/1 (humans)", read_sequence("1", 231, 506)}
+    };
+
+    for (const auto& sequence : sequences) {
+        MotionGate gate(ret_params);
+        std::size_t gated_detections = 0, full_detections = 0;
+        std::size_t last_count = 0;
+        for (const auto& frame : sequence.frames) {
+            auto start = std::chrono::steady_clock::now();
+            auto detected = detector.detect_frame(frame);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+            full_detections += detected->size();
+
+            // The gated run reuses the last count on skipped frames.
+            if (gate.should_infer(frame)) {
+                gate.record_inference_ms(ms);
+                last_count = detected->size();
+            }
+            gated_detections += last_count;
+        }
+
+        auto stats = gate.get_stats();
+        std::cout << sequence.name
+            << "\tframes: " << stats.frames
+            << "\tskip ratio: " << 100*stats.skip_ratio << " %"
+            << "\tgate: " << stats.gate_ms/stats.frames << " ms/frame"
+            << "\tsaved: " << stats.saved_ms/1000 << " s"
+            << "\tdetections full/gated: " << full_detections << "/"
+            << gated_detections << std::endl;
+    }
+}
@@ -0,0 +1,56 @@
+/**
+ * @file NMSBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief NMS scaling benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <random>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/NMSEngine.hpp"
+
+void bench::nms_bench() {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    NMSEngine nms;
+
+    for (int num_boxes : {100, 1000, 5000, 10000, 50000}) {
+        // Person-shaped boxes crowded into a 1920x1080 frame.
+        std::vector<cv::Rect> boxes;
+        std::vector<float> scores;
+        for (int i = 0; i < num_boxes; i++) {
+            boxes.emplace_back(gen() % 1900, gen() % 1000, 20 + gen() % 60,
+                50 + gen() % 120);
+            scores.push_back(uniform(gen));
+        }
+        int iterations = num_boxes > 5000 ? 1 : 10;
+
+        std::vector<int> indices;
+        std::vector<float> updated;
+        double opencv_ms = bench::time_ms([&]() {
+            cv::dnn::NMSBoxes(boxes, scores, 0.1f, 0.4f, indices);
+        }, iterations);
+        double engine_ms = bench::time_ms([&]() {
+            nms.nms_boxes(boxes, scores, 0.1f, 0.4f, &indices);
+        }, iterations);
+        double soft_ms = bench::time_ms([&]() {
+            nms.soft_nms_boxes(boxes, scores, 0.1f, 0.4f, 0.5f,
+                NMSEngine::GAUSSIAN, &indices, &updated);
+        }, iterations);
+
+        std::cout << num_boxes << " boxes"
+            << "\tNMSBoxes: " << opencv_ms << " ms"
+            << "\tNMSEngine: " << engine_ms << " ms"
+            << "\tspeedup: " << opencv_ms/engine_ms << "x"
+            << "\tsoft-NMS: " << soft_ms << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file PersonTrackerBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Person tracker update cost benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+
+#include <array>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "./Benchmarks.hpp"
+#include "../include/PersonTracker.hpp"
+
+void bench::person_tracker_bench() {
+    const double PI = std::atan(1.0)*4;
+    const double frame_dt = 1/30.0, walk_speed = 1.2, side = 60;
+    const int warmup_frames = 30, frames = 300;
+
+    for (std::size_t people : {10, 50, 100, 200, 500, 1000}) {
+        // People walking across a side x side m hall, seen 95% of the time
+        // with 0.2 m of noise
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<double> place(-side/2, side/2);
+        std::uniform_real_distribution<double> heading(0, 2*PI);
+        std::uniform_real_distribution<double> chance(0, 1);
+        std::normal_distribution<double> noise(0, 0.2);
+        std::vector<std::array<double, 4> > walkers(people);
+        for (auto& walker : walkers)
+            walker = {{place(gen), place(gen), heading(gen), 0}};
+
+        PersonTracker tracker(2, 0.3, 1.5, 3, 5);
+        std::vector<std::array<double, 3> > all_xyz;
+        std::vector<PersonTrack> confirmed;
+        double total_us = 0, max_us = 0;
+        for (int f = 0; f < warmup_frames + frames; f++) {
+            all_xyz.clear();
+            for (auto& walker : walkers) {
+                walker[2] += 0.05*noise(gen);
+                walker[0] += walk_speed*frame_dt*std::cos(walker[2]);
+                walker[1] += walk_speed*frame_dt*std::sin(walker[2]);
+                if (chance(gen) < 0.95)
+                    all_xyz.push_back({{walker[0] + noise(gen), 0.9,
+                        walker[1] + noise(gen)}});
+            }
+            std::shuffle(all_xyz.begin(), all_xyz.end(), gen);
+
+            auto start = std::chrono::steady_clock::now();
+            tracker.update(all_xyz, f*frame_dt, &confirmed);
+            double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            do_not_optimize(confirmed.data());
+            if (f < warmup_frames) continue;
+            total_us += us;
+            max_us = std::max(max_us, us);
+        }
+
+        std::cout << people << " people\tupdate: " << total_us/frames
+            << " us (max " << max_us << " us)\tconfirmed tracks: "
+            << confirmed.size() << "\tall tracks: " << tracker.size()
+            << std::endl;
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file PreprocessBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Fused vs. OpenCV preprocessing benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/FramePreprocessor.hpp"
+
+void bench::preprocess_bench() {
+    cv::Mat frame = cv::imread("../dataset/1/1_269.png");
+    if (frame.empty()) {
+        frame = cv::Mat(480, 640, CV_8UC3);
+        cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(255));
+    }
+    const cv::Size net_size(416, 416);
+    const int iterations = 200;
+
+    double opencv_ms = bench::time_ms([&]() {
+        cv::Mat prepped, blob;
+        cv::resize(frame, prepped, net_size, cv::INTER_LINEAR);
+        cv::dnn::blobFromImage(prepped, blob, 1/255.0, net_size,
+            cv::Scalar(0, 0, 0), true, false);
+        bench::do_not_optimize(blob.data);
+    }, iterations);
+
+    for (bool letterbox : {false, true}) {
+        FramePreprocessor preprocessor(net_size.width, net_size.height,
+            letterbox);
+        std::vector<float> tensor(3*net_size.area());
+        double fused_ms = bench::time_ms([&]() {
+            preprocessor.run(frame.data, frame.cols, frame.rows, frame.step,
+                tensor.data());
+            bench::do_not_optimize(tensor.data());
+        }, iterations);
+
+        std::cout << frame.cols << "x" << frame.rows << " -> "
+            << net_size.width << "x" << net_size.height
+            << (letterbox ? " (letterbox)" : "")
+            << "\tresize+blobFromImage: " << opencv_ms << " ms"
+            << "\tfused: " << fused_ms << " ms"
+            << "\tspeedup: " << opencv_ms/fused_ms << "x" << std::endl;
+    }
+}
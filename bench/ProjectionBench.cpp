@@ -0,0 +1,115 @@
+/**
+ * @file ProjectionBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Per-detection Eigen vs batched SIMD projection and ground range benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <eigen3/Eigen/Dense>
+
+#include <array>
+#include <random>
+#include <memory>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "./Benchmarks.hpp"
+#include "../include/DetectionBatch.hpp"
+#include "../include/PixelProjection.hpp"
+#include "../include/PositionEstimator.hpp"
+#include "../include/GroundRangeEstimator.hpp"
+
+namespace {
+
+/**
+ * @brief The per-detection projection PositionEstimator used before the batched kernel: depth, Vector4d, full 4x4 product.
+ * 
+ */
+std::array<double, 3> eigen_xyz(const Eigen::Matrix<double, 4, 4>& T,
+        double focal_px, double cx, double cy, double avg_height,
+        float x, float y, float w, float h) {
+    double camera_z = avg_height*focal_px/h;
+    double scale = camera_z/focal_px;
+    Eigen::Vector4d camera_frame;
+    camera_frame << (x + w/2 - cx)*scale, (y + h/2 - cy)*scale, camera_z, 1;
+    auto rob_frame = T*camera_frame;
+    return std::array<double, 3>{rob_frame[0], rob_frame[1], rob_frame[2]};
+}
+
+}  // namespace
+
+void bench::projection_bench() {
+    const double PI = std::atan(1.0)*4;
+    const double f = 0.004, density = 150000, avg_height = 1.7;
+    PositionEstimator estimator(0.3, -0.1, 1.2, 15*PI/180.0, f, density,
+        608, 608, avg_height);
+    const auto& T = estimator.get_cam2robot_transform();
+    const PixelProjection& projection = estimator.get_projection();
+
+    PositionEstimator fused_estimator = estimator;
+    fused_estimator.set_ground_range(
+        std::make_shared<const GroundRangeEstimator>(T, f*density, 304, 608,
+            1.2, 0.1, 2));
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<float> pos(0.f, 560.f);
+    std::uniform_real_distribution<float> size(20.f, 300.f);
+
+    for (std::size_t n : {1, 10, 100, 1000, 10000, 100000, 1000000}) {
+        DetectionBatch batch;
+        batch.reserve(n);
+        for (std::size_t i = 0; i < n; i++)
+            batch.push_back(pos(gen), pos(gen), size(gen), size(gen));
+        int iterations = static_cast<int>(std::max<std::size_t>(1,
+            2000000/n));
+
+        std::vector<std::array<double, 3> > all_xyz(n);
+        double eigen_ms = bench::time_ms([&]() {
+            for (std::size_t i = 0; i < n; i++)
+                all_xyz[i] = eigen_xyz(T, f*density, 304, 304, avg_height,
+                    batch.x()[i], batch.y()[i], batch.width()[i],
+                    batch.height()[i]);
+            do_not_optimize(all_xyz.data());
+        }, iterations);
+
+        double aos_ms = bench::time_ms([&]() {
+            estimator.estimate_all_xyz(batch, &all_xyz);
+            do_not_optimize(all_xyz.data());
+        }, iterations);
+
+        double ground_ms = bench::time_ms([&]() {
+            fused_estimator.estimate_all_xyz(batch, &all_xyz);
+            do_not_optimize(all_xyz.data());
+        }, iterations);
+
+        std::vector<double> dx(n), dy(n), dz(n);
+        double double_ms = bench::time_ms([&]() {
+            projection.project(batch.x(), batch.y(), batch.width(),
+                batch.height(), n, dx.data(), dy.data(), dz.data());
+            do_not_optimize(dz.data());
+        }, iterations);
+
+        std::vector<float> fx(n), fy(n), fz(n);
+        double float_ms = bench::time_ms([&]() {
+            projection.project(batch.x(), batch.y(), batch.width(),
+                batch.height(), n, fx.data(), fy.data(), fz.data());
+            do_not_optimize(fz.data());
+        }, iterations);
+
+        auto ns = [n](double ms) { return ms*1e6/n; };
+        std::cout << n << " boxes"
+            << "\tEigen: " << ns(eigen_ms) << " ns/box"
+            << "\testimate_all_xyz(batch): " << ns(aos_ms) << " ns/box"
+            << "\twith ground range: " << ns(ground_ms) << " ns/box"
+            << "\tdouble SoA: " << ns(double_ms) << " ns/box"
+            << "\tfloat SoA: " << ns(float_ms) << " ns/box"
+            << "\tspeedup: " << eigen_ms/float_ms << "x" << std::endl;
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file PrunedModelBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Person-only model benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/DarknetPruner.hpp"
+#include "../include/HumanDetector.hpp"
+
+void bench::pruned_model_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    auto dir = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+    boost::filesystem::create_directory(dir);
+    auto cfg_path = (dir / "yolov4-person.cfg").string();
+    auto weight_path = (dir / "yolov4-person.weights").string();
+    auto names_path = (dir / "person.names").string();
+
+    DarknetPruner pruner("../robot_params/yolov4.cfg",
+        "../robot_params/yolov4.weights");
+    auto report = pruner.prune(0, cfg_path, weight_path);
+    std::ofstream(names_path.c_str()) << "person\n";
+    std::cout << "head filters: " << report.head_filters_before << " -> "
+        << report.head_filters_after << "\tweights: "
+        << report.weight_bytes_before << " -> " << report.weight_bytes_after
+        << " bytes" << std::endl;
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < 8; i++)
+        frames.push_back(cv::imread("../dataset/1/1_" +
+            std::to_string(260 + i) + ".png"));
+
+    struct Model {
+        std::string name, names, cfg, weights;
+    };
+    std::vector<Model> models{
+        {"80 classes", "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights"},
+        {"person only", names_path, cfg_path, weight_path}
+    };
+    for (const auto& model : models) {
+        HumanDetector detector(ret_params, model.names, model.cfg,
+            model.weights);
+        detector.detect_frame(frames[0]);
+
+        std::size_t num_detections = 0;
+        double ms = time_ms([&]() {
+            num_detections = 0;
+            for (const auto& frame : frames)
+                num_detections += detector.detect_frame(frame)->size();
+        }, 3)/frames.size();
+        std::cout << model.name << "\t" << ms << " ms/frame\t"
+            << num_detections << " detections" << std::endl;
+    }
+    boost::filesystem::remove_all(dir);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file RigBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Multi-camera rig latency benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/CameraRig.hpp"
+#include "../include/DetectorPool.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/Detection.hpp"
+
+void bench::rig_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    cv::Mat img = cv::imread("../dataset/1/1_260.png");
+
+    const int iterations = 8;
+    const std::size_t cameras = 4;
+    ret_params["RIG_CAMERAS"] = cameras;
+    CameraRig rig(ret_params);
+    std::vector<cv::Mat> frames(cameras, img);
+    std::vector<std::array<double, 3> > all_xyz;
+
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+    std::vector<Detection> detections;
+    detector.detect_frame(img, &detections);
+    double one_ms = bench::time_ms([&]() {
+        detector.detect_frame(img, &detections);
+    }, iterations);
+    std::cout << "1 camera:\t" << one_ms << " ms" << std::endl;
+
+    rig.get_xyz(&detector, frames, &all_xyz);
+    double batched_ms = bench::time_ms([&]() {
+        rig.get_xyz(&detector, frames, &all_xyz);
+    }, iterations);
+    std::cout << cameras << " cameras, batched:\t" << batched_ms << " ms ("
+        << batched_ms/one_ms << "x 1 camera)" << std::endl;
+
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    cv::setNumThreads(std::max(1u, cores/static_cast<unsigned int>(cameras)));
+    DetectorPool pool(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights",
+        cameras);
+    rig.get_xyz(&pool, frames, &all_xyz);
+    double pooled_ms = bench::time_ms([&]() {
+        rig.get_xyz(&pool, frames, &all_xyz);
+    }, iterations);
+    std::cout << cameras << " cameras, pooled:\t" << pooled_ms << " ms ("
+        << pooled_ms/one_ms << "x 1 camera)" << std::endl;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file StageTimersBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Per-stage timer overhead benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/StageTimers.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/PositionEstimator.hpp"
+
+namespace {
+
+/**
+ * @brief Median time of one detect_frame and estimate_all_xyz pass over every frame UNIT: [ms]
+ * 
+ */
+double median_frame_ms(const std::vector<cv::Mat>& frames,
+        HumanDetector* detector, PositionEstimator* estimator) {
+    std::vector<Detection> detections;
+    std::vector<std::array<double, 3> > all_xyz;
+    std::vector<double> ms;
+    for (int pass = 0; pass < 4; pass++) {
+        for (const auto& frame : frames) {
+            auto start = std::chrono::steady_clock::now();
+            detector->detect_frame(frame, &detections);
+            estimator->estimate_all_xyz(detections, &all_xyz);
+            bench::do_not_optimize(all_xyz.data());
+            ms.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+    }
+    std::sort(ms.begin(), ms.end());
+    return ms[ms.size()/2];
+}
+
+}  // namespace
+
+void bench::stage_timers_bench() {
+    // Cost of one stage: an empty scope timed into a histogram
+    const int iterations = 1000000;
+    StageTimers timers;
+    StageTimers* off = nullptr;
+    do_not_optimize(off);
+    double off_ns = 1e6*time_ms([&]() {
+        STAGE_TIMER(off, Stage::NMS);
+        do_not_optimize(iterations);
+    }, iterations);
+    double on_ns = 1e6*time_ms([&]() {
+        STAGE_TIMER(&timers, Stage::NMS);
+        do_not_optimize(iterations);
+    }, iterations);
+    std::cout << "stage timer, off:\t" << off_ns << " ns\ton:\t" << on_ns
+        << " ns\t(" << StageTimers::num_stages << " stages per frame: "
+        << StageTimers::num_stages*on_ns/1e3 << " us)" << std::endl;
+
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped detection: yolov4.weights not found."
+            << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+    PositionEstimator estimator(ret_params);
+
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < 25; i++)
+        frames.push_back(cv::imread("../dataset/1/1_" +
+            std::to_string(260 + i) + ".png"));
+    median_frame_ms(frames, &detector, &estimator);
+
+    double untimed_ms = median_frame_ms(frames, &detector, &estimator);
+    timers.reset();
+    detector.set_stage_timers(&timers);
+    estimator.set_stage_timers(&timers);
+    double timed_ms = median_frame_ms(frames, &detector, &estimator);
+    std::cout << "detect and estimate, timers off:\t" << untimed_ms
+        << " ms\ton:\t" << timed_ms << " ms\toverhead "
+        << 100*(timed_ms - untimed_ms)/untimed_ms << " %" << std::endl;
+    timers.write_json(std::cout);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file StartupBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Cold start and resident memory benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/utils.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/WeightStore.hpp"
+#include "../include/DarknetModel.hpp"
+#include "../include/HumanDetector.hpp"
+
+namespace {
+
+/**
+ * @brief Builds three detectors one after another, printing the build time, first detection time and resident memory of each
+ * 
+ */
+void build_three(const std::string& name, const cv::Mat& img,
+        const std::function<HumanDetector*()>& build,
+        std::vector<std::unique_ptr<HumanDetector> >* detectors) {
+    const double mb = 1024.0*1024.0;
+    for (int i = 0; i < 3; i++) {
+        auto start = std::chrono::steady_clock::now();
+        detectors->emplace_back(build());
+        auto built = std::chrono::steady_clock::now();
+        bench::do_not_optimize(detectors->back()->detect_frame(img));
+        auto detected = std::chrono::steady_clock::now();
+
+        std::cout << name << " detector " << i
+            << "\tbuild: " << std::chrono::duration<double, std::milli>(
+                built - start).count() << " ms"
+            << "\tfirst detection: " << std::chrono::duration<double,
+                std::milli>(detected - start).count() << " ms"
+            << "\trss: " << resident_memory_bytes()/mb << " MB" << std::endl;
+    }
+}
+
+}  // namespace
+
+void bench::startup_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    cv::Mat img = cv::imread("../dataset/1/1_260.png");
+    const std::string cfg_path = "../robot_params/yolov4.cfg";
+    const std::string weight_path = "../robot_params/yolov4.weights";
+    const std::string coco_path = "../robot_params/coco.names";
+
+    const double mb = 1024.0*1024.0;
+    std::cout << "baseline\trss: " << resident_memory_bytes()/mb << " MB"
+        << std::endl;
+
+    // Before: every detector loads the model by itself, which is
+    // unmapped again once the detector is built
+    std::vector<std::unique_ptr<HumanDetector> > detectors;
+    build_three("separate", img, [&]() {
+        return new HumanDetector(ret_params, coco_path, cfg_path,
+            weight_path);
+    }, &detectors);
+    detectors.clear();
+    std::cout << "released\trss: " << resident_memory_bytes()/mb << " MB"
+        << std::endl;
+
+    // After: detectors built while the model is held share its blobs
+    auto start = std::chrono::steady_clock::now();
+    auto model = WeightStore::get(cfg_path, weight_path);
+    std::cout << "weights mapped: " << model->get_weight_bytes()/mb
+        << " MB in " << std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count() << " ms"
+        << std::endl;
+    build_three("shared", img, [&]() {
+        return new HumanDetector(ret_params, coco_path, *model);
+    }, &detectors);
+    model.reset();
+    std::cout << "weights unmapped\trss: " << resident_memory_bytes()/mb
+        << " MB" << std::endl;
+}
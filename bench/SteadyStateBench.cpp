@@ -0,0 +1,85 @@
+/**
+ * @file SteadyStateBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Allocating vs caller-buffer detection tail latency benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/PositionEstimator.hpp"
+
+namespace {
+
+/**
+ * @brief Prints the median, 99th percentile and worst frame time of a detection call
+ * 
+ */
+void report(const std::string& name, const std::vector<cv::Mat>& frames,
+        const std::function<void(const cv::Mat&)>& run) {
+    run(frames[0]);
+    std::vector<double> ms;
+    for (int pass = 0; pass < 4; pass++) {
+        for (const auto& frame : frames) {
+            auto start = std::chrono::steady_clock::now();
+            run(frame);
+            ms.push_back(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+    }
+    std::sort(ms.begin(), ms.end());
+    std::cout << name << "\tp50 " << ms[ms.size()/2] << " ms\tp99 "
+        << ms[ms.size()*99/100] << " ms\tmax " << ms.back() << " ms"
+        << std::endl;
+}
+
+}  // namespace
+
+void bench::steady_state_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+    PositionEstimator estimator(ret_params);
+
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < 25; i++)
+        frames.push_back(cv::imread("../dataset/1/1_" +
+            std::to_string(260 + i) + ".png"));
+
+    report("shared_ptr results", frames, [&](const cv::Mat& frame) {
+        do_not_optimize(estimator.estimate_all_xyz(
+            *detector.detect_frame(frame)));
+    });
+
+    std::vector<Detection> detections;
+    std::vector<std::array<double, 3> > all_xyz;
+    report("caller buffers", frames, [&](const cv::Mat& frame) {
+        detector.detect_frame(frame, &detections);
+        estimator.estimate_all_xyz(detections, &all_xyz);
+        do_not_optimize(all_xyz.data());
+    });
+}
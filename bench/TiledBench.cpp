@@ -0,0 +1,65 @@
+/**
+ * @file TiledBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Whole-frame vs. tiled detection benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+
+void bench::tiled_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+
+    // Dataset frames pasted at native size along the top of a 720p frame
+    // stand in for people far down an aisle.
+    cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(114, 114, 114));
+    for (int i = 0; i < 5; i++) {
+        cv::Mat img = cv::imread("../dataset/1/1_" + std::to_string(260 + i) +
+            ".png");
+        img.copyTo(frame(cv::Rect(256*i, 0, img.cols, img.rows)));
+    }
+
+    const int iterations = 3;
+    for (double band_bottom : {0.4, 0.6, 1.0}) {
+        ret_params["TILE_BAND_BOTTOM"] = band_bottom;
+        HumanDetector detector(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+        // Warm up the network so lazy allocations are not timed.
+        detector.detect_tiled(frame);
+
+        std::size_t full_count = 0, tiled_count = 0;
+        double full_ms = bench::time_ms([&]() {
+            full_count = detector.detect_frame(frame)->size();
+        }, iterations);
+        double tiled_ms = bench::time_ms([&]() {
+            tiled_count = detector.detect_tiled(frame)->size();
+        }, iterations);
+
+        std::cout << "band 0-" << 100*band_bottom << " %"
+            << "\twhole frame: " << full_ms << " ms, " << full_count
+            << " people"
+            << "\ttiled: " << tiled_ms << " ms, " << tiled_count
+            << " people" << std::endl;
+    }
+}
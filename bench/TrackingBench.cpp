@@ -0,0 +1,107 @@
+/**
+ * @file TrackingBench.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detect-every-frame vs. detect-then-track benchmark
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <memory>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "./Benchmarks.hpp"
+#include "../include/utils.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/DetectionTracker.hpp"
+#include "../include/PositionEstimator.hpp"
+
+void bench::tracking_bench() {
+    if (!boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        std::cout << "Skipped: yolov4.weights not found." << std::endl;
+        return;
+    }
+
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+    PositionEstimator estimator(ret_params);
+
+    std::vector<cv::Mat> frames;
+    for (int i = 231; i <= 506; i++) {
+        std::string path = "../dataset/1/1_" + std::to_string(i) + ".png";
+        if (boost::filesystem::exists(path)) frames.push_back(cv::imread(path));
+    }
+
+    // Every frame through the network is the reference.
+    std::vector<std::vector<std::array<double, 3> > > reference;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& frame : frames) {
+        auto prep_img = detector.prep_frame(frame);
+        reference.push_back(*estimator.estimate_all_xyz(
+            *detector.detect(*prep_img)));
+    }
+    double detect_secs = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    for (int max_interval : {2, 4, 8, 16}) {
+        DetectionTracker tracker(max_interval,
+            get_param(ret_params, "TRACK_MIN_CONFIDENCE", 0.5));
+        cv::Mat gray;
+        std::size_t keyframes = 0;
+        double sum_error = 0, max_error = 0;
+        std::size_t num_matched = 0;
+
+        start = std::chrono::steady_clock::now();
+        for (std::size_t f = 0; f < frames.size(); f++) {
+            auto prep_img = detector.prep_frame(frames[f]);
+            cv::cvtColor(*prep_img, gray, cv::COLOR_BGR2GRAY);
+            auto detected = std::make_shared<std::vector<Detection> >();
+            if (tracker.needs_keyframe() ||
+                    !tracker.track(gray, detected.get())) {
+                detected = detector.detect(*prep_img);
+                tracker.reset(gray, *detected);
+                keyframes++;
+            }
+
+            for (const auto& xyz : *estimator.estimate_all_xyz(*detected)) {
+                double closest = std::numeric_limits<double>::max();
+                for (const auto& ref : reference[f])
+                    closest = std::min(closest, std::sqrt(
+                        (xyz[0] - ref[0])*(xyz[0] - ref[0]) +
+                        (xyz[1] - ref[1])*(xyz[1] - ref[1]) +
+                        (xyz[2] - ref[2])*(xyz[2] - ref[2])));
+                if (reference[f].empty()) continue;
+                sum_error += closest;
+                max_error = std::max(max_error, closest);
+                num_matched++;
+            }
+        }
+        double track_secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "max interval " << max_interval
+            << "\tkeyframes: " << keyframes << "/" << frames.size()
+            << "\tfps: " << frames.size()/detect_secs << " -> "
+            << frames.size()/track_secs
+            << "\tposition error mean/max: "
+            << (num_matched ? sum_error/num_matched : 0) << "/" << max_error
+            << " m" << std::endl;
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file main.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Benchmark app main
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "./Benchmarks.hpp"
+
+/**
+ * @brief Runs every benchmark, or only those whose names are given as
+ * arguments.
+ * 
+ */
+int main(int argc, char** argv) {
+    std::vector<bench::Benchmark> benchmarks{
+        {"batch_detection", bench::batch_detection_bench},
+        {"preprocess", bench::preprocess_bench},
+        {"decoder", bench::decoder_bench},
+        {"nms", bench::nms_bench},
+        {"detector_pool", bench::detector_pool_bench},
+        {"inference_engine", bench::inference_engine_bench},
+        {"startup", bench::startup_bench},
+        {"int8", bench::int8_bench},
+        {"tiled", bench::tiled_bench},
+        {"tracking", bench::tracking_bench},
+        {"motion_gate", bench::motion_gate_bench},
+        {"adaptive_resolution", bench::adaptive_resolution_bench},
+        {"pruned_model", bench::pruned_model_bench},
+        {"annotation", bench::annotation_bench},
+        {"steady_state", bench::steady_state_bench},
+        {"projection", bench::projection_bench},
+        {"rig", bench::rig_bench},
+        {"person_tracker", bench::person_tracker_bench},
+        {"frame_source", bench::frame_source_bench},
+        {"alert", bench::alert_bench},
+        {"stage_timers", bench::stage_timers_bench}
+    };
+
+    for (const auto& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++)
+            if (benchmark.name == argv[i]) selected = true;
+        if (!selected) continue;
+
+        std::cout << "[ " << benchmark.name << " ]" << std::endl;
+        benchmark.run();
+        std::cout << std::endl;
+    }
+    return 0;
+}
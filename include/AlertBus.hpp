@@ -0,0 +1,228 @@
+/**
+ * @file AlertBus.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Alert Bus header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <exception>
+#include <functional>
+
+#include "./BroadcastRing.hpp"
+#include "./LatencyHistogram.hpp"
+
+/**
+ * @brief What the robot should do about the closest person
+ * 
+ */
+enum class AlertLevel {
+    CONTINUE,
+    REDIRECT,
+    STOP
+};
+
+/**
+ * @brief The alert decided for one frame
+ * 
+ */
+struct AlertEvent {
+    /**
+     * @brief Publication order, starting at 1
+     * 
+     */
+    std::uint64_t sequence{0};
+    AlertLevel level{AlertLevel::CONTINUE};
+
+    /**
+     * @brief Distance to the closest person, infinite if nobody was seen UNIT: [m]
+     * 
+     */
+    double min_distance{0};
+
+    /**
+     * @brief x, y, z position of the closest person in ROBOT frame UNIT: [m]
+     * 
+     */
+    std::array<double, 3> xyz{};
+
+    /**
+     * @brief Track id of the closest person, 0 for untracked positions
+     * 
+     */
+    std::uint64_t track_id{0};
+    std::uint32_t people{0};
+
+    /**
+     * @brief Capture time of the frame UNIT: [s]
+     * 
+     */
+    double frame_timestamp{0};
+
+    /**
+     * @brief std::chrono::steady_clock time the frame arrived, 0 if unknown UNIT: [ns]
+     * 
+     */
+    std::int64_t arrival_ns{0};
+};
+
+/**
+ * @brief Alerts published, delivered and lost, and the time from frame arrival to delivery
+ * 
+ */
+struct AlertBusStats {
+    std::uint64_t published{0};
+    std::uint64_t delivered{0};
+
+    /**
+     * @brief Alerts a subscriber fell too far behind to receive
+     * 
+     */
+    std::uint64_t lost{0};
+    LatencySummary latency{};
+};
+
+/**
+ * @brief Publishes alerts from the perception loop to any number of subscribers, without locks or waiting.
+ * 
+ * @details Events go through a lock-free broadcast ring (see
+ * BroadcastRing), so publish() costs the same however many subscribers
+ * there are and however slow they are. Every subscriber receives every
+ * event, unless it falls more than the capacity behind, in which case it
+ * skips to the oldest event kept. Handlers run on their own threads and
+ * poll the ring, so the publisher never makes a system call.
+ */
+class AlertBus {
+ public:
+    /**
+     * @brief Receives every alert, on its own thread
+     * 
+     */
+    typedef std::function<void(const AlertEvent&)> Handler;
+
+    /**
+     * @brief A subscriber that polls for alerts itself. Used by one thread at a time.
+     * 
+     */
+    class Subscription {
+     private:
+        AlertBus* bus;
+        BroadcastRing<AlertEvent>::Cursor cursor;
+
+     public:
+        Subscription(AlertBus* _bus, BroadcastRing<AlertEvent>::Cursor _cursor)
+          : bus{_bus}, cursor{_cursor} {}
+
+        /**
+         * @brief Gets the next alert, if one was published. Never blocks.
+         * 
+         * @param event output
+         * @return false if no alert is waiting
+         */
+        bool poll(AlertEvent* event);
+    };
+
+ private:
+    BroadcastRing<AlertEvent> ring;
+    std::chrono::microseconds poll_interval;
+
+    LatencyHistogram latency;
+    std::atomic<std::uint64_t> delivered{0};
+    std::atomic<std::uint64_t> lost{0};
+
+    std::atomic<bool> finishing{false};
+    std::mutex handler_mtx;
+    std::vector<std::thread> handlers{};
+    std::exception_ptr handler_error{nullptr};
+
+    void handler_loop(Handler handler, Subscription subscription);
+
+ public:
+    /**
+     * @brief Construct a new Alert Bus
+     * 
+     * @param capacity alerts kept for a subscriber that falls behind
+     * @param _poll_interval sleep between polls of an idle handler, the most a handler can add to the delivery latency
+     */
+    explicit AlertBus(std::size_t capacity = 64,
+      std::chrono::microseconds _poll_interval =
+        std::chrono::microseconds(100));
+
+    /**
+     * @brief Delivers the published alerts to every handler, then stops their threads
+     * 
+     */
+    ~AlertBus();
+
+    AlertBus(const AlertBus&) = delete;
+    AlertBus& operator=(const AlertBus&) = delete;
+
+    /**
+     * @brief Publishes an alert, setting its sequence. Never blocks. Only one thread may publish.
+     * 
+     * @param event
+     * @return the published sequence number
+     */
+    std::uint64_t publish(AlertEvent event);
+
+    /**
+     * @brief Subscribes a poller to the alerts published from now on
+     * 
+     * @return Subscription
+     */
+    Subscription subscribe();
+
+    /**
+     * @brief Runs a handler on its own thread for every alert published from now on
+     * 
+     * @param handler
+     */
+    void subscribe(Handler handler);
+
+    /**
+     * @brief Delivers the published alerts to every handler, then stops their threads
+     * 
+     * @throw the first exception raised by a handler, if any
+     */
+    void finish();
+
+    /**
+     * @brief Gets the alerts published, delivered and lost, and the frame arrival to delivery latency
+     * 
+     * @return AlertBusStats
+     */
+    AlertBusStats get_stats() const;
+
+    /**
+     * @brief Decides the alert for the distance to the closest person
+     * 
+     * @param distance UNIT: [m]
+     * @param low_threshold redirect at or within this distance UNIT: [m]
+     * @param high_threshold stop within this distance UNIT: [m]
+     * @return AlertLevel
+     */
+    static AlertLevel classify(double distance, double low_threshold,
+      double high_threshold);
+
+    /**
+     * @brief Handler that writes each alert as the robot's action, like VisionAPI::print_alerts
+     * 
+     * @param out stream to write to, from the handler's thread
+     * @return Handler
+     */
+    static Handler console(std::ostream& out);
+};
@@ -0,0 +1,156 @@
+/**
+ * @file AnnotationSink.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Annotation Sink header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <opencv2/opencv.hpp>
+
+#include "./BoundedQueue.hpp"
+#include "./Detection.hpp"
+
+/**
+ * @brief Frames handed to an annotation sink and what became of them
+ * 
+ */
+struct AnnotationStats {
+    std::size_t submitted{0};
+    std::size_t rendered{0};
+    std::size_t dropped{0};
+};
+
+/**
+ * @brief Draws detections onto frames on its own thread, hands them to an optional output and keeps the newest one for the caller.
+ * 
+ * @details submit() never blocks. When the output falls behind and the
+ * queue is full, the oldest queued frame is dropped so the display stays
+ * current and the caller's timing is unaffected. Frames are queued by
+ * reference and only copied by the sink's thread, right before drawing.
+ * HighGUI windows must be driven from the main thread, so the sink never
+ * shows frames itself: the caller polls take_latest() and shows them.
+ */
+class AnnotationSink {
+ public:
+    /**
+     * @brief Receives every annotated frame, on the sink's thread. Must not use HighGUI.
+     * 
+     */
+    typedef std::function<void(const cv::Mat&)> Output;
+
+ private:
+    struct Item {
+        cv::Mat frame;
+        std::shared_ptr<const std::vector<Detection> > detections;
+    };
+
+    std::array<int, 2> img_dim;
+    Output output;
+    BoundedQueue<Item> queue;
+    std::thread worker;
+
+    mutable std::mutex stats_mtx;
+    AnnotationStats stats{};
+    std::exception_ptr worker_error{nullptr};
+
+    std::mutex latest_mtx;
+    cv::Mat latest{};
+    bool latest_taken{true};
+
+    void render_loop();
+
+ public:
+    /**
+     * @brief Construct a new Annotation Sink and start its thread
+     * 
+     * @param _img_dim NN input width and height, the coordinates detections are in
+     * @param _output receives annotated frames, none if empty
+     * @param capacity frames that can wait to be rendered before the oldest is dropped
+     */
+    explicit AnnotationSink(const std::array<int, 2>& _img_dim,
+      Output _output = Output(), std::size_t capacity = 2);
+
+    /**
+     * @brief Renders the frames still queued, then stops the thread
+     * 
+     */
+    ~AnnotationSink();
+
+    AnnotationSink(const AnnotationSink&) = delete;
+    AnnotationSink& operator=(const AnnotationSink&) = delete;
+
+    /**
+     * @brief Queues a frame and its detections for drawing. Never blocks.
+     * 
+     * @details The frame data is not copied here. A caller that writes the
+     * next capture into the same buffer should submit a clone.
+     * 
+     * @param frame original camera frame
+     * @param detections detections in NN input coordinates
+     * @return false if a frame was dropped
+     */
+    bool submit(const cv::Mat& frame,
+      std::shared_ptr<const std::vector<Detection> > detections);
+
+    /**
+     * @brief Stops accepting frames and waits until the queued ones are rendered
+     * 
+     * @throw the first exception raised by the output, if any
+     */
+    void finish();
+
+    /**
+     * @brief Copies the newest annotated frame, if one was rendered since the last call
+     * 
+     * @details Meant to be polled from the main thread, which can then
+     * show the frame with cv::imshow.
+     * 
+     * @param frame output: the annotated frame, untouched if there is none
+     * @return true if a new frame was copied
+     */
+    bool take_latest(cv::Mat* frame);
+
+    /**
+     * @brief Gets the number of submitted, rendered and dropped frames
+     * 
+     * @return AnnotationStats 
+     */
+    AnnotationStats get_stats() const;
+
+    /**
+     * @brief Draws boxes labeled with their confidence onto a frame
+     * 
+     * @cite https://github.com/spmallick/learnopencv
+     * 
+     * @param detections detections in NN input coordinates
+     * @param img_dim NN input width and height
+     * @param frame frame of any size, drawn on in place
+     */
+    static void draw(const std::vector<Detection>& detections,
+      const std::array<int, 2>& img_dim, cv::Mat* frame);
+
+    /**
+     * @brief Output that appends frames to a video file, opened at the first frame's size
+     * 
+     * @param path video file path
+     * @param fps 
+     * @return Output 
+     * @throw InvalidFile from the output if the file cannot be opened
+     */
+    static Output video(const std::string& path, double fps);
+};
@@ -0,0 +1,124 @@
+/**
+ * @file BoundedQueue.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Bounded blocking queue header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <condition_variable>
+
+/**
+ * @brief Thread-safe FIFO with a fixed capacity. Used to hand work between pipeline stages.
+ * 
+ * @tparam T queued item type
+ */
+template <typename T>
+class BoundedQueue {
+ private:
+    std::deque<T> items{};
+    std::size_t capacity;
+    std::size_t max_depth{0};
+    bool closed{false};
+
+    mutable std::mutex mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+ public:
+    explicit BoundedQueue(std::size_t _capacity) :
+      capacity{_capacity > 0 ? _capacity : 1} {}
+
+    /**
+     * @brief Adds an item, blocking while the queue is full.
+     * 
+     * @param item 
+     * @return false if the queue was closed and the item was dropped.
+     */
+    bool push(T item) {
+      std::unique_lock<std::mutex> lock(mtx);
+      not_full.wait(lock, [this]() {
+        return closed || items.size() < capacity; });
+      if (closed) return false;
+      items.push_back(std::move(item));
+      if (items.size() > max_depth) max_depth = items.size();
+      not_empty.notify_one();
+      return true;
+    }
+
+    /**
+     * @brief Adds an item without blocking, evicting the oldest item when the queue is full.
+     * 
+     * @param item 
+     * @return number of items dropped: the evicted one, or the new one if the queue was closed.
+     */
+    std::size_t push_evict(T item) {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (closed) return 1;
+      std::size_t evicted = 0;
+      if (items.size() >= capacity) {
+        items.pop_front();
+        evicted = 1;
+      }
+      items.push_back(std::move(item));
+      if (items.size() > max_depth) max_depth = items.size();
+      not_empty.notify_one();
+      return evicted;
+    }
+
+    /**
+     * @brief Removes the oldest item, blocking while the queue is empty.
+     * 
+     * @param item output
+     * @return false once the queue is closed and fully drained.
+     */
+    bool pop(T* item) {
+      std::unique_lock<std::mutex> lock(mtx);
+      not_empty.wait(lock, [this]() { return closed || !items.empty(); });
+      if (items.empty()) return false;
+      *item = std::move(items.front());
+      items.pop_front();
+      not_full.notify_one();
+      return true;
+    }
+
+    /**
+     * @brief Rejects further pushes and wakes every waiting thread. Queued items can still be popped.
+     * 
+     */
+    void close() {
+      std::lock_guard<std::mutex> lock(mtx);
+      closed = true;
+      not_empty.notify_all();
+      not_full.notify_all();
+    }
+
+    /**
+     * @brief Gets the current number of queued items
+     * 
+     * @return std::size_t 
+     */
+    std::size_t size() const {
+      std::lock_guard<std::mutex> lock(mtx);
+      return items.size();
+    }
+
+    /**
+     * @brief Gets the highest number of items ever queued at once
+     * 
+     * @return std::size_t 
+     */
+    std::size_t get_max_depth() const {
+      std::lock_guard<std::mutex> lock(mtx);
+      return max_depth;
+    }
+};
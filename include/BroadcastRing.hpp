@@ -0,0 +1,164 @@
+/**
+ * @file BroadcastRing.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Lock-free single-producer multi-consumer broadcast ring header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Lock-free ring that one producer publishes into and any number of consumers each read in full.
+ * 
+ * @details publish() never waits: a consumer that falls more than the
+ * capacity behind loses the oldest items, and learns how many when it
+ * next reads. Each slot is guarded by a sequence number (a seqlock), and
+ * its item is stored as atomic words, so readers copy it without locks
+ * and detect when the producer overwrote it mid-copy.
+ * 
+ * @tparam T trivially copyable item type
+ */
+template <typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+      "BroadcastRing items are copied word by word.");
+
+ private:
+    static const std::size_t num_words =
+      (sizeof(T) + sizeof(std::uint64_t) - 1)/sizeof(std::uint64_t);
+
+    /**
+     * @brief sequence is 2n + 1 while item n is written and 2n + 2 once it is
+     * 
+     */
+    struct Slot {
+        std::atomic<std::uint64_t> sequence{0};
+        std::atomic<std::uint64_t> words[num_words];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::uint64_t mask;
+    std::uint64_t next{0};
+
+    /**
+     * @brief Number of items published. Kept on its own cache line, since every consumer polls it.
+     * 
+     */
+    alignas(64) std::atomic<std::uint64_t> published{0};
+
+ public:
+    /**
+     * @brief A consumer's position in the ring
+     * 
+     */
+    struct Cursor {
+        std::uint64_t next{0};
+    };
+
+    /**
+     * @brief Construct a new Broadcast Ring
+     * 
+     * @param capacity items kept for slow consumers, rounded up to a power of two
+     */
+    explicit BroadcastRing(std::size_t capacity) {
+      std::uint64_t size = 1;
+      while (size < capacity) size *= 2;
+      slots.reset(new Slot[size]);
+      mask = size - 1;
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    /**
+     * @brief Publishes an item. Only one thread may publish.
+     * 
+     * @param item
+     */
+    void publish(const T& item) {
+      std::uint64_t words[num_words] = {};
+      std::memcpy(words, &item, sizeof(T));
+      Slot& slot = slots[next & mask];
+      slot.sequence.store(2*next + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      for (std::size_t i = 0; i < num_words; i++)
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+      slot.sequence.store(2*next + 2, std::memory_order_release);
+      published.store(++next, std::memory_order_release);
+    }
+
+    /**
+     * @brief Starts a cursor at the next item to be published
+     * 
+     * @return Cursor
+     */
+    Cursor tail() const {
+      return Cursor{published.load(std::memory_order_acquire)};
+    }
+
+    /**
+     * @brief Reads the item at a cursor and advances it. Never blocks.
+     * 
+     * @param cursor input/output: position of the consumer
+     * @param item output
+     * @param lost output: items overwritten before the consumer read them
+     * @return false if no item was published since the cursor
+     */
+    bool read(Cursor* cursor, T* item, std::uint64_t* lost) const {
+      *lost = 0;
+      while (true) {
+        std::uint64_t head = published.load(std::memory_order_acquire);
+        if (cursor->next >= head) return false;
+        if (head - cursor->next > mask + 1) {
+          *lost += head - (mask + 1) - cursor->next;
+          cursor->next = head - (mask + 1);
+        }
+
+        const Slot& slot = slots[cursor->next & mask];
+        std::uint64_t expected = 2*cursor->next + 2;
+        std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        std::uint64_t words[num_words];
+        for (std::size_t i = 0; i < num_words; i++)
+          words[i] = slot.words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        std::uint64_t after = slot.sequence.load(std::memory_order_relaxed);
+        if (before == expected && after == expected) {
+          std::memcpy(item, words, sizeof(T));
+          cursor->next++;
+          return true;
+        }
+        // Overwritten while reading: skip it and catch up
+        (*lost)++;
+        cursor->next++;
+      }
+    }
+
+    /**
+     * @brief Gets the number of items published so far
+     * 
+     * @return std::uint64_t
+     */
+    std::uint64_t size() const {
+      return published.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the number of items kept for slow consumers
+     * 
+     * @return std::size_t
+     */
+    std::size_t capacity() const {
+      return static_cast<std::size_t>(mask + 1);
+    }
+};
@@ -0,0 +1,140 @@
+/**
+ * @file CameraRig.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Multi-camera rig header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "./HumanDetector.hpp"
+#include "./DetectorPool.hpp"
+#include "./PositionEstimator.hpp"
+#include "./Detection.hpp"
+
+/**
+ * @brief Several cameras on one robot, each with its own extrinsics and intrinsics, whose detections are fused into a single list of robot-frame positions.
+ * 
+ * @details Camera k reads the robot parameters with every CAMERAk_NAME
+ * entry overriding NAME, e.g. CAMERA1_PITCH_CAM2ROBOT_CENTER. Cameras are
+ * numbered from 0 to RIG_CAMERAS - 1. Only the position estimators read
+ * these blocks; every camera shares the detector settings.
+ * 
+ * Each call takes one frame per camera from the same capture, so the
+ * returned positions all describe the same instant. People seen by two
+ * cameras with overlapping fields of view are merged when their
+ * positions are closer than RIG_MERGE_DISTANCE.
+ */
+class CameraRig {
+ private:
+    std::vector<PositionEstimator> estimators{};
+    double merge_distance{0.5};
+
+    /**
+     * @brief Detections and positions of each camera, reused by every call
+     * 
+     */
+    std::vector<std::vector<Detection> > detections{};
+    std::vector<std::vector<std::array<double, 3> > > camera_xyz{};
+
+    /**
+     * @brief Merge bookkeeping: members of each merged position and the last camera that joined it
+     * 
+     */
+    std::vector<int> merged_count{};
+    std::vector<int> merged_camera{};
+
+    void check_frames(const std::vector<cv::Mat>& frames) const;
+
+ public:
+    /**
+     * @brief Builds one position estimator per camera block
+     * 
+     * @param robot_params parsed robot parameters, with RIG_CAMERAS set
+     */
+    explicit CameraRig(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Gets the parameters camera k sees: the shared ones, overridden by its CAMERAk_ block
+     * 
+     * @param robot_params parsed robot parameters
+     * @param camera camera index
+     * @return std::unordered_map<std::string, double>
+     */
+    static std::unordered_map<std::string, double> camera_params(
+      const std::unordered_map<std::string, double>& robot_params,
+      int camera);
+
+    /**
+     * @brief Detects people in all cameras with a single batched forward pass and fuses their positions.
+     * 
+     * @details The frames of every camera go through the network as one
+     * NCHW batch (see HumanDetector::detect_batch), so on a GPU the rig
+     * costs about one camera's latency.
+     * 
+     * @param detector detector shared by all cameras
+     * @param frames one frame per camera, in camera order
+     * @param all_xyz output: merged x, y, z positions in ROBOT frame UNIT: [m], cleared first
+     */
+    void get_xyz(HumanDetector* detector, const std::vector<cv::Mat>& frames,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Detects people in all cameras concurrently, one thread and leased detector per camera, and fuses their positions.
+     * 
+     * @details Suited to CPU inference, where a pool with one instance
+     * per camera and cores split between them (see DetectorPool) keeps
+     * every core busy. A worker error is rethrown once all cameras are
+     * done.
+     * 
+     * @param pool detectors leased by the camera threads
+     * @param frames one frame per camera, in camera order
+     * @param all_xyz output: merged x, y, z positions in ROBOT frame UNIT: [m], cleared first
+     */
+    void get_xyz(DetectorPool* pool, const std::vector<cv::Mat>& frames,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Merges the positions of every camera, averaging people seen by several cameras.
+     * 
+     * @details Each position joins the closest merged position within
+     * RIG_MERGE_DISTANCE that no earlier member of the same camera joined,
+     * since one camera never sees a person twice.
+     * 
+     * @param per_camera robot-frame positions seen by each camera
+     * @param all_xyz output: merged positions, cleared first
+     */
+    void merge(const std::vector<std::vector<std::array<double, 3> > >&
+      per_camera, std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Gets the number of cameras
+     * 
+     * @return std::size_t
+     */
+    std::size_t size() const {
+      return estimators.size();
+    }
+
+    /**
+     * @brief Gets the position estimator of a camera
+     * 
+     * @param camera camera index
+     * @return PositionEstimator&
+     */
+    PositionEstimator& get_estimator(std::size_t camera) {
+      return estimators.at(camera);
+    }
+};
@@ -0,0 +1,97 @@
+/**
+ * @file DarknetModel.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Darknet Model header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include "MappedFile.hpp"
+
+/**
+ * @brief YOLO cfg and weights loaded once, so several networks can be built without touching the files again.
+ * 
+ * @details The weights are memory mapped read-only while the model is
+ * held, and unmapped when it is destroyed. Networks built from the same
+ * model share one copy of the parsed weight blobs. OpenCV still keeps a
+ * per-network copy of the convolutions with batch norm folded in, so
+ * each extra network costs about half of what a separate load does.
+ */
+class DarknetModel {
+ private:
+    std::vector<char> cfg{};
+    MappedFile weights;
+
+    /**
+     * @brief Weight blobs of every layer of the first network built, which later networks point at instead of their own parsed copy
+     * 
+     */
+    mutable std::mutex blobs_mtx;
+    mutable std::vector<std::vector<cv::Mat> > shared_blobs{};
+
+    /**
+     * @brief Time spent loading the model UNIT: [ms]
+     * 
+     */
+    double load_ms{};
+
+    /**
+     * @brief Reads a whole file into memory
+     * 
+     * @param path 
+     * @return std::vector<char> file contents
+     * @throw InvalidFile if the file cannot be read
+     */
+    static std::vector<char> read_file(const std::string& path);
+
+    /**
+     * @brief Loads the model and records the time since start
+     * 
+     */
+    DarknetModel(const std::string& cfg_path, const std::string& weight_path,
+      std::chrono::steady_clock::time_point start);
+
+ public:
+    DarknetModel(const std::string& cfg_path, const std::string& weight_path) :
+      DarknetModel(cfg_path, weight_path, std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Builds a new network instance from the in-memory model, sharing the weight blobs of the networks built before it. Thread-safe.
+     * 
+     * @details The blobs stay alive as long as any network built from
+     * the model does, even after the model itself is destroyed.
+     * 
+     * @return cv::dnn::Net 
+     */
+    cv::dnn::Net create_net() const;
+
+    /**
+     * @brief Gets the time spent reading the cfg and mapping the weights
+     * 
+     * @return double UNIT: [ms]
+     */
+    double get_load_ms() const {
+      return load_ms;
+    }
+
+    /**
+     * @brief Gets the size of the mapped weights
+     * 
+     * @return std::size_t UNIT: [bytes]
+     */
+    std::size_t get_weight_bytes() const {
+      return weights.size();
+    }
+};
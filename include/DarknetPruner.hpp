@@ -0,0 +1,146 @@
+/**
+ * @file DarknetPruner.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Darknet Pruner header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include "MappedFile.hpp"
+
+/**
+ * @brief One [section] of a Darknet cfg, with its raw key = value lines
+ * 
+ */
+struct CfgSection {
+    std::string type{};
+    std::vector<std::string> lines{};
+
+    /**
+     * @brief Gets the value of a key
+     * 
+     * @param key 
+     * @param fallback returned when the key is missing
+     * @return std::string value, without surrounding whitespace
+     */
+    std::string get(const std::string& key, const std::string& fallback)
+      const;
+
+    /**
+     * @brief Replaces the value of an existing key
+     * 
+     * @param key 
+     * @param value 
+     */
+    void set(const std::string& key, const std::string& value);
+};
+
+/**
+ * @brief What pruning the YOLO heads removed
+ * 
+ */
+struct PruneReport {
+    std::size_t heads{0};
+    int head_filters_before{0};
+    int head_filters_after{0};
+
+    /**
+     * @brief Weight file sizes UNIT: [bytes]
+     * 
+     */
+    std::size_t weight_bytes_before{0};
+    std::size_t weight_bytes_after{0};
+};
+
+/**
+ * @brief Rewrites a Darknet YOLO model so its heads only predict one class.
+ * 
+ * @details Every [yolo] layer reads the [convolutional] right before it,
+ * which outputs (5 + classes) channels per anchor: box, objectness and
+ * one score per class. Each class score is sigmoid(logit)*objectness on
+ * its own, so dropping the other classes' filters leaves the kept class'
+ * outputs unchanged. All other layers are copied as is.
+ */
+class DarknetPruner {
+ private:
+    std::vector<CfgSection> sections{};
+    MappedFile weights;
+    std::size_t header_bytes{0};
+
+    /**
+     * @brief Location of one convolution in the weight file
+     * 
+     * @details The layout is biases, then scales, rolling means and
+     * rolling variances when batch normalized, then the filters, each
+     * row_floats long.
+     */
+    struct ConvBlock {
+        std::size_t section;
+        std::size_t offset;
+        int filters;
+        std::size_t row_floats;
+        bool batch_normalize;
+
+        /**
+         * @brief Anchors and classes of the [yolo] layer it feeds, 0 if none
+         * 
+         */
+        int anchors;
+        int classes;
+    };
+    std::vector<ConvBlock> convs{};
+
+    /**
+     * @brief Reads the cfg into sections
+     * 
+     * @throw InvalidFile if the file cannot be read or has no [net] section
+     */
+    static std::vector<CfgSection> read_cfg(const std::string& path);
+
+    /**
+     * @brief Follows the channel count through the layers to locate every convolution's weights
+     * 
+     * @throw InvalidFile on unsupported layers or if the weights do not match the cfg
+     */
+    void index_weights();
+
+ public:
+    /**
+     * @brief Reads a Darknet model
+     * 
+     * @param cfg_path 
+     * @param weight_path 
+     * @throw InvalidFile if the files cannot be read or do not match
+     */
+    DarknetPruner(const std::string& cfg_path, const std::string& weight_path);
+
+    /**
+     * @brief Writes the model with only one class left in every YOLO head
+     * 
+     * @param keep_class index of the class to keep (0 for "person" in coco.names)
+     * @param cfg_path output cfg
+     * @param weight_path output weights
+     * @return PruneReport 
+     * @throw std::invalid_argument if the class index is out of range
+     * @throw InvalidFile if an output file cannot be written
+     */
+    PruneReport prune(int keep_class, const std::string& cfg_path,
+      const std::string& weight_path) const;
+
+    /**
+     * @brief Gets the number of [yolo] heads
+     * 
+     * @return std::size_t 
+     */
+    std::size_t get_head_count() const;
+};
@@ -15,28 +15,25 @@
 /**
  * @brief This struct will be used to pass detection information between the human detector and position estimator classes. See the UML for more information. 
  * 
+ * @details Trivially copyable, so vectors of detections are copied in
+ * bulk. See DetectionBatch for detections with confidence and class.
  */
 struct Detection {
     int x{0}, y{0};
     int width{0}, height{0};
-    Detection& operator=(const Detection& detect);
+    // Detector score, 0 when unknown (e.g. labels)
+    float confidence{0};
     Detection operator+(const Detection& detect) const;
     Detection operator-(const Detection& detect) const;
     Detection& operator+=(const Detection& detect);
 
     Detection() {}
 
-    Detection(int x_, int y_, int w, int h) {
+    Detection(int x_, int y_, int w, int h, float conf = 0) {
         this->x = x_;
         this->y = y_;
         this->width = w;
         this->height = h;
-    }
-
-    Detection(const Detection& detect) {
-        this->x = detect.x;
-        this->y = detect.y;
-        this->width = detect.width;
-        this->height = detect.height;
+        this->confidence = conf;
     }
 };
@@ -0,0 +1,161 @@
+/**
+ * @file DetectionBatch.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection Batch header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+#include "./Detection.hpp"
+
+static_assert(std::is_trivially_copyable<Detection>::value,
+    "Detection is copied with memcpy-like bulk copies.");
+
+/**
+ * @brief Allocator whose blocks start on a cache line, so SIMD loops can use aligned loads
+ * 
+ * @tparam T element type
+ */
+template <typename T>
+struct AlignedAllocator {
+    typedef T value_type;
+    static const std::size_t alignment = 64;
+
+    AlignedAllocator() {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+      void* ptr = nullptr;
+      std::size_t bytes = n > 0 ? n*sizeof(T) : 1;
+      if (posix_memalign(&ptr, alignment, bytes))
+        throw std::bad_alloc();
+      return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, std::size_t) {
+      std::free(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const {
+      return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const {
+      return false;
+    }
+};
+
+/**
+ * @brief Detections stored as structure of arrays: one aligned, contiguous array per field.
+ * 
+ * @details Boxes are in NN input pixels, as float so fractional boxes
+ * (e.g. from tracking) are kept. Each detection also carries its
+ * confidence, class index and the id of the frame it came from, so one
+ * batch can hold several frames. Capacity is kept by clear(), so a reused
+ * batch stops allocating once it has grown.
+ */
+class DetectionBatch {
+ public:
+    template <typename T>
+    using Array = std::vector<T, AlignedAllocator<T> >;
+
+ private:
+    Array<float> x_{}, y_{}, width_{}, height_{}, confidence_{};
+    Array<int> class_id_{}, frame_id_{};
+
+ public:
+    DetectionBatch() {}
+
+    /**
+     * @brief Construct a batch from detections, e.g. labels or older APIs
+     * 
+     * @param detections 
+     * @param frame_id frame id of every detection
+     */
+    explicit DetectionBatch(const std::vector<Detection>& detections,
+      int frame_id = 0);
+
+    std::size_t size() const {
+      return x_.size();
+    }
+
+    bool empty() const {
+      return x_.empty();
+    }
+
+    /**
+     * @brief Removes every detection, keeping the capacity
+     * 
+     */
+    void clear();
+
+    void reserve(std::size_t n);
+
+    /**
+     * @brief Adds one detection
+     * 
+     * @param x left UNIT: [px]
+     * @param y top UNIT: [px]
+     * @param width UNIT: [px]
+     * @param height UNIT: [px]
+     * @param confidence 
+     * @param class_id index in the class names file
+     * @param frame_id 
+     */
+    void push_back(float x, float y, float width, float height,
+      float confidence = 1.f, int class_id = 0, int frame_id = 0);
+
+    /**
+     * @brief Appends detections, keeping their confidence
+     * 
+     * @param detections 
+     * @param frame_id frame id of every appended detection
+     */
+    void append(const std::vector<Detection>& detections, int frame_id = 0);
+
+    /**
+     * @brief Gets one detection, with its box rounded to whole pixels
+     * 
+     * @param i 
+     * @return Detection 
+     */
+    Detection get(std::size_t i) const;
+
+    /**
+     * @brief Writes every detection, with boxes rounded to whole pixels
+     * 
+     * @param detections output, cleared first
+     */
+    void to_detections(std::vector<Detection>* detections) const;
+
+    const float* x() const { return x_.data(); }
+    const float* y() const { return y_.data(); }
+    const float* width() const { return width_.data(); }
+    const float* height() const { return height_.data(); }
+    const float* confidence() const { return confidence_.data(); }
+    const int* class_id() const { return class_id_.data(); }
+    const int* frame_id() const { return frame_id_.data(); }
+
+    float* x() { return x_.data(); }
+    float* y() { return y_.data(); }
+    float* width() { return width_.data(); }
+    float* height() { return height_.data(); }
+    float* confidence() { return confidence_.data(); }
+    int* class_id() { return class_id_.data(); }
+    int* frame_id() { return frame_id_.data(); }
+};
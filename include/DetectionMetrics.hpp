@@ -0,0 +1,72 @@
+/**
+ * @file DetectionMetrics.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection accuracy metrics header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "./Detection.hpp"
+#include "./DetectionBatch.hpp"
+#include "./LabelParser.hpp"
+#include "./HumanDetector.hpp"
+
+/**
+ * @brief Accuracy of a detector over labeled frames, as measured by HumanDetectionAccuracyTest.
+ * 
+ */
+struct AccuracyReport {
+    int num_imgs{0};
+    double percent_detected{0};
+    double average_x_diff{0};
+    double average_y_diff{0};
+    double average_width_diff{0};
+    double average_height_diff{0};
+
+    /**
+     * @brief Average detection time per frame UNIT: [ms]
+     * 
+     */
+    double ms_per_frame{0};
+};
+
+/**
+ * @brief Gets the difference between a detection and the closest labeled detection
+ * 
+ * @param detection 
+ * @param all_true labeled detections in the frame
+ * @return Detection absolute difference of each field
+ */
+Detection get_closest_diff(const Detection& detection,
+  const std::vector<Detection>& all_true);
+
+/**
+ * @brief Gets the difference between a detection and the closest labeled detection in a batch
+ * 
+ * @param detection 
+ * @param all_true labeled detections in the frame, boxes rounded to whole pixels
+ * @return Detection absolute difference of each field
+ */
+Detection get_closest_diff(const Detection& detection,
+  const DetectionBatch& all_true);
+
+/**
+ * @brief Runs a detector over labeled frames and compares it with the labels.
+ * 
+ * @param detector 
+ * @param labels labeled frames from LabelParser
+ * @param max_imgs maximum number of frames to evaluate
+ * @return AccuracyReport 
+ */
+AccuracyReport evaluate_accuracy(HumanDetector* detector,
+  const std::vector<std::shared_ptr<TestImage> >& labels,
+  std::size_t max_imgs = 51);
@@ -0,0 +1,159 @@
+/**
+ * @file DetectionTracker.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection Tracker header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "Detection.hpp"
+
+/**
+ * @brief Propagates keyframe detections through the frames in between, and decides when the next keyframe is due.
+ * 
+ * @details Each detection is tracked with median flow: a grid of points
+ * inside the box is followed with pyramidal Lucas-Kanade optical flow,
+ * forward and backward. Points whose round trip drifts are rejected. The
+ * median displacement and the median change of pairwise distances give
+ * the box motion and scale. The box center is then smoothed by a
+ * constant-velocity Kalman filter per axis.
+ *
+ * The confidence of a frame is the smallest fraction of reliable points
+ * over all tracks. Tracking fails, and a keyframe is requested right
+ * away, when it drops below the minimum. The interval, the number of
+ * tracked frames between keyframes, grows by one after a span whose
+ * confidence stayed high and halves after a span that came close to the
+ * minimum.
+ */
+class DetectionTracker {
+ private:
+    /**
+     * @brief Constant-velocity Kalman filter of one box center coordinate
+     * 
+     */
+    struct AxisFilter {
+        float pos{0};
+        float vel{0};
+        float p00{4}, p01{0}, p11{4};
+
+        void predict();
+        void update(float measured);
+    };
+
+    /**
+     * @brief A tracked box. The median flow center is kept apart from the filtered one, so that filter lag does not feed back into the measurements.
+     * 
+     */
+    struct Track {
+        AxisFilter cx{};
+        AxisFilter cy{};
+        float flow_x{0};
+        float flow_y{0};
+        float width{0};
+        float height{0};
+        float score{0};
+    };
+
+    int max_interval;
+    double min_confidence;
+
+    int interval{1};
+    int frames_since_keyframe{0};
+    bool failed{true};
+    double confidence{0};
+    double span_confidence{1};
+
+    cv::Mat prev_gray{};
+    std::vector<Track> tracks{};
+
+    std::vector<cv::Point2f> prev_points{};
+    std::vector<cv::Point2f> next_points{};
+    std::vector<cv::Point2f> back_points{};
+    std::vector<unsigned char> status{};
+    std::vector<unsigned char> back_status{};
+    std::vector<float> errors{};
+
+    /**
+     * @brief Adds a grid of points inside a box to prev_points
+     * 
+     */
+    void add_grid_points(const Track& track);
+
+ public:
+    /**
+     * @brief Points followed per track, as a grid_size x grid_size grid
+     * 
+     */
+    static const int grid_size = 5;
+
+    /**
+     * @brief Construct a new Detection Tracker
+     * 
+     * @param _max_interval largest number of tracked frames between keyframes
+     * @param _min_confidence smallest fraction of reliable points per track before tracking is considered lost
+     * @throw std::invalid_argument if max_interval < 1 or min_confidence is not in [0, 1]
+     */
+    DetectionTracker(int _max_interval, double _min_confidence);
+
+    /**
+     * @brief Construct a tracker from the TRACK_* robot parameters
+     * 
+     */
+    explicit DetectionTracker(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Whether the next frame must be a keyframe run through the network
+     * 
+     * @return bool 
+     */
+    bool needs_keyframe() const {
+      return failed || frames_since_keyframe >= interval;
+    }
+
+    /**
+     * @brief Starts tracking the detections of a keyframe
+     * 
+     * @param gray 8-bit grayscale keyframe, in the coordinates of the detections
+     * @param detections detections of the keyframe
+     */
+    void reset(const cv::Mat& gray, const std::vector<Detection>& detections);
+
+    /**
+     * @brief Propagates the tracked detections to the next frame
+     * 
+     * @param gray 8-bit grayscale frame, the same size as the keyframe
+     * @param detections output: tracked detections
+     * @return false if tracking failed and a keyframe is needed now
+     */
+    bool track(const cv::Mat& gray, std::vector<Detection>* detections);
+
+    /**
+     * @brief Gets the current keyframe interval
+     * 
+     * @return int UNIT: [frames]
+     */
+    int get_interval() const {
+      return interval;
+    }
+
+    /**
+     * @brief Gets the confidence of the last tracked frame
+     * 
+     * @return double fraction of reliable points of the weakest track
+     */
+    double get_confidence() const {
+      return confidence;
+    }
+};
@@ -0,0 +1,98 @@
+/**
+ * @file DetectorPool.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detector Pool header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "./LeasePool.hpp"
+#include "./DarknetModel.hpp"
+#include "./WeightStore.hpp"
+#include "./HumanDetector.hpp"
+#include "./StageTimers.hpp"
+
+/**
+ * @brief Pool of HumanDetector instances that concurrent callers lease one at a time.
+ * 
+ * @details The model is taken from the WeightStore and held while the
+ * instances are built, so they all share its parsed weight blobs (see
+ * DarknetModel). It is unmapped once the pool is constructed.
+ * The pool does not change OpenCV's thread count, which is process-wide:
+ * to avoid oversubscribing the cores, call cv::setNumThreads once with the
+ * cores divided by the number of instances.
+ */
+class DetectorPool {
+ private:
+    LeasePool<HumanDetector> pool;
+
+    /**
+     * @brief Builds num_instances detectors from a single in-memory model
+     * 
+     */
+    static std::vector<std::unique_ptr<HumanDetector> > make_detectors(
+      const std::unordered_map<std::string, double>& robot_params,
+      const std::string& coco_name_path, const DarknetModel& model,
+      std::size_t num_instances);
+
+ public:
+    typedef LeasePool<HumanDetector>::Lease Lease;
+
+    /**
+     * @brief Construct a new Detector Pool
+     * 
+     * @param robot_params parsed robot parameters
+     * @param coco_name_path path to the class names
+     * @param yolo_cfg_path path to the YOLO cfg
+     * @param yolo_weight_path path to the YOLO weights
+     * @param num_instances number of network instances
+     */
+    DetectorPool(const std::unordered_map<std::string, double>& robot_params,
+      const std::string& coco_name_path, const std::string& yolo_cfg_path,
+      const std::string& yolo_weight_path, std::size_t num_instances);
+
+    /**
+     * @brief Leases a detector, blocking until one is free.
+     * 
+     * @return Lease 
+     */
+    Lease acquire() {
+      return pool.acquire();
+    }
+
+    /**
+     * @brief Leases a detector if one is free right now.
+     * 
+     * @return Lease, empty if every detector is leased
+     */
+    Lease try_acquire() {
+      return pool.try_acquire();
+    }
+
+    /**
+     * @brief Sets where every detector records its stage latencies. Waits until every detector is returned.
+     * 
+     * @param timers nullptr to stop recording
+     */
+    void set_stage_timers(StageTimers* timers);
+
+    /**
+     * @brief Gets the number of detector instances
+     * 
+     * @return std::size_t 
+     */
+    std::size_t size() const {
+      return pool.size();
+    }
+};
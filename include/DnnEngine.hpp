@@ -0,0 +1,122 @@
+/**
+ * @file DnnEngine.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief OpenCV DNN inference engines header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "InferenceEngine.hpp"
+#include "DarknetModel.hpp"
+#include "WeightStore.hpp"
+
+/**
+ * @brief Inference through an OpenCV cv::dnn::Net on a chosen backend and target.
+ * 
+ */
+class DnnEngine : public InferenceEngine {
+ private:
+    cv::dnn::Net net;
+    std::vector<cv::String> output_names{};
+    std::string name;
+
+ protected:
+    /**
+     * @brief Construct an engine around a loaded network
+     * 
+     * @param _net loaded network
+     * @param backend cv::dnn::Backend id
+     * @param target cv::dnn::Target id
+     * @param format model format, used in the engine name
+     * @throw std::invalid_argument if the backend cannot run on the target
+     */
+    DnnEngine(cv::dnn::Net _net, int backend, int target,
+      const std::string& format);
+
+ public:
+    void set_input(const cv::Mat& blob) override;
+
+    void forward(std::vector<cv::Mat>* outputs) override;
+
+    std::string get_name() const override {
+      return name;
+    }
+
+    /**
+     * @brief Reads the DNN_BACKEND robot parameter
+     * 
+     * @param robot_params parsed robot parameters
+     * @return cv::dnn::Backend id, DNN_BACKEND_DEFAULT when it is not set
+     */
+    static int get_backend(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Reads the DNN_TARGET robot parameter
+     * 
+     * @param robot_params parsed robot parameters
+     * @return cv::dnn::Target id, DNN_TARGET_CPU when it is not set
+     */
+    static int get_target(
+      const std::unordered_map<std::string, double>& robot_params);
+};
+
+/**
+ * @brief Darknet cfg and weights run through OpenCV DNN
+ * 
+ */
+class DarknetEngine : public DnnEngine {
+ public:
+    DarknetEngine(const std::string& cfg_path, const std::string& weight_path,
+      int backend = cv::dnn::DNN_BACKEND_DEFAULT,
+      int target = cv::dnn::DNN_TARGET_CPU) :
+      DarknetEngine(*WeightStore::get(cfg_path, weight_path), backend,
+        target) {}
+
+    /**
+     * @brief Construct an engine from a model already loaded in memory. No model file is read.
+     * 
+     */
+    DarknetEngine(const DarknetModel& model,
+      int backend = cv::dnn::DNN_BACKEND_DEFAULT,
+      int target = cv::dnn::DNN_TARGET_CPU) :
+      DnnEngine(model.create_net(), backend, target, "darknet") {}
+};
+
+/**
+ * @brief ONNX model run through OpenCV DNN
+ * 
+ * @details The model must output YOLO region rows as [rows, cols] or
+ * [batch, rows, cols].
+ */
+class OnnxEngine : public DnnEngine {
+ private:
+    // Int8Engine quantizes the FP32 network read here
+    friend class Int8Engine;
+
+    /**
+     * @brief Reads the ONNX model
+     * 
+     * @param model_path 
+     * @return cv::dnn::Net 
+     * @throw InvalidFile if the model cannot be read
+     */
+    static cv::dnn::Net read_net(const std::string& model_path);
+
+ public:
+    explicit OnnxEngine(const std::string& model_path,
+      int backend = cv::dnn::DNN_BACKEND_DEFAULT,
+      int target = cv::dnn::DNN_TARGET_CPU) :
+      DnnEngine(read_net(model_path), backend, target, "onnx") {}
+};
@@ -0,0 +1,102 @@
+/**
+ * @file FramePreprocessor.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame Preprocessor header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Maps normalized letterboxed NN coordinates back to the squashed (non-letterboxed) input frame.
+ * 
+ * @details squashed = (letterboxed - offset)*gain. The identity mapping is
+ * used when the input is not letterboxed.
+ */
+struct Letterbox {
+    std::array<float, 2> offset{{0.f, 0.f}};
+    std::array<float, 2> gain{{1.f, 1.f}};
+};
+
+/**
+ * @brief Fused single-pass frame preprocessing for the NN input.
+ * 
+ * @details Bilinear resize (optionally letterboxed), BGR->RGB, 1/255
+ * scaling and the HWC->CHW transpose are done in one pass straight into a
+ * caller-owned float tensor. Resize tables are only rebuilt when the source
+ * size changes. The vertical pass uses SSE2/AVX2/NEON and the horizontal
+ * pass uses AVX2 gathers when available.
+ */
+class FramePreprocessor {
+ private:
+    int dst_w;
+    int dst_h;
+    bool letterbox;
+    float pad_value{0.5f};
+
+    int src_w{0};
+    int src_h{0};
+    int content_w{0};
+    int content_h{0};
+    int pad_x{0};
+    int pad_y{0};
+    Letterbox mapping{};
+
+    std::vector<int> x_ofs0{};
+    std::vector<int> x_ofs1{};
+    std::vector<float> x_wts{};
+    std::vector<int> y_idx0{};
+    std::vector<int> y_idx1{};
+    std::vector<float> y_wts{};
+    std::vector<float> vertical_row{};
+
+    /**
+     * @brief Builds the bilinear resize tables for a new source size.
+     * 
+     * @param width source width
+     * @param height source height
+     */
+    void build_tables(int width, int height);
+
+    /**
+     * @brief Fills the letterbox border of every plane with the pad value.
+     * 
+     * @param dst CHW tensor
+     */
+    void fill_padding(float* dst) const;
+
+ public:
+    FramePreprocessor(int _dst_w, int _dst_h, bool _letterbox = false) :
+      dst_w{_dst_w}, dst_h{_dst_h}, letterbox{_letterbox} {}
+
+    /**
+     * @brief Preprocesses one 8-bit BGR frame into a planar RGB float tensor.
+     * 
+     * @param bgr first pixel of the source frame
+     * @param width source width
+     * @param height source height
+     * @param step source row stride UNIT: [bytes]
+     * @param dst CHW tensor of 3*dst_h*dst_w floats
+     */
+    void run(const uint8_t* bgr, int width, int height, std::size_t step,
+      float* dst);
+
+    /**
+     * @brief Gets the letterbox mapping of the last preprocessed frame
+     * 
+     * @return const Letterbox& 
+     */
+    const Letterbox& get_letterbox() const {
+      return mapping;
+    }
+};
@@ -0,0 +1,192 @@
+/**
+ * @file FrameSource.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame Source header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Frames decoded and handed out by a frame source
+ * 
+ */
+struct FrameSourceStats {
+    std::size_t decoded{0};
+    std::size_t delivered{0};
+
+    /**
+     * @brief Frames of a live source overwritten before they were read
+     * 
+     */
+    std::size_t dropped{0};
+
+    /**
+     * @brief Total time spent decoding UNIT: [ms]
+     * 
+     */
+    double decode_ms{0};
+
+    /**
+     * @brief Frames decoded per second of decoding, the most the source can deliver
+     * 
+     */
+    double decode_fps{0};
+
+    /**
+     * @brief Frames read per second since the source started
+     * 
+     */
+    double throughput_fps{0};
+};
+
+/**
+ * @brief Decodes frames ahead of the caller on its own thread, into a fixed ring of reusable buffers.
+ * 
+ * @details A file source (directory, video) waits while the ring is
+ * full, so no frame is lost. A live source (camera) keeps decoding at the
+ * device rate and overwrites the oldest unread frame, so read() always
+ * returns recent frames. Buffers are swapped in and out of the ring and
+ * never copied: once every buffer has grown to the frame size, decoding
+ * allocates nothing.
+ */
+class FrameSource {
+ public:
+    /**
+     * @brief Decodes the next frame into the buffer and sets its capture time, on the source's thread
+     * 
+     * @return false once there are no more frames
+     */
+    typedef std::function<bool(cv::Mat*, double*)> Decoder;
+
+ private:
+    struct Slot {
+        cv::Mat image;
+        double timestamp{0};
+        std::chrono::steady_clock::time_point arrival{};
+    };
+
+    Decoder decode;
+    bool live;
+
+    /**
+     * @brief Ring of decoded frames, the unread ones starting at head
+     * 
+     */
+    std::vector<Slot> ring;
+    std::size_t head{0};
+    std::size_t unread{0};
+    bool closed{false};
+    bool finished{false};
+
+    mutable std::mutex mtx;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+    FrameSourceStats stats{};
+    std::chrono::steady_clock::time_point start_time;
+    std::exception_ptr worker_error{nullptr};
+    std::thread worker;
+
+    void decode_loop();
+
+ public:
+    /**
+     * @brief Construct a new Frame Source and start decoding
+     * 
+     * @param _decode produces the frames
+     * @param _live overwrite the oldest unread frame instead of waiting when the ring is full
+     * @param capacity frames decoded ahead of the caller
+     */
+    FrameSource(Decoder _decode, bool _live, std::size_t capacity = 4);
+
+    /**
+     * @brief Stops decoding and joins the thread
+     * 
+     */
+    ~FrameSource();
+
+    FrameSource(const FrameSource&) = delete;
+    FrameSource& operator=(const FrameSource&) = delete;
+
+    /**
+     * @brief Gets the oldest unread frame, blocking until one is decoded.
+     * 
+     * @details The frame is swapped into the caller's buffer, and the
+     * buffer's previous data goes back to the ring to be decoded into.
+     * Passing the same buffer every time keeps decoding allocation free.
+     * Clone a frame that must outlive the next read.
+     * 
+     * @param frame input/output: the previous frame in, the next frame out
+     * @param timestamp output: capture time of the frame UNIT: [s]
+     * @param arrival output: when decoding of the frame started, so the time spent decoding and queued is counted. Ignored if null.
+     * @return false once the source is exhausted or closed and every decoded frame has been read.
+     * @throw the exception raised by the decoder, once the frames before it have been read
+     */
+    bool read(cv::Mat* frame, double* timestamp,
+      std::chrono::steady_clock::time_point* arrival = nullptr);
+
+    /**
+     * @brief Stops decoding. Frames already decoded can still be read.
+     * 
+     */
+    void close();
+
+    /**
+     * @brief Gets the decoded, delivered and dropped frames and the decode rate
+     * 
+     * @return FrameSourceStats
+     */
+    FrameSourceStats get_stats() const;
+
+    /**
+     * @brief File source over the images of a directory, in natural file name order (1_2.png before 1_10.png)
+     * 
+     * @param path directory of images
+     * @param fps frame rate the images were captured at, for the timestamps
+     * @param capacity frames decoded ahead of the caller
+     * @return std::unique_ptr<FrameSource>
+     * @throw InvalidFile if the directory does not exist
+     * @throw std::invalid_argument if fps is not positive
+     */
+    static std::unique_ptr<FrameSource> directory(const std::string& path,
+      double fps, std::size_t capacity = 4);
+
+    /**
+     * @brief File source over a video file, timestamped from the video's own clock
+     * 
+     * @param path video file path
+     * @param capacity frames decoded ahead of the caller
+     * @return std::unique_ptr<FrameSource>
+     * @throw InvalidFile if the video cannot be opened
+     */
+    static std::unique_ptr<FrameSource> video(const std::string& path,
+      std::size_t capacity = 4);
+
+    /**
+     * @brief Live source over a camera, timestamped with std::chrono::steady_clock when each frame is grabbed
+     * 
+     * @param device camera index
+     * @param capacity frames kept for the caller before the oldest is dropped
+     * @return std::unique_ptr<FrameSource>
+     * @throw InvalidFile if the camera cannot be opened
+     */
+    static std::unique_ptr<FrameSource> camera(int device,
+      std::size_t capacity = 2);
+};
@@ -0,0 +1,150 @@
+/**
+ * @file GroundRangeEstimator.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Ground-plane range estimator header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <eigen3/Eigen/Dense>
+
+#include <array>
+#include <cstddef>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Estimates range from where a person's feet meet the floor, and fuses it with the box-height estimate.
+ * 
+ * @details The ray through the bottom center of a box is intersected
+ * with the floor, CAM_HEIGHT below the camera. In the robot frame y points
+ * down and PITCH_CAM2ROBOT_CENTER rotates about that axis, so the
+ * intersection depends on the image row only, and its inverse depth is
+ * linear in the row: the per-row table reduces to a slope and an offset.
+ * 
+ * The box-height estimate is off for children, crouching people and
+ * boxes cut by the frame edge; the ground estimate needs visible feet.
+ * Both measure inverse depth linearly (box height and foot row are
+ * proportional to 1/depth), so they are fused by inverse variance in
+ * inverse depth, where the ground variance is constant. Either is
+ * dropped when the box is cut on its side.
+ */
+class GroundRangeEstimator {
+ private:
+    double cam_height{0};
+    double focal_px{1};
+    int img_h{0};
+    double height_rel_stddev{0};
+    std::array<double, 3> vertical{};
+
+    // inverse depth of the floor in row v: row_slope*v + row_offset
+    double row_slope{0};
+    double row_offset{0};
+    double ground_inv_var{0};
+
+ public:
+    /**
+     * @brief Precomputes the floor range of the rows of an img_h tall frame
+     * 
+     * @param cam2robot homogenous transform from camera to robot frame
+     * @param _focal_px focal length UNIT: [px]
+     * @param center_y image center y UNIT: [px]
+     * @param _img_h frame height UNIT: [px]
+     * @param _cam_height camera height above the floor UNIT: [m]
+     * @param _height_rel_stddev standard deviation of human height, as a fraction of AVG_HUMAN_HEIGHT
+     * @param foot_stddev_px standard deviation of the box bottom UNIT: [px]
+     */
+    GroundRangeEstimator(const Eigen::Matrix<double, 4, 4>& cam2robot,
+      double _focal_px, double center_y, int _img_h, double _cam_height,
+      double _height_rel_stddev, double foot_stddev_px);
+
+    /**
+     * @brief Reads CAM_HEIGHT, HUMAN_HEIGHT_STDDEV and FOOT_PIXEL_STDDEV
+     * 
+     */
+    GroundRangeEstimator(const Eigen::Matrix<double, 4, 4>& cam2robot,
+      double _focal_px, double center_y, int _img_h,
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Gets the inverse camera depth of the floor point seen in a row
+     * 
+     * @param foot_v box bottom UNIT: [px]
+     * @return double inverse depth UNIT: [1/m], 0 at or above the horizon
+     */
+    double inverse_range(float foot_v) const {
+      return std::max(0., row_slope*foot_v + row_offset);
+    }
+
+    /**
+     * @brief Gets the camera depth of the floor point seen in a row
+     * 
+     * @param foot_v box bottom UNIT: [px]
+     * @return double depth UNIT: [m], 0 at or above the horizon
+     */
+    double range(float foot_v) const {
+      double inv = inverse_range(foot_v);
+      return inv > 0 ? 1/inv : 0;
+    }
+
+    /**
+     * @brief Gets the inverse camera depth of the floor point along an undistorted ray, for lens-corrected estimates
+     * 
+     * @param ray_y ray y/z through the box bottom
+     * @return double inverse depth UNIT: [1/m], 0 at or above the horizon
+     */
+    double inverse_range_from_ray(double ray_y) const {
+      // Center column ray; the x component only matters for a rolled camera.
+      return std::max(0., (vertical[1]*ray_y + vertical[2])/cam_height);
+    }
+
+    /**
+     * @brief Fuses the box-height and ground estimates of a box by inverse variance
+     * 
+     * @details Scalar reference of fuse_heights, used for single boxes and
+     * lens-corrected estimates.
+     * 
+     * @param height_inv_z box-height inverse depth UNIT: [1/m]
+     * @param ground_inv_z ground inverse depth, 0 if unavailable UNIT: [1/m]
+     * @param top box top UNIT: [px]
+     * @param bottom box bottom UNIT: [px]
+     * @return double fused inverse depth UNIT: [1/m]
+     */
+    double fuse_inverse(double height_inv_z, double ground_inv_z, float top,
+      float bottom) const {
+      const bool use_ground = (ground_inv_z > 0) & (bottom < img_h - 1);
+      const bool use_height = (top > 1) | !use_ground;
+
+      double height_var = height_rel_stddev*height_inv_z;
+      height_var *= height_var;
+      // ground_inv_var > 0, so this never divides by 0
+      double fused = (height_inv_z*ground_inv_var + ground_inv_z*height_var)/
+        (height_var + ground_inv_var);
+      double single = use_ground ? ground_inv_z : height_inv_z;
+      return use_ground & use_height ? fused : single;
+    }
+
+    /**
+     * @brief Fuses n boxes given as field arrays, as the box each would be at its fused depth
+     * 
+     * @details Runs 8 (AVX2) or 4 (NEON) boxes at a time. Boxes keep their
+     * vertical center; only their height, which PixelProjection turns into
+     * depth, changes.
+     * 
+     * @param top box top UNIT: [px]
+     * @param height box height UNIT: [px]
+     * @param n number of boxes
+     * @param scale AVG_HUMAN_HEIGHT*focal length, box height times depth UNIT: [m*px]
+     * @param fused_top output: top of the box at the fused depth UNIT: [px]
+     * @param fused_height output: height of the box at the fused depth UNIT: [px]
+     */
+    void fuse_heights(const float* top, const float* height, std::size_t n,
+      float scale, float* fused_top, float* fused_height) const;
+};
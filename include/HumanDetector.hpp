@@ -16,11 +16,21 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <utility>
 #include <fstream>
 #include <unordered_map>
 #include <opencv2/opencv.hpp>
 
 #include "Detection.hpp"
+#include "DetectionBatch.hpp"
+#include "FramePreprocessor.hpp"
+#include "YoloDecoder.hpp"
+#include "NMSEngine.hpp"
+#include "TileLayout.hpp"
+#include "DarknetModel.hpp"
+#include "InferenceEngine.hpp"
+#include "StageTimers.hpp"
+#include "utils.hpp"
 
 class HumanDetector {
  private:
@@ -30,67 +40,196 @@ class HumanDetector {
      * @details width, height
      */
     std::array<int, 2> img_dim_{};
-    std::vector<cv::String> detection_classes{};
+
+    /**
+     * @brief Current network input size, which may differ from img_dim_
+     * 
+     * @details width, height. Detections are always reported in img_dim_
+     * coordinates whatever the network runs at.
+     */
+    std::array<int, 2> net_dim_{};
+    bool letterbox_input{false};
     std::vector<std::string> classes{};
 
     double detection_probability_threshold{};
     double nms_threshold{};
     double score_threshold{};
 
+    /**
+     * @brief Gaussian soft-NMS sigma. Greedy NMS is used when <= 0.
+     * 
+     */
+    double soft_nms_sigma{};
+
     const std::string coco_path;
 
-    cv::dnn::Net net;
+    std::unique_ptr<InferenceEngine> engine;
+
+    /**
+     * @brief Fused preprocessing kernel and the persistent NCHW input tensor it writes into.
+     * 
+     */
+    FramePreprocessor preprocessor;
+    cv::Mat input_tensor{};
+
+    /**
+     * @brief Network outputs of detect_frame, reused by every call
+     * 
+     */
+    std::vector<cv::Mat> output_mats{};
+
+    /**
+     * @brief Person-only output decoder and its reusable candidate buffers.
+     * 
+     */
+    YoloDecoder decoder;
+    std::vector<cv::Rect> candidate_boxes{};
+    std::vector<float> candidate_scores{};
+    NMSEngine nms{};
+    std::vector<int> nms_indices{};
+    std::vector<float> nms_scores{};
+
+    /**
+     * @brief Tiled mode: band tiles, their preprocessing kernel and the batched input tensor (whole frame first, then the tiles).
+     * 
+     */
+    TileLayout tile_layout;
+    FramePreprocessor tile_preprocessor;
+    cv::Mat tile_tensor{};
+
+    /**
+     * @brief Per-stage latency histograms, not recorded into while null
+     * 
+     */
+    StageTimers* timers{nullptr};
+
+    /**
+     * @brief Reads the class names file, one class per line.
+     * 
+     * @param path path to the class names file
+     * @return class names in network output order
+     */
+    static std::vector<std::string> read_class_names(const std::string& path);
 
     /**
      * @brief Parse the DNN return values.
      * 
-     * @param detections 
-     * @param show_detections 
-     * @return std::shared_ptr<std::vector<Detection> > all detections in image.
+     * @param outputs one output matrix per YOLO output layer
+     * @param detections output: all detections in image, cleared first
+     * @param letterbox mapping from letterboxed NN coordinates to the squashed frame
      */
-    std::shared_ptr<std::vector<Detection> > parse_dnn_output(
-      const std::vector<cv::Mat>& detections,
-      cv::Mat* img_ptr, bool show_detections);
+    void parse_dnn_output(const std::vector<cv::Mat>& outputs,
+      std::vector<Detection>* detections,
+      const Letterbox& letterbox = Letterbox());
 
     /**
-     * @brief Draws prediction on image
+     * @brief Decodes network outputs into the candidate buffers and runs NMS on them.
      * 
-     * @cite https://github.com/spmallick/learnopencv
+     * @param outputs one output matrix per YOLO output layer
+     * @param letterbox mapping from letterboxed NN coordinates to the squashed frame
+     */
+    void decode_outputs(const std::vector<cv::Mat>& outputs,
+      const Letterbox& letterbox);
+
+    /**
+     * @brief Copies the boxes kept by the last NMS pass
      * 
-     * @param classId 
-     * @param conf 
-     * @param left 
-     * @param top 
-     * @param right 
-     * @param bottom 
-     * @param frame 
+     * @param detections output, cleared first
      */
-    void draw_pred(int classId, float conf, int left, int top,
-      int right, int bottom, cv::Mat* frame);
+    void collect_kept(std::vector<Detection>* detections) const;
+
+    /**
+     * @brief Runs the network on an original camera frame and decodes its outputs
+     * 
+     */
+    void infer_frame(const cv::Mat& img);
+
+    /**
+     * @brief Runs NMS (or soft-NMS) on the candidate buffers into nms_indices.
+     * 
+     */
+    void suppress_candidates();
+
+    /**
+     * @brief Decodes the batched outputs of detect_tiled into the candidate buffers, in frame coordinates.
+     * 
+     * @details Tile boxes touching an inner tile edge are dropped, since
+     * the neighbouring tile or the whole frame sees them in full.
+     * 
+     * @param per_tile per-frame outputs, whole frame first
+     * @param tiles tile rectangles in the frame
+     * @param frame_size size of the original frame
+     */
+    void decode_tiles(const std::vector<std::vector<cv::Mat> >& per_tile,
+      const std::vector<cv::Rect>& tiles, const cv::Size& frame_size);
+
+    /**
+     * @brief Runs a single forward pass through the network.
+     * 
+     * @param blob NCHW input blob
+     * @param outputs one output matrix per YOLO output layer
+     */
+    void forward_blob(const cv::Mat& blob, std::vector<cv::Mat>* outputs);
+
+    /**
+     * @brief Splits batched YOLO outputs into per-frame output headers.
+     * 
+     * @details No data is copied. Each returned matrix points into the
+     * corresponding batched output and is only valid as long as it is.
+     * 
+     * @param outputs batched output of every YOLO layer
+     * @param batch_size number of frames in the batch
+     * @return per-frame, per-layer 2D output matrices
+     */
+    std::vector<std::vector<cv::Mat> > split_batched_output(
+      const std::vector<cv::Mat>& outputs, int batch_size);
 
  public:
     HumanDetector(const std::unordered_map<std::string, double>& robot_params,
       const std::string& _coco_name_path,
       const std::string& _yolo_cfg_path, const std::string& _yolo_weight_path) :
-      net{cv::dnn::readNetFromDarknet(_yolo_cfg_path, _yolo_weight_path)}
+      HumanDetector(robot_params, _coco_name_path,
+        InferenceEngine::create(robot_params, _yolo_cfg_path,
+          _yolo_weight_path)) {}
+
+    /**
+     * @brief Construct a detector from a model already loaded in memory. No model file is read.
+     * 
+     */
+    HumanDetector(const std::unordered_map<std::string, double>& robot_params,
+      const std::string& _coco_name_path, const DarknetModel& model) :
+      HumanDetector(robot_params, _coco_name_path,
+        InferenceEngine::create(robot_params, model)) {}
+
+    /**
+     * @brief Construct a detector around an already loaded inference engine
+     * 
+     */
+    HumanDetector(const std::unordered_map<std::string, double>& robot_params,
+      const std::string& _coco_name_path,
+      std::unique_ptr<InferenceEngine> _engine) :
+      classes{read_class_names(_coco_name_path)},
+      engine{std::move(_engine)},
+      preprocessor{static_cast<int>(robot_params.at("IMG_WIDTH_REQ")),
+        static_cast<int>(robot_params.at("IMG_HEIGHT_REQ")),
+        get_param(robot_params, "LETTERBOX_INPUT", 0) != 0},
+      decoder{classes, robot_params.at("DETECTION_PROBABILITY_THRESHOLD")},
+      tile_layout{robot_params},
+      tile_preprocessor{static_cast<int>(robot_params.at("IMG_WIDTH_REQ")),
+        static_cast<int>(robot_params.at("IMG_HEIGHT_REQ"))}
     {
       img_dim_[0] = static_cast<int>(robot_params.at("IMG_WIDTH_REQ"));
       img_dim_[1] = static_cast<int>(robot_params.at("IMG_HEIGHT_REQ"));
+      net_dim_ = img_dim_;
+      letterbox_input = get_param(robot_params, "LETTERBOX_INPUT", 0) != 0;
       detection_probability_threshold = robot_params.at(
         "DETECTION_PROBABILITY_THRESHOLD");
       nms_threshold = robot_params.at("NMS_THRESHOLD");
       score_threshold = robot_params.at("SCORE_THRESHOLD");
+      soft_nms_sigma = get_param(robot_params, "SOFT_NMS_SIGMA", 0);
 
-      net.setPreferableBackend(cv::dnn::DNN_TARGET_CPU);
-      std::ifstream ifs(_coco_name_path.c_str());
-      std::string line;
-      while (getline(ifs, line)) classes.push_back(line);
-
-      auto outLayers = net.getUnconnectedOutLayers();
-      auto layerNames = net.getLayerNames();
-      detection_classes.resize(outLayers.size());
-      for (std::size_t i = 0; i < outLayers.size(); i++)
-          detection_classes[i] = layerNames[outLayers[i] - 1];
+      int tensor_dims[] = {1, 3, net_dim_[1], net_dim_[0]};
+      input_tensor.create(4, tensor_dims, CV_32F);
     }
 
     /**
@@ -107,15 +246,157 @@ class HumanDetector {
      * @brief Detects humans in a given image.
      * 
      * @param prepped_frame A pre-processed frame for NN input
+     * @param show_detections draw the detections onto prepped_frame afterwards, on this thread (see AnnotationSink to draw elsewhere)
      * @return A detection obj for each human detected in frame.
      */
     std::shared_ptr<std::vector<Detection> > detect(cv::Mat&,
       bool show_detections = false);
 
+    /**
+     * @brief Detects humans in an original camera frame.
+     * 
+     * @details 8-bit BGR frames go through the fused preprocessing kernel
+     * into the persistent input tensor, skipping prep_frame and
+     * blobFromImage. Detections are in NN input (IMG_WIDTH_REQ x
+     * IMG_HEIGHT_REQ) coordinates, as with detect().
+     * 
+     * @param img Original frame of any size
+     * @return A detection obj for each human detected in frame.
+     */
+    std::shared_ptr<std::vector<Detection> > detect_frame(const cv::Mat& img);
+
+    /**
+     * @brief Detects humans in an original camera frame into a caller-owned buffer.
+     * 
+     * @details Same as detect_frame(img). The input tensor, network
+     * outputs and decode/NMS buffers live in the detector, and detections
+     * keeps its capacity, so after the first frame of a given size an
+     * 8-bit BGR frame causes no heap allocation outside the inference
+     * engine.
+     * 
+     * @param img Original frame of any size
+     * @param detections output: a detection obj for each human detected in frame, cleared first
+     */
+    void detect_frame(const cv::Mat& img, std::vector<Detection>* detections);
+
+    /**
+     * @brief Detects humans in an original camera frame, appending them to a batch with their confidence and class.
+     * 
+     * @details Several frames can be appended to the same batch, told
+     * apart by frame_id. Allocation-free like the vector overload once
+     * the batch has grown.
+     * 
+     * @param img Original frame of any size
+     * @param batch output: detections are appended in NN input coordinates
+     * @param frame_id frame id given to the appended detections
+     */
+    void detect_frame(const cv::Mat& img, DetectionBatch* batch,
+      int frame_id = 0);
+
+    /**
+     * @brief Detects humans in a high-resolution frame using full-resolution tiles.
+     * 
+     * @details The whole frame and every tile of the TILE_* band are run as
+     * one batch. Tile boxes that touch an inner tile seam are dropped,
+     * since the overlapping neighbour sees the same person whole. The rest
+     * are mapped to frame coordinates and merged with the whole-frame boxes
+     * in a single NMS pass. Detections are returned in NN input
+     * (IMG_WIDTH_REQ x IMG_HEIGHT_REQ) coordinates, as with detect_frame().
+     * Frames that are not 8-bit BGR fall back to detect_frame().
+     * 
+     * @param img Original frame of any size
+     * @return A detection obj for each human detected in frame.
+     */
+    std::shared_ptr<std::vector<Detection> > detect_tiled(const cv::Mat& img);
+
+    /**
+     * @brief Detects humans in several frames with a single forward pass.
+     * 
+     * @details All frames are packed into one NCHW blob so the network
+     * sees a batch dimension instead of one dispatch per frame.
+     * 
+     * @param frames Frames to be detected (resized to the NN input size)
+     * @return A detection vector for each frame, in input order.
+     */
+    std::vector<std::shared_ptr<std::vector<Detection> > > detect_batch(
+      const std::vector<cv::Mat>& frames);
+
+    /**
+     * @brief Pre-processing stage: builds the NN input blob for a frame.
+     * 
+     * @param img Original or prepped frame
+     * @return NCHW blob ready for infer()
+     */
+    cv::Mat make_blob(const cv::Mat& img);
+
+    /**
+     * @brief Inference stage: runs the network on a blob.
+     * 
+     * @details The network reuses its output buffers on every forward
+     * pass, so the returned matrices are deep copies that stay valid while
+     * the next blob is being inferred.
+     * 
+     * @param blob NCHW input blob
+     * @return one output matrix per YOLO output layer
+     */
+    std::vector<cv::Mat> infer(const cv::Mat& blob);
+
+    /**
+     * @brief Post-processing stage: parses the outputs of infer().
+     * 
+     * @details Does not touch the network, so it may run concurrently with
+     * infer() on another thread.
+     * 
+     * @param outputs one output matrix per YOLO output layer
+     * @return All human detections in the frame.
+     */
+    std::shared_ptr<std::vector<Detection> > parse_detections(
+      const std::vector<cv::Mat>& outputs);
+
     /**
      * @brief Gets the image dimensions (width and height)
      * @return Array of image dimensions
      */
     std::array<int, 2> get_img_dims();
+
+    /**
+     * @brief Changes the size the network runs at.
+     * 
+     * @details Detections stay in IMG_WIDTH_REQ x IMG_HEIGHT_REQ
+     * coordinates, so PositionEstimator is unaffected. YOLO outputs are
+     * normalized to the input size, so no rescaling error is introduced.
+     * 
+     * @param width network input width, a multiple of 32
+     * @param height network input height, a multiple of 32
+     * @throw std::invalid_argument if a dimension is not a positive multiple of 32
+     */
+    void set_input_size(int width, int height);
+
+    /**
+     * @brief Records the latency of each stage of detection from now on
+     * 
+     * @param _timers null to stop recording. Must outlive the detector or be replaced first.
+     */
+    void set_stage_timers(StageTimers* _timers) {
+      timers = _timers;
+    }
+
+    /**
+     * @brief Gets the current network input size (width and height)
+     * 
+     * @return std::array<int, 2> 
+     */
+    std::array<int, 2> get_input_size() const {
+      return net_dim_;
+    }
+
+    /**
+     * @brief Gets the name of the inference engine in use
+     * 
+     * @return std::string 
+     */
+    std::string get_engine_name() const {
+      return engine->get_name();
+    }
 };
 
@@ -0,0 +1,86 @@
+/**
+ * @file InferenceEngine.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Inference Engine interface
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+class DarknetModel;
+
+/**
+ * @brief Runtime that a HumanDetector forwards its input tensor through.
+ * 
+ * @details Implementations load the model when they are constructed. They
+ * take an NCHW float blob and produce one 2D output per YOLO output
+ * layer. Each output row is (cx, cy, w, h, objectness, class scores...)
+ * normalized to the input size. Outputs may be reused by the next
+ * forward pass.
+ */
+class InferenceEngine {
+ public:
+    virtual ~InferenceEngine() {}
+
+    /**
+     * @brief Sets the NCHW input tensor of the next forward pass
+     * 
+     * @param blob 
+     */
+    virtual void set_input(const cv::Mat& blob) = 0;
+
+    /**
+     * @brief Runs the model on the current input
+     * 
+     * @param outputs one [rows, cols] matrix per output layer. With a batched input, the rows of every frame are stacked in batch order.
+     */
+    virtual void forward(std::vector<cv::Mat>* outputs) = 0;
+
+    /**
+     * @brief Gets a human readable name of the engine and its configuration
+     * 
+     * @return std::string 
+     */
+    virtual std::string get_name() const = 0;
+
+    /**
+     * @brief Builds the engine that fits the model files and the configured backend.
+     * 
+     * @details Models whose weight path ends in ".onnx" use the ONNX engine
+     * and ignore the cfg path. All other models are loaded as Darknet. The
+     * DNN_BACKEND and DNN_TARGET robot parameters select the OpenCV
+     * cv::dnn::Backend and cv::dnn::Target ids, and default to the OpenCV
+     * default backend on the CPU. With INT8_INFERENCE set, the model is
+     * quantized after calibrating on the labeled dataset.
+     * 
+     * @param robot_params parsed robot parameters
+     * @param cfg_path path to the Darknet cfg
+     * @param weight_path path to the Darknet weights or the ONNX model
+     * @return std::unique_ptr<InferenceEngine> 
+     */
+    static std::unique_ptr<InferenceEngine> create(
+      const std::unordered_map<std::string, double>& robot_params,
+      const std::string& cfg_path, const std::string& weight_path);
+
+    /**
+     * @brief Builds the engine for a Darknet model already loaded in memory
+     * 
+     * @param robot_params parsed robot parameters
+     * @param model loaded Darknet model
+     * @return std::unique_ptr<InferenceEngine> 
+     */
+    static std::unique_ptr<InferenceEngine> create(
+      const std::unordered_map<std::string, double>& robot_params,
+      const DarknetModel& model);
+};
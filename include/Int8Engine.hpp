@@ -0,0 +1,101 @@
+/**
+ * @file Int8Engine.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief INT8 inference engine header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+#include "DnnEngine.hpp"
+#include "DarknetModel.hpp"
+
+/**
+ * @brief Post-training INT8 quantized network run through OpenCV DNN.
+ * 
+ * @details The FP32 network is calibrated on representative input blobs.
+ * OpenCV records the activation range of every tensor over those blobs
+ * and derives one scale per tensor. Inputs and outputs stay FP32, so the
+ * engine is a drop-in replacement for the FP32 engines. Quantized
+ * networks only run on the OpenCV backend.
+ * OpenCV can neither copy nor save a quantized network, so every engine
+ * runs its own calibration passes. The calibration blobs are read once
+ * per process and shared by every engine.
+ */
+class Int8Engine : public DnnEngine {
+ private:
+    static std::mutex calibration_mtx;
+    static std::map<std::tuple<std::string, int, int, std::size_t>,
+      std::vector<cv::Mat> > calibration_cache;
+
+    /**
+     * @brief Quantizes a network with per-tensor scales
+     * 
+     * @param float_net FP32 network
+     * @param calibration_blobs NCHW input blobs, one forward pass each
+     * @return cv::dnn::Net INT8 network
+     * @throw std::invalid_argument if there are no calibration blobs
+     */
+    static cv::dnn::Net quantize(cv::dnn::Net float_net,
+      const std::vector<cv::Mat>& calibration_blobs);
+
+ public:
+    Int8Engine(cv::dnn::Net float_net,
+      const std::vector<cv::Mat>& calibration_blobs,
+      int backend = cv::dnn::DNN_BACKEND_DEFAULT,
+      int target = cv::dnn::DNN_TARGET_CPU) :
+      DnnEngine(quantize(float_net, calibration_blobs), backend, target,
+        "int8") {}
+
+    /**
+     * @brief Construct an engine from a Darknet model already loaded in memory
+     * 
+     */
+    Int8Engine(const DarknetModel& model,
+      const std::vector<cv::Mat>& calibration_blobs,
+      int backend = cv::dnn::DNN_BACKEND_DEFAULT,
+      int target = cv::dnn::DNN_TARGET_CPU) :
+      Int8Engine(model.create_net(), calibration_blobs, backend, target) {}
+
+    /**
+     * @brief Construct an engine from an FP32 ONNX model
+     * 
+     * @throw InvalidFile if the model cannot be read
+     */
+    Int8Engine(const std::string& onnx_path,
+      const std::vector<cv::Mat>& calibration_blobs,
+      int backend = cv::dnn::DNN_BACKEND_DEFAULT,
+      int target = cv::dnn::DNN_TARGET_CPU) :
+      Int8Engine(OnnxEngine::read_net(onnx_path), calibration_blobs, backend,
+        target) {}
+
+    /**
+     * @brief Builds calibration blobs from labeled frames.
+     * 
+     * @details Only frames with at least one labeled person are used.
+     * INT8_CALIBRATION_FRAMES of them are picked evenly across the
+     * labels, sorted by name, so the same frames are used on every run.
+     * The blobs are cached, so later calls with the same directory, input
+     * size and frame count do not read the dataset again.
+     * 
+     * @param robot_params parsed robot parameters
+     * @param labels_dir directory of label files read with LabelParser
+     * @return std::vector<cv::Mat> NCHW blobs at the NN input size, read-only
+     */
+    static std::vector<cv::Mat> read_calibration_blobs(
+      const std::unordered_map<std::string, double>& robot_params,
+      const std::string& labels_dir = "../dataset/labels");
+};
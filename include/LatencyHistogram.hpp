@@ -0,0 +1,123 @@
+/**
+ * @file LatencyHistogram.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Latency Histogram header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Count and percentiles of the latencies recorded by a histogram
+ * 
+ */
+struct LatencySummary {
+    std::uint64_t count{0};
+
+    /**
+     * @brief UNIT: [ms]
+     * 
+     */
+    double mean_ms{0};
+    double p50_ms{0};
+    double p90_ms{0};
+    double p99_ms{0};
+    double max_ms{0};
+};
+
+/**
+ * @brief Fixed-memory histogram of latencies, safe to record into from any thread.
+ * 
+ * @details Buckets are exact below 16 ns, then split every power of two
+ * into 8, so a percentile is within 12.5% of the recorded value. Recording
+ * is a few relaxed atomic adds and never allocates or locks.
+ */
+class LatencyHistogram {
+ public:
+    static const int sub_buckets = 8;
+    static const int num_buckets = 62*sub_buckets;
+
+ private:
+    std::array<std::atomic<std::uint64_t>, num_buckets> buckets;
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> sum_ns{0};
+    std::atomic<std::uint64_t> max_ns{0};
+
+ public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Gets the bucket a latency falls in
+     * 
+     * @param ns latency UNIT: [ns]
+     * @return int
+     */
+    static int bucket_index(std::uint64_t ns) {
+      if (ns < 2*sub_buckets) return static_cast<int>(ns);
+      int msb = 63 - __builtin_clzll(ns);
+      int sub = static_cast<int>(ns >> (msb - 3)) & (sub_buckets - 1);
+      return (msb - 2)*sub_buckets + sub;
+    }
+
+    /**
+     * @brief Gets the largest latency of a bucket
+     * 
+     * @param index bucket index
+     * @return std::uint64_t UNIT: [ns]
+     */
+    static std::uint64_t bucket_upper_ns(int index);
+
+    /**
+     * @brief Adds a latency
+     * 
+     * @param ns UNIT: [ns]
+     */
+    void record_ns(std::uint64_t ns) {
+      buckets[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+      count.fetch_add(1, std::memory_order_relaxed);
+      sum_ns.fetch_add(ns, std::memory_order_relaxed);
+      std::uint64_t max = max_ns.load(std::memory_order_relaxed);
+      while (ns > max && !max_ns.compare_exchange_weak(max, ns,
+          std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * @brief Adds a latency
+     * 
+     * @param latency negative latencies count as 0
+     */
+    void record(std::chrono::steady_clock::duration latency) {
+      auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        latency).count();
+      record_ns(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+    }
+
+    /**
+     * @brief Gets the count, mean, percentiles and max. Percentiles are bucket upper bounds, capped at the max.
+     * 
+     * @details Latencies recorded while summarizing may be partly
+     * counted.
+     * 
+     * @return LatencySummary
+     */
+    LatencySummary summary() const;
+
+    /**
+     * @brief Forgets every latency
+     * 
+     */
+    void reset();
+};
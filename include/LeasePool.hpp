@@ -0,0 +1,147 @@
+/**
+ * @file LeasePool.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Lease Pool header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <condition_variable>
+
+/**
+ * @brief Fixed set of objects handed out to one caller at a time through RAII leases.
+ * 
+ * @tparam T pooled object type
+ */
+template <typename T>
+class LeasePool {
+ private:
+    std::vector<std::unique_ptr<T> > items;
+    std::vector<std::size_t> free_items{};
+
+    mutable std::mutex mtx;
+    std::condition_variable available_cv;
+
+    void give_back(std::size_t idx) {
+      std::lock_guard<std::mutex> lock(mtx);
+      free_items.push_back(idx);
+      available_cv.notify_one();
+    }
+
+ public:
+    /**
+     * @brief Exclusive access to one pooled object. The object returns to the pool when the lease is destroyed or released.
+     * 
+     */
+    class Lease {
+     private:
+        LeasePool* pool{nullptr};
+        std::size_t idx{0};
+
+     public:
+        Lease() {}
+        Lease(LeasePool* _pool, std::size_t _idx) : pool{_pool}, idx{_idx} {}
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        Lease(Lease&& other) : pool{other.pool}, idx{other.idx} {
+          other.pool = nullptr;
+        }
+
+        Lease& operator=(Lease&& other) {
+          if (this != &other) {
+            release();
+            pool = other.pool;
+            idx = other.idx;
+            other.pool = nullptr;
+          }
+          return *this;
+        }
+
+        ~Lease() {
+          release();
+        }
+
+        /**
+         * @brief Returns the object to the pool early
+         * 
+         */
+        void release() {
+          if (pool) pool->give_back(idx);
+          pool = nullptr;
+        }
+
+        explicit operator bool() const {
+          return pool != nullptr;
+        }
+
+        T& operator*() const {
+          return *pool->items[idx];
+        }
+
+        T* operator->() const {
+          return pool->items[idx].get();
+        }
+    };
+
+    explicit LeasePool(std::vector<std::unique_ptr<T> > _items) :
+      items{std::move(_items)} {
+      for (std::size_t i = items.size(); i > 0; i--)
+        free_items.push_back(i - 1);
+    }
+
+    /**
+     * @brief Leases an object, blocking until one is free.
+     * 
+     * @return Lease 
+     */
+    Lease acquire() {
+      std::unique_lock<std::mutex> lock(mtx);
+      available_cv.wait(lock, [this]() { return !free_items.empty(); });
+      std::size_t idx = free_items.back();
+      free_items.pop_back();
+      return Lease(this, idx);
+    }
+
+    /**
+     * @brief Leases an object if one is free right now.
+     * 
+     * @return Lease, empty if every object is leased
+     */
+    Lease try_acquire() {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (free_items.empty()) return Lease();
+      std::size_t idx = free_items.back();
+      free_items.pop_back();
+      return Lease(this, idx);
+    }
+
+    /**
+     * @brief Gets the number of pooled objects
+     * 
+     * @return std::size_t 
+     */
+    std::size_t size() const {
+      return items.size();
+    }
+
+    /**
+     * @brief Gets the number of objects not currently leased
+     * 
+     * @return std::size_t 
+     */
+    std::size_t available() const {
+      std::lock_guard<std::mutex> lock(mtx);
+      return free_items.size();
+    }
+};
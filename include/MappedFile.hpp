@@ -0,0 +1,51 @@
+/**
+ * @file MappedFile.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Mapped File header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ * 
+ * @details The pages come straight from the page cache. They are shared
+ * by every mapping of the file, including mappings in other processes
+ * and in children forked after the file was mapped.
+ */
+class MappedFile {
+ private:
+    const char* addr{nullptr};
+    std::size_t length{0};
+
+ public:
+    /**
+     * @brief Maps a file
+     * 
+     * @param path 
+     * @throw InvalidFile if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    const char* data() const {
+      return addr;
+    }
+
+    std::size_t size() const {
+      return length;
+    }
+};
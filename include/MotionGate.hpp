@@ -0,0 +1,123 @@
+/**
+ * @file MotionGate.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Motion Gate header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Skip statistics of a MotionGate
+ * 
+ */
+struct MotionGateStats {
+    std::size_t frames{0};
+    std::size_t skipped{0};
+    double skip_ratio{0};
+
+    /**
+     * @brief Total time spent in the gate itself UNIT: [ms]
+     * 
+     */
+    double gate_ms{0};
+
+    /**
+     * @brief Estimated inference time saved, net of the gate cost UNIT: [ms]
+     * 
+     */
+    double saved_ms{0};
+};
+
+/**
+ * @brief Cheap change detector that lets static frames skip inference.
+ * 
+ * @details Every frame is shrunk to a small grayscale thumbnail and
+ * compared with the thumbnail of the last frame that was inferred. A
+ * frame counts as changed when more than a given fraction of thumbnail
+ * pixels differ by more than a given intensity. Comparing with the last
+ * inferred frame, rather than the previous frame, means slow changes
+ * still add up and trigger inference. Inference is also forced after a
+ * bounded number of skipped frames.
+ */
+class MotionGate {
+ private:
+    double pixel_threshold;
+    double changed_fraction;
+    int max_skipped;
+
+    int skipped_in_row{0};
+    std::vector<uint8_t> reference{};
+    std::vector<uint8_t> thumbnail{};
+    cv::Mat small{};
+
+    MotionGateStats stats{};
+    std::size_t num_inferences{0};
+    double inference_ms{0};
+
+    /**
+     * @brief Shrinks a BGR or grayscale frame into the thumbnail buffer
+     * 
+     */
+    void make_thumbnail(const cv::Mat& frame);
+
+ public:
+    /**
+     * @brief Thumbnail width and height UNIT: [px]
+     * 
+     */
+    static const int thumbnail_size = 64;
+
+    /**
+     * @brief Construct a new Motion Gate
+     * 
+     * @param _pixel_threshold smallest intensity change of a changed thumbnail pixel, as a fraction of full scale
+     * @param _changed_fraction fraction of changed thumbnail pixels above which the frame is inferred
+     * @param _max_skipped most frames skipped in a row before inference is forced
+     * @throw std::invalid_argument if a fraction is not in [0, 1] or max_skipped < 0
+     */
+    MotionGate(double _pixel_threshold, double _changed_fraction,
+      int _max_skipped);
+
+    /**
+     * @brief Construct a gate from the MOTION_* robot parameters
+     * 
+     */
+    explicit MotionGate(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Decides whether a frame must go through inference.
+     * 
+     * @details When it returns true, the frame becomes the new reference.
+     * 
+     * @param frame 8-bit BGR or grayscale frame
+     * @return false if the scene has not changed and the last result can be reused
+     */
+    bool should_infer(const cv::Mat& frame);
+
+    /**
+     * @brief Records the inference time of a frame let through, used to estimate the time saved
+     * 
+     * @param ms UNIT: [ms]
+     */
+    void record_inference_ms(double ms);
+
+    /**
+     * @brief Gets the skip ratio and time saved so far
+     * 
+     * @return MotionGateStats 
+     */
+    MotionGateStats get_stats() const;
+};
@@ -0,0 +1,168 @@
+/**
+ * @file NMSEngine.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief NMS Engine header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "DetectionBatch.hpp"
+
+/**
+ * @brief Non-maximum suppression for crowded scenes.
+ * 
+ * @details Candidates are visited in score order, and boxes are binned
+ * into a uniform grid. A box is only compared with the boxes in the cells
+ * it covers, instead of with every kept box. Intersections inside a cell
+ * are screened 8 (AVX) or 4 (SSE2/NEON) boxes at a time. The final keep
+ * decision uses the exact arithmetic of cv::dnn::NMSBoxes. Grid, sort and
+ * heap buffers are reused between calls, so a warmed-up engine does not
+ * allocate.
+ */
+class NMSEngine {
+ public:
+    enum SoftNMSMethod { LINEAR, GAUSSIAN };
+
+ private:
+    /**
+     * @brief Boxes binned into one grid cell, as x1/y1/x2/y2 float arrays for SIMD screening.
+     * 
+     */
+    struct Cell {
+        std::vector<float> x1{}, y1{}, x2{}, y2{};
+        std::vector<int> ids{};
+    };
+
+    /**
+     * @brief Max-heap entry of soft-NMS. Ties go to the earlier sorted candidate.
+     * 
+     */
+    struct ScoredBox {
+        float score;
+        int rank;
+        int id;
+
+        bool operator<(const ScoredBox& other) const {
+          if (score != other.score) return score < other.score;
+          return rank > other.rank;
+        }
+    };
+
+    std::vector<Cell> cells{};
+    int grid_w{0};
+    int grid_h{0};
+    int min_x{0};
+    int min_y{0};
+    int cell_w{1};
+    int cell_h{1};
+
+    std::vector<int> order{};
+    std::vector<int> kept{};
+    std::vector<int> kept_degenerate{};
+    std::vector<int> rank{};
+    std::vector<int> visit_stamp{};
+    std::vector<char> done{};
+    std::vector<float> soft_scores{};
+    std::vector<ScoredBox> heap{};
+    std::vector<cv::Rect> batch_boxes{};
+    std::vector<float> batch_scores{};
+
+    /**
+     * @brief Sorts candidates above the score threshold by descending score, like NMSBoxes.
+     * 
+     */
+    void sort_candidates(const std::vector<float>& scores,
+      float score_threshold);
+
+    /**
+     * @brief Sizes and clears the grid for the sorted candidates.
+     * 
+     */
+    void build_grid(const std::vector<cv::Rect>& boxes);
+
+    /**
+     * @brief Gets the range of grid cells a box covers
+     * 
+     * @return cx0, cy0, cx1, cy1
+     */
+    std::array<int, 4> cell_range(const cv::Rect& box) const;
+
+    /**
+     * @brief Bins a box into every grid cell it covers
+     * 
+     */
+    void insert(const cv::Rect& box, int id);
+
+    /**
+     * @brief Calls visit(id) for every binned box intersecting box, until visit returns true.
+     * 
+     * @return true if visit returned true
+     */
+    template <typename Visit>
+    bool for_each_intersecting(const cv::Rect& box, Visit&& visit);
+
+ public:
+    /**
+     * @brief Computes the overlap of two boxes exactly as cv::dnn::NMSBoxes does.
+     * 
+     * @param area_a area of the first box
+     * @param area_b area of the second box
+     * @param inter area of their intersection
+     * @return float overlap (IoU)
+     */
+    static float overlap(int area_a, int area_b, int inter);
+
+    /**
+     * @brief Greedy NMS. Results are identical to cv::dnn::NMSBoxes with eta = 1 and top_k = 0.
+     * 
+     * @param boxes candidate boxes
+     * @param scores candidate scores
+     * @param score_threshold candidates must score above this to be kept
+     * @param nms_threshold boxes overlapping a kept box by more than this are suppressed
+     * @param indices output: kept box indices in descending score order
+     */
+    void nms_boxes(const std::vector<cv::Rect>& boxes,
+      const std::vector<float>& scores, float score_threshold,
+      float nms_threshold, std::vector<int>* indices);
+
+    /**
+     * @brief Greedy NMS over a batch, scored by its confidences. Boxes only suppress boxes from the same frame.
+     * 
+     * @details Boxes are rounded to whole pixels, then shifted apart by
+     * frame id so that one pass handles every frame in the batch.
+     * 
+     * @param batch candidate detections
+     * @param score_threshold candidates must score above this to be kept
+     * @param nms_threshold boxes overlapping a kept box by more than this are suppressed
+     * @param indices output: kept batch indices in descending score order
+     */
+    void nms_boxes(const DetectionBatch& batch, float score_threshold,
+      float nms_threshold, std::vector<int>* indices);
+
+    /**
+     * @brief Soft-NMS: instead of discarding overlapping boxes, decays their scores.
+     * 
+     * @param boxes candidate boxes
+     * @param scores candidate scores
+     * @param score_threshold boxes whose (decayed) score falls to or below this are dropped
+     * @param nms_threshold LINEAR only: overlap above which scores are decayed
+     * @param sigma GAUSSIAN only: score *= exp(-overlap^2/sigma)
+     * @param method LINEAR or GAUSSIAN decay
+     * @param indices output: kept box indices in selection order
+     * @param updated_scores output: decayed score of each kept box
+     */
+    void soft_nms_boxes(const std::vector<cv::Rect>& boxes,
+      const std::vector<float>& scores, float score_threshold,
+      float nms_threshold, float sigma, SoftNMSMethod method,
+      std::vector<int>* indices, std::vector<float>* updated_scores);
+};
@@ -57,6 +57,14 @@ class ParamParser {
      */
     std::array<std::string, 3> split_variable(const std::string &line);
 
+    /**
+     * @brief Strips a camera block prefix, e.g. CAMERA2_PITCH_CAM2ROBOT_CENTER gives PITCH_CAM2ROBOT_CENTER
+     * 
+     * @param name variable name
+     * @return the name of the variable a camera block entry overrides, or name itself
+     */
+    std::string get_base_name(const std::string& name) const;
+
     /**
      * @brief Uses the value and unit to determine true value for a given variable
      * 
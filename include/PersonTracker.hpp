@@ -0,0 +1,170 @@
+/**
+ * @file PersonTracker.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Robot-frame multi-person tracker header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @brief A tracked person in the ROBOT frame
+ * 
+ */
+struct PersonTrack {
+    std::uint64_t id{0};
+    std::array<double, 3> xyz{};
+    std::array<double, 3> velocity{};
+
+    /**
+     * @brief Frames the person was matched in, and consecutive frames they have been missed since
+     * 
+     */
+    int hits{0};
+    int misses{0};
+};
+
+/**
+ * @brief Follows the people found by PositionEstimator from frame to frame, giving each a stable id.
+ * 
+ * @details Each person has a constant-velocity Kalman filter per robot
+ * axis. Every axis has the same motion and measurement noise, so the
+ * three axes of a track share one 2x2 covariance.
+ * 
+ * An update predicts every track to the frame time, then matches
+ * positions to tracks. Tracks are sorted into a grid of floor (x, z)
+ * cells at least PERSON_GATE_DISTANCE wide, so a position only visits
+ * the tracks of its 3x3 neighbouring cells. Pairs within
+ * PERSON_GATE_DISTANCE that pass a 99.99% Mahalanobis gate are then
+ * assigned greedily in order of increasing Mahalanobis distance. This
+ * costs O(n + m log m) for crowds of any size instead of the O(n^3) of an
+ * optimal assignment, and only differs from it when gates overlap.
+ * 
+ * Unmatched positions start tentative tracks, which are reported once
+ * they have been matched PERSON_CONFIRM_HITS times. Tentative tracks are
+ * dropped on their first miss, confirmed ones after PERSON_MAX_MISSES
+ * consecutive misses.
+ */
+class PersonTracker {
+ private:
+    struct Track {
+        std::array<double, 3> pos{};
+        std::array<double, 3> vel{};
+        double p00{0}, p01{0}, p11{0};
+        std::uint64_t id{0};
+        int hits{0};
+        int misses{0};
+    };
+
+    /**
+     * @brief A gated track and position, and their squared Mahalanobis distance
+     * 
+     */
+    struct Candidate {
+        double cost;
+        std::uint32_t track;
+        std::uint32_t position;
+    };
+
+    double accel_var;
+    double measurement_var;
+    double gate_distance;
+    int confirm_hits;
+    int max_misses;
+
+    std::vector<Track> tracks{};
+    std::uint64_t next_id{1};
+    double last_time{0};
+    bool has_time{false};
+
+    /**
+     * @brief Buffers reused by every update
+     * 
+     */
+    /**
+     * @brief Grid of floor (x, z) cells over the tracks, and the tracks sorted by cell
+     * 
+     */
+    std::array<double, 2> grid_origin{};
+    double grid_cell{1};
+    int grid_cols{0};
+    int grid_rows{0};
+    std::vector<std::uint32_t> track_cell{};
+    std::vector<std::uint32_t> cell_start{};
+    std::vector<std::uint32_t> cell_tracks{};
+
+    /**
+     * @brief Predicted position and inverse innovation variance of the tracks, in cell order, so each cell is scanned contiguously
+     * 
+     */
+    std::vector<std::array<double, 4> > cell_states{};
+    std::vector<Candidate> candidates{};
+    std::vector<int> track_best{};
+    std::vector<int> position_best{};
+    std::vector<int> track_match{};
+    std::vector<char> position_matched{};
+
+    void predict(double dt);
+    void build_grid();
+    void associate(const std::vector<std::array<double, 3> >& all_xyz);
+
+ public:
+    /**
+     * @brief Construct a new Person Tracker
+     * 
+     * @param accel_stddev standard deviation of a person's acceleration UNIT: [m/s^2]
+     * @param position_stddev standard deviation of a position estimate on each axis UNIT: [m]
+     * @param _gate_distance farthest a person can be from their predicted position and still be matched UNIT: [m]
+     * @param _confirm_hits matches before a track is reported
+     * @param _max_misses consecutive misses before a confirmed track is dropped
+     * @throw std::invalid_argument unless the deviations, gate distance and confirm_hits are positive and max_misses is not negative
+     */
+    PersonTracker(double accel_stddev, double position_stddev,
+      double _gate_distance, int _confirm_hits, int _max_misses);
+
+    /**
+     * @brief Construct a tracker from the PERSON_* robot parameters
+     * 
+     */
+    explicit PersonTracker(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Adds the positions found in a frame
+     * 
+     * @details Allocates nothing once the buffers have grown to the
+     * largest number of tracks and positions seen.
+     * 
+     * @param all_xyz x, y, z position of EACH human in ROBOT frame UNIT: [m]
+     * @param timestamp capture time of the frame UNIT: [s]
+     * @param confirmed output: confirmed tracks, including those missed in this frame, cleared first
+     */
+    void update(const std::vector<std::array<double, 3> >& all_xyz,
+      double timestamp, std::vector<PersonTrack>* confirmed);
+
+    /**
+     * @brief Drops every track. Ids keep increasing.
+     * 
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of tentative and confirmed tracks
+     * 
+     * @return std::size_t
+     */
+    std::size_t size() const {
+      return tracks.size();
+    }
+};
@@ -21,6 +21,12 @@
 #include <unordered_map>
 
 #include "Detection.hpp"
+#include "DetectionBatch.hpp"
+#include "PixelProjection.hpp"
+#include "UndistortionTable.hpp"
+#include "GroundRangeEstimator.hpp"
+#include "StageTimers.hpp"
+#include "utils.hpp"
 
 class PositionEstimator {
  private:
@@ -29,6 +35,33 @@ class PositionEstimator {
     double cam_pix_density{};
     std::array<double, 2> img_center{};
     Eigen::Matrix<double, 4, 4> cam2robot_transform{};
+    PixelProjection projection{};
+    std::shared_ptr<const UndistortionTable> undistortion{};
+    std::shared_ptr<const GroundRangeEstimator> ground{};
+    StageTimers* timers{nullptr};
+
+  /**
+   * @brief Fuses a box-height depth with the ground range of the box, when ground range is on.
+   * 
+   * @param height_z box-height depth UNIT: [m]
+   * @param u box center x UNIT: [px]
+   * @param top box top UNIT: [px]
+   * @param bottom box bottom UNIT: [px]
+   * @return double depth in camera frame UNIT: [m]
+   */
+  double fused_camera_z(double height_z, float u, float top,
+      float bottom) const;
+
+  /**
+   * @brief Estimates a position from undistorted rays through the top and bottom centers of a box.
+   * 
+   * @param u box center x UNIT: [px]
+   * @param top box top UNIT: [px]
+   * @param bottom box bottom UNIT: [px]
+   * @return std::array<double, 3> x, y, z position in ROBOT frame UNIT: [m]
+   */
+  std::array<double, 3> estimate_undistorted_xyz(float u, float top,
+      float bottom) const;
 
   /**
    * @brief This method sets all instance variables to avoid repeated code in constructors.
@@ -81,6 +114,50 @@ class PositionEstimator {
       double img_h = robot_params.at("IMG_HEIGHT_REQ");
 
       set_values(x, y, z, pitch, f, pix_density, img_w, img_h, avg_height);
+
+      if (get_param(robot_params, "LENS_UNDISTORT", 0) != 0)
+        undistortion = std::make_shared<const UndistortionTable>(
+          CameraIntrinsics(robot_params), static_cast<int>(img_w),
+          static_cast<int>(img_h), static_cast<int>(
+            get_param(robot_params, "UNDISTORT_TABLE_STEP", 4)));
+
+      if (get_param(robot_params, "GROUND_RANGE", 0) != 0)
+        ground = std::make_shared<const GroundRangeEstimator>(
+          cam2robot_transform, f*pix_density, img_center[1],
+          static_cast<int>(img_h), robot_params);
+    }
+
+    /**
+     * @brief Corrects positions for lens distortion with a precomputed table
+     * 
+     * @details Depth then comes from the undistorted rays through the top
+     * and bottom of each box rather than from CAM_FOCAL_LEN and
+     * CAM_PIXEL_DENSITY, and batches are estimated per detection instead
+     * of with the SIMD projection.
+     * 
+     * @param table rays of the IMG_WIDTH_REQ x IMG_HEIGHT_REQ frame, nullptr for an ideal pinhole camera
+     */
+    void set_undistortion(std::shared_ptr<const UndistortionTable> table) {
+      undistortion = table;
+    }
+
+    /**
+     * @brief Fuses the box-height depth with the range to where the feet meet the floor
+     * 
+     * @param estimator floor ranges of the IMG_HEIGHT_REQ rows, nullptr for box height only
+     */
+    void set_ground_range(
+        std::shared_ptr<const GroundRangeEstimator> estimator) {
+      ground = estimator;
+    }
+
+    /**
+     * @brief Records the latency of estimate_all_xyz from now on
+     * 
+     * @param _timers null to stop recording. Must outlive the estimator or be replaced first.
+     */
+    void set_stage_timers(StageTimers* _timers) {
+      timers = _timers;
     }
 
     /**
@@ -108,6 +185,37 @@ class PositionEstimator {
     std::shared_ptr<std::vector<std::array<double, 3> > >
       estimate_all_xyz(const std::vector<Detection>& detection);
 
+    /**
+     * @brief Estimates the xyz position of EACH detected human into a caller-owned buffer, which keeps its capacity.
+     * 
+     * @param detections vector of Detection objs
+     * @param all_xyz output: x, y, z position of EACH human in ROBOT frame, cleared first UNIT: [m]
+     */
+    void estimate_all_xyz(const std::vector<Detection>& detections,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Estimates the xyz position of EACH detection in a batch with the SIMD projection kernel.
+     * 
+     * @details Box centers are exact (x + width/2 in float), whereas the
+     * Detection overloads truncate width/2 to whole pixels, so results
+     * can differ by up to half a pixel's worth of position.
+     * 
+     * @param batch detections in NN input coordinates
+     * @param all_xyz output: x, y, z position of EACH human in ROBOT frame, cleared first UNIT: [m]
+     */
+    void estimate_all_xyz(const DetectionBatch& batch,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Get the projection folding this estimator's intrinsics and extrinsics, for projecting raw field arrays
+     * 
+     * @return const PixelProjection& 
+     */
+    const PixelProjection& get_projection() const {
+      return projection;
+    }
+
     /**
      * @brief Get the cam2robot transform object
      * 
@@ -0,0 +1,129 @@
+/**
+ * @file ResolutionController.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Resolution Controller header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief Resolution changes and the time spent at each network input size
+ * 
+ */
+struct ResolutionStats {
+    /**
+     * @brief Candidate input widths, smallest first UNIT: [px]
+     * 
+     */
+    std::vector<int> widths{};
+    std::vector<std::size_t> frames_at_size{};
+
+    /**
+     * @brief Inference time spent at each size UNIT: [ms]
+     * 
+     */
+    std::vector<double> ms_at_size{};
+    std::size_t changes{0};
+};
+
+/**
+ * @brief Picks the network input size that keeps inference within a latency budget.
+ * 
+ * @details Frame latency is smoothed with an exponential moving average.
+ * When the average exceeds the target, the controller steps down one
+ * size. It steps up one size when the average, scaled by the pixel count
+ * of the larger size, would still be under the target with some headroom.
+ * After every change it waits a few frames so the average reflects the
+ * new size before deciding again.
+ */
+class ResolutionController {
+ private:
+    std::vector<int> widths;
+    double aspect;
+    double target_ms;
+
+    std::size_t current;
+    double average_ms{0};
+    int frames_since_change{0};
+
+    ResolutionStats stats{};
+
+    /**
+     * @brief Moves to another size index
+     * 
+     */
+    void change_to(std::size_t idx);
+
+ public:
+    /**
+     * @brief Smoothing factor of the latency average
+     * 
+     */
+    static constexpr double smoothing = 0.2;
+
+    /**
+     * @brief Frames to wait after a change before the next one
+     * 
+     */
+    static const int settle_frames = 5;
+
+    /**
+     * @brief Fraction of the target a step up must be predicted to stay under
+     * 
+     */
+    static constexpr double headroom = 0.8;
+
+    /**
+     * @brief Construct a new Resolution Controller
+     * 
+     * @param _widths candidate input widths, multiples of 32
+     * @param _aspect input height over width
+     * @param _target_ms per-frame latency target UNIT: [ms]
+     * @param start_width width to start at, the closest candidate is used
+     * @throw std::invalid_argument if there are no widths or the target is not positive
+     */
+    ResolutionController(const std::vector<int>& _widths, double _aspect,
+      double _target_ms, int start_width);
+
+    /**
+     * @brief Construct a controller from the ADAPTIVE_* robot parameters, starting at IMG_WIDTH_REQ
+     * 
+     */
+    explicit ResolutionController(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Records the latency of a frame run at the current size
+     * 
+     * @param ms UNIT: [ms]
+     * @return true if the input size changed
+     */
+    bool record(double ms);
+
+    /**
+     * @brief Gets the current network input size
+     * 
+     * @return std::array<int, 2> width, height, both multiples of 32
+     */
+    std::array<int, 2> get_input_size() const;
+
+    /**
+     * @brief Gets the resolution changes and the time spent at each size
+     * 
+     * @return ResolutionStats 
+     */
+    ResolutionStats get_stats() const {
+      return stats;
+    }
+};
@@ -0,0 +1,192 @@
+/**
+ * @file StageTimers.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Per-stage latency timers header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <ostream>
+#include <exception>
+#include <condition_variable>
+
+#include "./LatencyHistogram.hpp"
+
+/**
+ * @brief Timed stages of a frame, in pipeline order
+ * 
+ */
+enum class Stage {
+    PREP_FRAME,
+    BLOB,
+    FORWARD,
+    DECODE,
+    NMS,
+    ESTIMATE_XYZ,
+    FRAME
+};
+
+/**
+ * @brief One latency histogram per stage, and a thread that periodically writes them to JSON and Prometheus text files.
+ * 
+ * @details Recording costs two clock reads and a few relaxed atomic adds
+ * (see LatencyHistogram), well under a microsecond per stage. Components
+ * are given a pointer to the timers and record nothing while it is null.
+ * Building with -DNO_STAGE_TIMERS removes every STAGE_TIMER altogether.
+ */
+class StageTimers {
+ public:
+    static const int num_stages = static_cast<int>(Stage::FRAME) + 1;
+
+ private:
+    std::array<LatencyHistogram, num_stages> histograms;
+
+    std::string json_path{};
+    std::string prometheus_path{};
+    std::chrono::milliseconds dump_interval{0};
+    std::mutex dump_mtx;
+    std::condition_variable dump_cv;
+    bool dumping{false};
+    std::thread dump_thread{};
+    std::exception_ptr dump_error{nullptr};
+
+    void dump_loop();
+
+ public:
+    StageTimers() = default;
+
+    /**
+     * @brief Stops the dump thread, if any, after a last dump
+     * 
+     */
+    ~StageTimers();
+
+    StageTimers(const StageTimers&) = delete;
+    StageTimers& operator=(const StageTimers&) = delete;
+
+    /**
+     * @brief Gets the histogram of a stage
+     * 
+     * @param stage
+     * @return LatencyHistogram&
+     */
+    LatencyHistogram& operator[](Stage stage) {
+      return histograms[static_cast<int>(stage)];
+    }
+
+    /**
+     * @brief Gets the count, mean, percentiles and max of a stage
+     * 
+     * @param stage
+     * @return LatencySummary
+     */
+    LatencySummary summary(Stage stage) const {
+      return histograms[static_cast<int>(stage)].summary();
+    }
+
+    /**
+     * @brief Gets the name of a stage, as written to the dumps
+     * 
+     * @param stage
+     * @return const char*
+     */
+    static const char* stage_name(Stage stage);
+
+    /**
+     * @brief Forgets every latency
+     * 
+     */
+    void reset();
+
+    /**
+     * @brief Writes every stage as a JSON object keyed by stage name
+     * 
+     * @param out
+     */
+    void write_json(std::ostream& out) const;
+
+    /**
+     * @brief Writes every stage in the Prometheus text format, as a summary with p50, p90 and p99 quantiles and a max gauge
+     * 
+     * @param out
+     */
+    void write_prometheus(std::ostream& out) const;
+
+    /**
+     * @brief Writes both files now. Each is written next to its path and renamed over it, so readers never see a partial file.
+     * 
+     * @param _json_path skipped if empty
+     * @param _prometheus_path skipped if empty
+     * @throw InvalidFile if a file cannot be written
+     */
+    void dump(const std::string& _json_path,
+      const std::string& _prometheus_path) const;
+
+    /**
+     * @brief Starts dumping on a separate thread. Replaces any running dump.
+     * 
+     * @param _json_path skipped if empty
+     * @param _prometheus_path skipped if empty, e.g. a node_exporter textfile collector path
+     * @param interval time between dumps, positive
+     * @throw std::invalid_argument if the interval is not positive
+     */
+    void start_dump(const std::string& _json_path,
+      const std::string& _prometheus_path,
+      std::chrono::milliseconds interval);
+
+    /**
+     * @brief Dumps one last time, then stops the dump thread
+     * 
+     * @throw the first error raised while dumping, if any
+     */
+    void stop_dump();
+};
+
+/**
+ * @brief Records the time from its construction to its destruction into a stage, unless the timers are null.
+ * 
+ */
+class StageTimer {
+ private:
+    LatencyHistogram* histogram;
+    std::chrono::steady_clock::time_point start{};
+
+ public:
+    StageTimer(StageTimers* timers, Stage stage) :
+        histogram{timers ? &(*timers)[stage] : nullptr} {
+      if (histogram) start = std::chrono::steady_clock::now();
+    }
+
+    ~StageTimer() {
+      if (histogram)
+        histogram->record(std::chrono::steady_clock::now() - start);
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+};
+
+#define STAGE_TIMER_CONCAT_(a, b) a##b
+#define STAGE_TIMER_NAME_(line) STAGE_TIMER_CONCAT_(stage_timer_, line)
+
+/**
+ * @brief Times the rest of the enclosing scope into a stage of a StageTimers pointer
+ * 
+ */
+#ifdef NO_STAGE_TIMERS
+#define STAGE_TIMER(timers, stage)
+#else
+#define STAGE_TIMER(timers, stage) \
+    StageTimer STAGE_TIMER_NAME_(__LINE__)(timers, stage)
+#endif
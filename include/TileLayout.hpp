@@ -0,0 +1,80 @@
+/**
+ * @file TileLayout.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Tile Layout header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+/**
+ * @brief Overlapping full-resolution tiles over a horizontal band of the frame.
+ * 
+ * @details Distant people appear in a band of the frame (usually the upper
+ * part) and are only a few pixels tall once the whole frame is squashed
+ * to the NN input. The band is covered by NN-input sized tiles cut at the
+ * native resolution, so those people keep their size. Tiles overlap by at
+ * least the given fraction so a person cut by one seam is whole in the
+ * neighbouring tile. Every tile has the same size, so one resize table
+ * serves all of them.
+ */
+class TileLayout {
+ private:
+    double band_top;
+    double band_bottom;
+    double overlap;
+    cv::Size tile_size;
+
+    cv::Size frame_size{};
+    std::vector<cv::Rect> tiles{};
+
+    /**
+     * @brief Evenly spaced tile starts covering [begin, end) on one axis
+     * 
+     * @param begin start of the covered range
+     * @param end end of the covered range
+     * @param tile_len tile length, at most the frame length
+     * @param frame_len frame length
+     * @return std::vector<int> tile starts
+     */
+    std::vector<int> tile_starts(int begin, int end, int tile_len,
+      int frame_len) const;
+
+ public:
+    /**
+     * @brief Construct a new Tile Layout
+     * 
+     * @param _band_top top of the tiled band, as a fraction of the frame height
+     * @param _band_bottom bottom of the tiled band, as a fraction of the frame height
+     * @param _overlap minimum overlap between neighbouring tiles, as a fraction of the tile size
+     * @param _tile_size tile size, normally the NN input size
+     * @throw std::invalid_argument if the band is empty or the overlap is not in [0, 1)
+     */
+    TileLayout(double _band_top, double _band_bottom, double _overlap,
+      const cv::Size& _tile_size);
+
+    /**
+     * @brief Construct a layout from the TILE_* robot parameters. The tile size is the NN input size.
+     * 
+     */
+    explicit TileLayout(
+      const std::unordered_map<std::string, double>& robot_params);
+
+    /**
+     * @brief Gets the tiles of a frame. They are recomputed only when the frame size changes.
+     * 
+     * @param frame frame size
+     * @return tiles in frame pixels, top to bottom and left to right
+     */
+    const std::vector<cv::Rect>& get_tiles(const cv::Size& frame);
+};
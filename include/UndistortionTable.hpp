@@ -0,0 +1,115 @@
+/**
+ * @file UndistortionTable.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Lens undistortion lookup table header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @brief Intrinsics of a camera at its native resolution, with Brown-Conrady distortion as from cv::calibrateCamera.
+ * 
+ */
+struct CameraIntrinsics {
+    int width{0};
+    int height{0};
+    double fx{0};
+    double fy{0};
+    double cx{0};
+    double cy{0};
+
+    /**
+     * @brief k1, k2, p1, p2, k3
+     * 
+     */
+    std::array<double, 5> distortion{};
+
+    CameraIntrinsics() {}
+
+    /**
+     * @brief Reads CAM_IMG_WIDTH/HEIGHT, CAM_FX/FY/CX/CY and CAM_K1/K2/P1/P2/K3
+     * 
+     * @param robot_params
+     */
+    explicit CameraIntrinsics(const std::unordered_map<std::string, double>&
+      robot_params);
+
+    /**
+     * @brief Applies the lens distortion to an ideal ray
+     * 
+     * @param x ray x/z
+     * @param y ray y/z
+     * @return std::array<double, 2> distorted pixel UNIT: [px]
+     */
+    std::array<double, 2> distort(double x, double y) const;
+
+    /**
+     * @brief Removes the lens distortion from a pixel with the fixed-point iteration of cv::undistortPoints
+     * 
+     * @param u pixel x UNIT: [px]
+     * @param v pixel y UNIT: [px]
+     * @return std::array<double, 2> ideal ray x/z, y/z
+     */
+    std::array<double, 2> undistort(double u, double v) const;
+};
+
+/**
+ * @brief Maps pixels of the NN-resolution frame to undistorted camera rays.
+ * 
+ * @details Undistorting whole frames costs a remap per frame; positions
+ * only need a few points per detection. The table holds the ray of every
+ * step-th pixel, computed once, and lookups interpolate bilinearly
+ * between the four surrounding entries. Pixels outside the frame are
+ * clamped to its edge.
+ */
+class UndistortionTable {
+ private:
+    int step{1};
+    int cols{0};
+    int rows{0};
+    float scale_x{1};
+    float scale_y{1};
+    std::vector<float> ray_x{};
+    std::vector<float> ray_y{};
+
+ public:
+    /**
+     * @brief Precomputes the rays of a frame that is the camera image resized to img_w x img_h
+     * 
+     * @param intrinsics native resolution intrinsics
+     * @param img_w frame width UNIT: [px]
+     * @param img_h frame height UNIT: [px]
+     * @param _step table spacing UNIT: [px]
+     */
+    UndistortionTable(const CameraIntrinsics& intrinsics, int img_w,
+      int img_h, int _step = 4);
+
+    /**
+     * @brief Gets the undistorted ray through a frame pixel
+     * 
+     * @param u pixel x UNIT: [px]
+     * @param v pixel y UNIT: [px]
+     * @return std::array<float, 2> ray x/z, y/z
+     */
+    std::array<float, 2> ray(float u, float v) const;
+
+    /**
+     * @brief Get the table size in bytes
+     * 
+     * @return std::size_t
+     */
+    std::size_t get_bytes() const {
+      return (ray_x.size() + ray_y.size())*sizeof(float);
+    }
+};
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <memory>
@@ -21,14 +22,123 @@
 
 #include "./HumanDetector.hpp"
 #include "./PositionEstimator.hpp"
+#include "./VisionPipeline.hpp"
+#include "./DetectionTracker.hpp"
+#include "./MotionGate.hpp"
+#include "./ResolutionController.hpp"
+#include "./AnnotationSink.hpp"
+#include "./CameraRig.hpp"
+#include "./DetectorPool.hpp"
+#include "./DnnEngine.hpp"
+#include "./PersonTracker.hpp"
+#include "./FrameSource.hpp"
+#include "./AlertBus.hpp"
+#include "./StageTimers.hpp"
 #include "./Detection.hpp"
+#include "./utils.hpp"
 
 class VisionAPI {
  private:
     const std::unordered_map<std::string, double>& robot_params;
+
+    /**
+     * @brief Per-stage latency histograms, set when STAGE_TIMING is on. Declared first so it outlives everything recording into it.
+     * 
+     */
+    std::unique_ptr<StageTimers> timers{};
     HumanDetector detector;
     PositionEstimator estimator;
     std::array<double, 2> alert_thresholds{};
+    bool tiled_input{false};
+    std::unique_ptr<VisionPipeline> pipeline{};
+    std::unique_ptr<AnnotationSink> annotations{};
+
+    /**
+     * @brief Multi-camera rig, set when RIG_CAMERAS > 0
+     * 
+     */
+    std::unique_ptr<CameraRig> rig{};
+
+    /**
+     * @brief One detector per rig camera, run concurrently. Built by the first get_rig_xyz on the CPU target.
+     * 
+     */
+    std::unique_ptr<DetectorPool> rig_pool{};
+    std::string coco_name_path;
+    std::string yolo_cfg_path;
+    std::string yolo_weight_path;
+
+    /**
+     * @brief Robot-frame person tracker, set when PERSON_TRACKING is on
+     * 
+     */
+    std::unique_ptr<PersonTracker> people{};
+
+    /**
+     * @brief Detections of the last frame, reused by every call
+     * 
+     */
+    std::vector<Detection> detection_buffer{};
+
+    /**
+     * @brief Last frame read from a frame source, swapped back into its ring by the next read
+     * 
+     */
+    cv::Mat source_frame{};
+
+    /**
+     * @brief Alert subscribers, and when the last frame given to get_xyz or get_rig_xyz arrived
+     * 
+     */
+    AlertBus alerts;
+    std::chrono::steady_clock::time_point frame_arrival{};
+
+    /**
+     * @brief Publishes the alert for the closest of some people
+     * 
+     */
+    AlertEvent publish_closest(const std::array<double, 3>* closest,
+      std::uint64_t track_id, std::size_t people, double timestamp);
+
+    /**
+     * @brief Detect-then-track mode: the tracker and its grayscale frame buffer
+     * 
+     */
+    bool tracking_mode{false};
+    DetectionTracker tracker;
+    cv::Mat track_gray{};
+
+    /**
+     * @brief Motion gate in front of the detector and the last result it reuses
+     * 
+     */
+    bool motion_gate_on{false};
+    MotionGate gate;
+    std::vector<std::array<double, 3> > last_xyz{};
+    bool has_last_xyz{false};
+
+    /**
+     * @brief Adaptive network input size, driven by the per-frame latency
+     * 
+     */
+    bool adaptive_resolution{false};
+    ResolutionController resolution;
+
+    /**
+     * @brief get_xyz(img) once frame_arrival is set
+     * 
+     */
+    bool infer_xyz(const cv::Mat& orig_frame,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Runs the network on keyframes and tracks the detections in between
+     * 
+     * @param orig_frame original camera frame
+     * @return detections in NN input coordinates
+     */
+    std::shared_ptr<std::vector<Detection> > detect_tracked(
+      const cv::Mat& orig_frame);
 
  public:
     VisionAPI(const std::unordered_map<std::string, double>& _robot_params,
@@ -37,20 +147,224 @@ class VisionAPI {
         robot_params{_robot_params},
         detector(_robot_params, _coco_name_path,
           _yolo_cfg_path, _yolo_weight_path),
-        estimator(_robot_params) {
+        estimator(_robot_params),
+        coco_name_path{_coco_name_path},
+        yolo_cfg_path{_yolo_cfg_path},
+        yolo_weight_path{_yolo_weight_path},
+        tracker(_robot_params),
+        gate(_robot_params),
+        resolution(_robot_params) {
         alert_thresholds[0] = robot_params.at("LOW_ALERT_THRESHOLD");
         alert_thresholds[1] = robot_params.at("HIGH_ALERT_THRESHOLD");
+        tiled_input = get_param(robot_params, "TILED_INPUT", 0) != 0;
+        tracking_mode = get_param(robot_params, "TRACKING_MODE", 0) != 0;
+        motion_gate_on = get_param(robot_params, "MOTION_GATE", 0) != 0;
+        adaptive_resolution = get_param(robot_params,
+          "ADAPTIVE_RESOLUTION", 0) != 0;
+        if (adaptive_resolution) {
+          auto size = resolution.get_input_size();
+          detector.set_input_size(size[0], size[1]);
+        }
+        if (get_param(robot_params, "RIG_CAMERAS", 0) > 0)
+          rig.reset(new CameraRig(robot_params));
+        if (get_param(robot_params, "PERSON_TRACKING", 0) != 0)
+          people.reset(new PersonTracker(robot_params));
+        if (get_param(robot_params, "STAGE_TIMING", 0) != 0) {
+          timers.reset(new StageTimers());
+          detector.set_stage_timers(timers.get());
+          estimator.set_stage_timers(timers.get());
+        }
       }
 
     /**
      * @brief This method takes an image, finds all people within the image, and outputs the estimated postions in the ROBOT frame.
      * 
+     * @details With TILED_INPUT set, detection also runs full-resolution
+     * tiles over the TILE_* band (see HumanDetector::detect_tiled).
+     * With TRACKING_MODE set, the network only runs on keyframes and the
+     * detections are tracked in between (see DetectionTracker). With
+     * MOTION_GATE set, frames where the scene has not changed reuse the
+     * last result (see MotionGate). With ADAPTIVE_RESOLUTION set, the
+     * network input size follows the LATENCY_TARGET (see
+     * ResolutionController); positions are unaffected since detections
+     * stay in IMG_*_REQ coordinates.
+     * Streaming mode always runs the network on the whole frame.
+     * With show_detection set, a copy of the frame and its detections go
+     * to the annotation sink, started without an output if none is
+     * running, so drawing never adds to the detection latency. Poll
+     * get_annotated_frame() to show the drawn frames.
+     * 
      * @param img
      * @return All estimated x, y, z positions of people in a given image.
      */
     std::shared_ptr<std::vector<std::array<double, 3> > >
       get_xyz(const cv::Mat&, bool show_detection=false);
 
+    /**
+     * @brief Same as get_xyz(img), writing into a caller-owned buffer.
+     * 
+     * @details In the default mode (no tiling, tracking or resolution
+     * change) nothing is allocated once the buffers have grown to the
+     * largest number of people seen, apart from inside the inference
+     * engine (see HumanDetector::detect_frame).
+     * 
+     * @param img
+     * @param all_xyz output: All estimated x, y, z positions of people in the image, cleared first.
+     * @return false if the motion gate reused the last result instead of running detection.
+     */
+    bool get_xyz(const cv::Mat& img,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Same as get_xyz(img), on the next frame of a source that decoded it ahead on its own thread.
+     * 
+     * @details Only waits for decoding when the source falls behind, and
+     * reuses the source's frame buffers (see FrameSource).
+     * 
+     * @param source frames to read from
+     * @param all_xyz output: All estimated x, y, z positions of people in the frame, cleared first.
+     * @param timestamp output: capture time of the frame UNIT: [s]
+     * @param show_detection submit a copy of the frame and its detections to the annotation sink
+     * @return false once the source has no more frames.
+     */
+    bool get_xyz(FrameSource* source,
+      std::vector<std::array<double, 3> >* all_xyz, double* timestamp,
+      bool show_detection = false);
+
+    /**
+     * @brief Estimates the positions of people around a multi-camera rig, from one frame per camera taken at the same time.
+     * 
+     * @details On the CPU target, each camera runs on its own thread and
+     * its own detector of a pool, built by the first call so that
+     * single-camera use never loads it. OpenCV's thread count is left to
+     * the caller (see DetectorPool). On other targets all cameras share
+     * one batched forward pass instead (see CameraRig). Tiling,
+     * tracking, the motion gate and adaptive resolution only apply to
+     * single-camera get_xyz.
+     * 
+     * @param frames one frame per camera, in CAMERAk_ order
+     * @param all_xyz output: x, y, z positions in ROBOT frame, people seen by several cameras merged, cleared first
+     * @return false if no rig is configured.
+     */
+    bool get_rig_xyz(const std::vector<cv::Mat>& frames,
+      std::vector<std::array<double, 3> >* all_xyz);
+
+    /**
+     * @brief Follows the people of a frame from earlier frames, giving each a stable id.
+     * 
+     * @details Takes the positions of get_xyz, get_rig_xyz or pop_xyz, one
+     * frame at a time in capture order (see PersonTracker).
+     * 
+     * @param all_xyz x, y, z positions of the frame in ROBOT frame UNIT: [m]
+     * @param timestamp capture time of the frame UNIT: [s]
+     * @param tracks output: confirmed tracks, cleared first
+     * @return false if PERSON_TRACKING is off.
+     */
+    bool track_people(const std::vector<std::array<double, 3> >& all_xyz,
+      double timestamp, std::vector<PersonTrack>* tracks);
+
+    /**
+     * @brief Starts drawing detections on a separate thread. Replaces any running sink.
+     * 
+     * @param output receives annotated frames on the sink's thread, e.g. AnnotationSink::video, none if empty
+     * @param capacity frames that can wait to be drawn before the oldest is dropped
+     */
+    void start_annotations(
+      AnnotationSink::Output output = AnnotationSink::Output(),
+      std::size_t capacity = 2);
+
+    /**
+     * @brief Draws the frames still queued, then stops the annotation sink.
+     * 
+     */
+    void stop_annotations();
+
+    /**
+     * @brief Copies the newest annotated frame, if one was drawn since the last call
+     * 
+     * @details Call it from the main thread and show the frame there,
+     * since HighGUI windows must not be driven from worker threads.
+     * 
+     * @param frame output: the annotated frame, untouched if there is none
+     * @return true if a new frame was copied
+     */
+    bool get_annotated_frame(cv::Mat* frame) {
+      return annotations && annotations->take_latest(frame);
+    }
+
+    /**
+     * @brief Gets the submitted, rendered and dropped annotation frames
+     * 
+     * @return AnnotationStats 
+     */
+    AnnotationStats get_annotation_stats() const {
+      return annotations ? annotations->get_stats() : AnnotationStats{};
+    }
+
+    /**
+     * @brief Starts streaming mode. Preprocessing, inference and position estimation then run concurrently on their own worker threads.
+     * 
+     * @details get_xyz must not be called while streaming since both share
+     * the same network.
+     * 
+     * @param queue_capacity maximum number of items between two stages
+     */
+    void start_stream(std::size_t queue_capacity = 2);
+
+    /**
+     * @brief Submits a frame to the stream, blocking while it is full.
+     * 
+     * @param img
+     * @return false if the stream is not running.
+     */
+    bool push_frame(const cv::Mat& img);
+
+    /**
+     * @brief Gets the estimated positions of the next streamed frame, in submission order.
+     * 
+     * @param all_xyz output: All estimated x, y, z positions of people in the frame.
+     * @return false once the stream is finished and drained.
+     */
+    bool pop_xyz(std::shared_ptr<std::vector<std::array<double, 3> > >*
+      all_xyz);
+
+    /**
+     * @brief Stops accepting frames. Already submitted frames can still be popped.
+     * 
+     */
+    void finish_stream();
+
+    /**
+     * @brief Stops all stream workers, discarding unpopped results.
+     * 
+     */
+    void stop_stream();
+
+    /**
+     * @brief Gets stream throughput and per-stage queue depth
+     * 
+     * @return PipelineStats 
+     */
+    PipelineStats get_stream_stats();
+
+    /**
+     * @brief Gets the skip ratio and time saved by the motion gate
+     * 
+     * @return MotionGateStats 
+     */
+    MotionGateStats get_gate_stats() const {
+      return gate.get_stats();
+    }
+
+    /**
+     * @brief Gets the resolution changes and the time spent at each input size
+     * 
+     * @return ResolutionStats 
+     */
+    ResolutionStats get_resolution_stats() const {
+      return resolution.get_stats();
+    }
+
     /**
      * @brief Calculates the distance of how far the human is away from the robot
      * 
@@ -66,4 +380,63 @@ class VisionAPI {
      */
     void print_alerts(const std::vector<std::array<double, 3> >
       &all_xyz);
+
+    /**
+     * @brief Prints the robot's actions for the closest tracked person, so a single noisy frame does not change them
+     * 
+     * @param tracks confirmed tracks from track_people
+     */
+    void print_alerts(const std::vector<PersonTrack> &tracks);
+
+    /**
+     * @brief Publishes the robot's action for the closest person to the alert subscribers, without waiting for them.
+     * 
+     * @details The delivery latency of the alert is measured from the
+     * start of the get_xyz call that found the positions
+     * (see AlertBus::get_stats).
+     * 
+     * @param all_xyz positions from get_xyz
+     * @param timestamp capture time of the frame UNIT: [s]
+     * @return AlertEvent the published alert
+     */
+    AlertEvent publish_alerts(
+      const std::vector<std::array<double, 3> >& all_xyz, double timestamp);
+
+    /**
+     * @brief Publishes the robot's action for the closest tracked person, so a single noisy frame does not change it
+     * 
+     * @param tracks confirmed tracks from track_people
+     * @param timestamp capture time of the frame UNIT: [s]
+     * @return AlertEvent the published alert
+     */
+    AlertEvent publish_alerts(const std::vector<PersonTrack>& tracks,
+      double timestamp);
+
+    /**
+     * @brief Gets the alert bus, to subscribe motor control, logging and other consumers
+     * 
+     * @return AlertBus& 
+     */
+    AlertBus& get_alert_bus() {
+      return alerts;
+    }
+
+    /**
+     * @brief Gets the latency of each stage of get_xyz, streaming and rig detection so far
+     * 
+     * @return StageTimers* nullptr if STAGE_TIMING is off
+     */
+    StageTimers* get_stage_timers() {
+      return timers.get();
+    }
+
+    /**
+     * @brief Starts writing the stage latencies to a JSON and a Prometheus text file every STAGE_DUMP_INTERVAL, on a separate thread.
+     * 
+     * @param json_path skipped if empty
+     * @param prometheus_path skipped if empty
+     * @return false if STAGE_TIMING is off.
+     */
+    bool start_stage_dump(const std::string& json_path,
+      const std::string& prometheus_path);
 };
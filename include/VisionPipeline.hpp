@@ -0,0 +1,118 @@
+/**
+ * @file VisionPipeline.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Vision Pipeline header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <opencv2/opencv.hpp>
+
+#include "./BoundedQueue.hpp"
+#include "./HumanDetector.hpp"
+#include "./PositionEstimator.hpp"
+#include "./Detection.hpp"
+
+/**
+ * @brief Throughput and queue statistics of a running pipeline.
+ * 
+ * @details Queues are ordered input, preprocessed, inferred, output.
+ */
+struct PipelineStats {
+    std::size_t frames_in{0};
+    std::size_t frames_out{0};
+    double throughput_fps{0};
+    std::array<std::size_t, 4> queue_depth{};
+    std::array<std::size_t, 4> max_queue_depth{};
+};
+
+/**
+ * @brief Streams frames through preprocess -> infer -> estimate stages, each on its own worker thread.
+ * 
+ * @details While frame N is in the network, frame N+1 is being
+ * preprocessed and frame N-1 parsed and position estimated. Every stage
+ * has a single worker and FIFO queues, so results come out in input order.
+ */
+class VisionPipeline {
+ private:
+    typedef std::shared_ptr<std::vector<std::array<double, 3> > > XYZPtr;
+
+    HumanDetector& detector;
+    PositionEstimator& estimator;
+
+    BoundedQueue<cv::Mat> input_queue;
+    BoundedQueue<cv::Mat> preprocessed_queue;
+    BoundedQueue<std::vector<cv::Mat> > inferred_queue;
+    BoundedQueue<XYZPtr> output_queue;
+
+    std::vector<std::thread> workers{};
+
+    std::mutex stats_mtx;
+    std::size_t frames_in{0};
+    std::size_t frames_out{0};
+    std::chrono::steady_clock::time_point first_frame_time{};
+    std::chrono::steady_clock::time_point last_result_time{};
+    std::exception_ptr worker_error{nullptr};
+
+    /**
+     * @brief Closes every queue so all workers and callers wake up and exit.
+     * 
+     * @param error exception raised by a worker, if any
+     */
+    void abort(std::exception_ptr error);
+
+    void preprocess_loop();
+    void infer_loop();
+    void estimate_loop();
+
+ public:
+    VisionPipeline(HumanDetector* _detector, PositionEstimator* _estimator,
+      std::size_t queue_capacity);
+
+    ~VisionPipeline();
+
+    VisionPipeline(const VisionPipeline&) = delete;
+    VisionPipeline& operator=(const VisionPipeline&) = delete;
+
+    /**
+     * @brief Submits a frame, blocking while the input queue is full.
+     * 
+     * @param frame 
+     * @return false if the pipeline has been stopped.
+     */
+    bool push(const cv::Mat& frame);
+
+    /**
+     * @brief Gets the next result, in frame submission order.
+     * 
+     * @param all_xyz output: x, y, z position of EACH human in ROBOT frame UNIT: [m]
+     * @return false once the pipeline is finished and drained.
+     */
+    bool pop(std::shared_ptr<std::vector<std::array<double, 3> > >* all_xyz);
+
+    /**
+     * @brief Stops accepting frames. Frames already submitted are still processed and can be popped.
+     * 
+     */
+    void finish();
+
+    /**
+     * @brief Gets throughput and per-stage queue depth
+     * 
+     * @return PipelineStats 
+     */
+    PipelineStats get_stats();
+};
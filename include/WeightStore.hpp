@@ -0,0 +1,62 @@
+/**
+ * @file WeightStore.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Weight Store header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "DarknetModel.hpp"
+
+/**
+ * @brief Process-wide registry of the Darknet models in use, keyed by their cfg and weight paths.
+ * 
+ * @details Requests for a model, from any thread, get the same read-only
+ * model as long as someone still holds it, so networks built while it is
+ * held share their weight blobs (see DarknetModel). The store itself only
+ * keeps weak references: once the last holder releases a model, its
+ * weights are unmapped and the next request loads it again.
+ */
+class WeightStore {
+ private:
+    static std::mutex mtx;
+    static std::map<std::pair<std::string, std::string>,
+      std::weak_ptr<const DarknetModel> > models;
+
+ public:
+    /**
+     * @brief Gets a model, loading it if nobody holds it
+     * 
+     * @param cfg_path path to the YOLO cfg
+     * @param weight_path path to the YOLO weights
+     * @return std::shared_ptr<const DarknetModel> 
+     * @throw InvalidFile if either file cannot be read
+     */
+    static std::shared_ptr<const DarknetModel> get(const std::string& cfg_path,
+      const std::string& weight_path);
+
+    /**
+     * @brief Forgets every model. Models still held elsewhere stay mapped until released, but are no longer handed out.
+     * 
+     */
+    static void clear();
+
+    /**
+     * @brief Gets the number of models still held somewhere
+     * 
+     * @return std::size_t 
+     */
+    static std::size_t size();
+};
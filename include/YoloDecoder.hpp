@@ -0,0 +1,94 @@
+/**
+ * @file YoloDecoder.hpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief YOLO Decoder header
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include "FramePreprocessor.hpp"
+
+/**
+ * @brief Person-only decoder for YOLO region layer outputs.
+ * 
+ * @details Each output row is [cx, cy, w, h, objectness, class scores...]
+ * where every class score is objectness*P(class), so a row whose
+ * objectness is below the threshold can never pass it. Rows are first
+ * rejected on objectness (8 rows at a time with AVX2 gathers), and only the
+ * box and person columns of the survivors are read. Models pruned to
+ * person only (see DarknetPruner) have 6 columns and a one-line names
+ * file, so the person column is simply column 5.
+ */
+class YoloDecoder {
+ private:
+    int person_idx{-1};
+    double threshold;
+
+    /**
+     * @brief Largest float not above the threshold, so the float objectness prefilter never rejects a row the double comparison would keep.
+     * 
+     */
+    float prefilter_threshold;
+
+    /**
+     * @brief Appends the box of a single row if its person score passes the threshold
+     * 
+     * @param row first column of the row
+     * @param letterbox mapping from letterboxed NN coordinates to the squashed frame
+     * @param img_dim NN input width and height
+     * @param boxes output boxes
+     * @param scores output person scores
+     */
+    void decode_row(const float* row, const Letterbox& letterbox,
+      const std::array<int, 2>& img_dim, std::vector<cv::Rect>* boxes,
+      std::vector<float>* scores) const;
+
+ public:
+    /**
+     * @brief Construct a new YOLO Decoder
+     * 
+     * @param class_names class names in network output order (coco.names)
+     * @param _threshold minimum person score of a kept row
+     * @throw InvalidFile if there is no "person" class
+     */
+    YoloDecoder(const std::vector<std::string>& class_names,
+      double _threshold);
+
+    /**
+     * @brief Decodes one output layer, appending person boxes and scores.
+     * 
+     * @details The output vectors are not cleared so several layers can be
+     * decoded into the same reusable buffers.
+     * 
+     * @param data continuous rows x cols float output
+     * @param rows number of candidate rows
+     * @param cols number of columns (5 + number of classes)
+     * @param letterbox mapping from letterboxed NN coordinates to the squashed frame
+     * @param img_dim NN input width and height
+     * @param boxes output boxes in NN input pixels
+     * @param scores output person scores
+     */
+    void decode(const float* data, int rows, int cols,
+      const Letterbox& letterbox, const std::array<int, 2>& img_dim,
+      std::vector<cv::Rect>* boxes, std::vector<float>* scores) const;
+
+    /**
+     * @brief Gets the index of the person class
+     * 
+     * @return int 
+     */
+    int get_person_idx() const {
+      return person_idx;
+    }
+};
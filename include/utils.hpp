@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <unordered_map>
 
 /**
  * @brief InvalidFile exception for parsers.
@@ -56,3 +57,21 @@ void split(const std::string &s, char delim, Out result);
  * @return std::vector<std::string> 
  */
 std::vector<std::string> split(const std::string &s, char delim = ' ');
+
+/**
+ * @brief Gets an optional robot parameter, falling back to a default when it is not in the params file.
+ * 
+ * @param robot_params parsed robot parameters
+ * @param name parameter name
+ * @param default_value value used when the parameter is missing
+ * @return double 
+ */
+double get_param(const std::unordered_map<std::string, double>& robot_params,
+    const std::string& name, double default_value);
+
+/**
+ * @brief Gets the resident memory of this process
+ * 
+ * @return std::size_t UNIT: [bytes], 0 if /proc is not available
+ */
+std::size_t resident_memory_bytes();
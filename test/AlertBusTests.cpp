@@ -0,0 +1,202 @@
+/**
+ * @file AlertBusTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Alert Bus Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../include/AlertBus.hpp"
+#include "../include/BroadcastRing.hpp"
+#include "../include/LatencyHistogram.hpp"
+
+namespace {
+
+AlertEvent event_at(double distance) {
+    AlertEvent event;
+    event.people = 1;
+    event.min_distance = distance;
+    event.xyz = {{distance, 0, 0}};
+    event.level = AlertBus::classify(distance, 3, 1);
+    event.arrival_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return event;
+}
+
+}  // namespace
+
+TEST(AlertBusTests, ClassifyTest) {
+    EXPECT_EQ(AlertBus::classify(0.5, 3, 1), AlertLevel::STOP);
+    EXPECT_EQ(AlertBus::classify(1, 3, 1), AlertLevel::REDIRECT);
+    EXPECT_EQ(AlertBus::classify(3, 3, 1), AlertLevel::REDIRECT);
+    EXPECT_EQ(AlertBus::classify(3.5, 3, 1), AlertLevel::CONTINUE);
+    EXPECT_EQ(AlertBus::classify(std::numeric_limits<double>::infinity(),
+        3, 1), AlertLevel::CONTINUE);
+
+    std::ostringstream out;
+    AlertBus::console(out)(event_at(0.5));
+    EXPECT_EQ(out.str(), "Human is 0.5 meters away, danger!\n"
+        "Robot needs to stop.\n");
+}
+
+/**
+ * @brief Every subscriber gets every alert in order, and only those published after it subscribed.
+ * 
+ */
+TEST(AlertBusTests, BroadcastTest) {
+    AlertBus bus(16);
+    bus.publish(event_at(10));
+    auto motor = bus.subscribe();
+    auto logger = bus.subscribe();
+    for (int i = 0; i < 5; i++)
+        EXPECT_EQ(bus.publish(event_at(i)), static_cast<std::uint64_t>(i + 2));
+
+    AlertEvent event;
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(motor.poll(&event));
+        EXPECT_DOUBLE_EQ(event.min_distance, i);
+        EXPECT_EQ(event.sequence, static_cast<std::uint64_t>(i + 2));
+    }
+    EXPECT_FALSE(motor.poll(&event));
+    ASSERT_TRUE(logger.poll(&event));
+    EXPECT_EQ(event.level, AlertLevel::STOP);
+
+    auto stats = bus.get_stats();
+    EXPECT_EQ(stats.published, 6u);
+    EXPECT_EQ(stats.delivered, 6u);
+    EXPECT_EQ(stats.lost, 0u);
+    EXPECT_EQ(stats.latency.count, 6u);
+    EXPECT_GE(stats.latency.max_ms, stats.latency.p50_ms);
+}
+
+/**
+ * @brief A subscriber that falls behind skips to the oldest alert kept, and the loss is counted.
+ * 
+ */
+TEST(AlertBusTests, SlowSubscriberTest) {
+    AlertBus bus(8);
+    auto slow = bus.subscribe();
+    for (int i = 0; i < 20; i++) bus.publish(event_at(i));
+
+    AlertEvent event;
+    ASSERT_TRUE(slow.poll(&event));
+    EXPECT_DOUBLE_EQ(event.min_distance, 12);
+    int received = 1;
+    while (slow.poll(&event)) received++;
+    EXPECT_EQ(received, 8);
+    EXPECT_EQ(bus.get_stats().lost, 12u);
+}
+
+/**
+ * @brief Handlers receive every alert on their own threads while the publisher keeps going, and their errors come out of finish().
+ * 
+ */
+TEST(AlertBusTests, HandlerTest) {
+    AlertBus bus(1024, std::chrono::microseconds(50));
+    std::mutex mtx;
+    std::vector<double> motor, logger;
+    bus.subscribe([&](const AlertEvent& event) {
+        std::lock_guard<std::mutex> lock(mtx);
+        motor.push_back(event.min_distance);
+    });
+    bus.subscribe([&](const AlertEvent& event) {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+        std::lock_guard<std::mutex> lock(mtx);
+        logger.push_back(event.min_distance);
+    });
+    for (int i = 0; i < 500; i++) bus.publish(event_at(i));
+    bus.finish();
+
+    ASSERT_EQ(motor.size(), 500u);
+    ASSERT_EQ(logger.size(), 500u);
+    for (int i = 0; i < 500; i++) {
+        EXPECT_DOUBLE_EQ(motor[i], i);
+        EXPECT_DOUBLE_EQ(logger[i], i);
+    }
+
+    bus.subscribe([](const AlertEvent&) {
+        throw std::runtime_error("motor offline");
+    });
+    bus.publish(event_at(1));
+    EXPECT_THROW(bus.finish(), std::runtime_error);
+}
+
+/**
+ * @brief Readers racing a fast publisher never see a torn item.
+ * 
+ */
+TEST(AlertBusTests, RingRaceTest) {
+    struct Item {
+        std::uint64_t a, b, c;
+    };
+    BroadcastRing<Item> ring(4);
+    const std::uint64_t count = 200000;
+    std::vector<std::thread> readers;
+    std::vector<std::uint64_t> seen(2, 0), lost(2, 0);
+    for (int r = 0; r < 2; r++) {
+        readers.emplace_back([&, r, cursor = ring.tail()]() mutable {
+            std::uint64_t last = 0;
+            Item item;
+            std::uint64_t skipped;
+            while (last + 1 < count) {
+                bool got = ring.read(&cursor, &item, &skipped);
+                lost[r] += skipped;
+                if (!got) continue;
+                ASSERT_EQ(item.b, 2*item.a);
+                ASSERT_EQ(item.c, 3*item.a);
+                ASSERT_GE(item.a, last);
+                last = item.a;
+                seen[r]++;
+            }
+        });
+    }
+    for (std::uint64_t i = 0; i < count; i++)
+        ring.publish(Item{i, 2*i, 3*i});
+    for (auto& reader : readers) reader.join();
+    for (int r = 0; r < 2; r++) EXPECT_GT(seen[r], 0u);
+}
+
+TEST(AlertBusTests, HistogramTest) {
+    EXPECT_EQ(LatencyHistogram::bucket_index(15), 15);
+    EXPECT_EQ(LatencyHistogram::bucket_upper_ns(15), 15u);
+    for (std::uint64_t ns : {16ull, 17ull, 1000ull, 123456789ull,
+            (1ull << 62) + 12345}) {
+        int index = LatencyHistogram::bucket_index(ns);
+        ASSERT_LT(index, LatencyHistogram::num_buckets);
+        EXPECT_GE(LatencyHistogram::bucket_upper_ns(index), ns);
+        EXPECT_LE(LatencyHistogram::bucket_upper_ns(index), ns + ns/8);
+        EXPECT_LT(LatencyHistogram::bucket_upper_ns(index - 1), ns);
+    }
+
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.summary().count, 0u);
+    // 1 ms to 100 ms in 1 ms steps
+    for (int ms = 1; ms <= 100; ms++)
+        histogram.record(std::chrono::milliseconds(ms));
+    auto summary = histogram.summary();
+    EXPECT_EQ(summary.count, 100u);
+    EXPECT_NEAR(summary.mean_ms, 50.5, 1e-9);
+    EXPECT_NEAR(summary.p50_ms, 50, 50/8.0);
+    EXPECT_NEAR(summary.p90_ms, 90, 90/8.0);
+    EXPECT_NEAR(summary.p99_ms, 99, 1);
+    EXPECT_DOUBLE_EQ(summary.max_ms, 100);
+    EXPECT_GE(summary.p50_ms, 50);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.summary().count, 0u);
+}
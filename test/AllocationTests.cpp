@@ -0,0 +1,218 @@
+/**
+ * @file AllocationTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Steady-state allocation Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <new>
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <utility>
+#include <opencv2/opencv.hpp>
+
+#include "../include/params_vec.hpp"
+#include "../include/NMSEngine.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/InferenceEngine.hpp"
+#include "../include/PositionEstimator.hpp"
+
+namespace {
+
+/**
+ * @brief Heap allocations made by this thread while counting is on
+ * 
+ */
+thread_local bool counting = false;
+thread_local std::size_t allocations = 0;
+
+/**
+ * @brief Counts cv::Mat buffers, which OpenCV allocates with malloc rather than operator new.
+ * 
+ */
+class CountingMatAllocator : public cv::MatAllocator {
+ public:
+#if CV_VERSION_MAJOR >= 4
+    typedef cv::AccessFlag Flags;
+#else
+    typedef int Flags;
+#endif
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data,
+        std::size_t* step, Flags flags, cv::UMatUsageFlags usage) const
+        override {
+      if (counting) allocations++;
+      return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data,
+          step, flags, usage);
+    }
+
+    bool allocate(cv::UMatData* data, Flags flags,
+        cv::UMatUsageFlags usage) const override {
+      return cv::Mat::getStdAllocator()->allocate(data, flags, usage);
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+      cv::Mat::getStdAllocator()->deallocate(data);
+    }
+};
+
+/**
+ * @brief Counts the allocations of a scope
+ * 
+ */
+class AllocationCounter {
+ private:
+    CountingMatAllocator mat_allocator{};
+    cv::MatAllocator* previous;
+
+ public:
+    AllocationCounter() : previous{cv::Mat::getDefaultAllocator()} {
+      cv::Mat::setDefaultAllocator(&mat_allocator);
+      allocations = 0;
+      counting = true;
+    }
+
+    ~AllocationCounter() {
+      counting = false;
+      cv::Mat::setDefaultAllocator(previous);
+    }
+
+    std::size_t count() const {
+      return allocations;
+    }
+};
+
+/**
+ * @brief Engine that returns fixed YOLO outputs: three layers with a few people.
+ * 
+ */
+class SyntheticEngine : public InferenceEngine {
+ private:
+    std::vector<cv::Mat> outputs{};
+
+ public:
+    SyntheticEngine() {
+      for (int rows : {507, 2028, 8112}) {
+        cv::Mat output(rows, 85, CV_32F, cv::Scalar(0));
+        for (int i = 0; i < 4; i++) {
+          float* row = output.ptr<float>(rows/5*(i + 1));
+          row[0] = 0.15f + 0.2f*i;
+          row[1] = 0.5f;
+          row[2] = 0.1f;
+          row[3] = 0.3f;
+          row[4] = 0.9f;
+          row[5] = 0.85f;
+        }
+        outputs.push_back(output);
+      }
+    }
+
+    void set_input(const cv::Mat&) override {}
+
+    void forward(std::vector<cv::Mat>* _outputs) override {
+      _outputs->resize(outputs.size());
+      for (std::size_t i = 0; i < outputs.size(); i++)
+        (*_outputs)[i] = outputs[i];
+    }
+
+    std::string get_name() const override {
+      return "synthetic";
+    }
+};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    if (counting) allocations++;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+/**
+ * @brief After warm-up, a frame through detect_frame and estimate_all_xyz with caller-owned buffers makes no heap allocation.
+ * 
+ */
+TEST(AllocationTests, SteadyStateDetectionTest) {
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    HumanDetector detector(ret_params, "../robot_params/coco.names",
+        std::unique_ptr<InferenceEngine>(new SyntheticEngine()));
+    PositionEstimator estimator(ret_params);
+
+    cv::Mat frame(480, 640, CV_8UC3);
+    cv::randu(frame, cv::Scalar(0, 0, 0), cv::Scalar(255, 255, 255));
+    std::vector<Detection> detections;
+    std::vector<std::array<double, 3> > all_xyz;
+    for (int i = 0; i < 2; i++) {
+        detector.detect_frame(frame, &detections);
+        estimator.estimate_all_xyz(detections, &all_xyz);
+    }
+    ASSERT_EQ(detections.size(), 4u);
+
+    std::size_t count;
+    {
+        AllocationCounter counter;
+        for (int i = 0; i < 10; i++) {
+            detector.detect_frame(frame, &detections);
+            estimator.estimate_all_xyz(detections, &all_xyz);
+        }
+        count = counter.count();
+    }
+    EXPECT_EQ(count, 0u) << count/10.0 << " allocations per frame";
+    EXPECT_EQ(detections.size(), 4u);
+    EXPECT_EQ(all_xyz.size(), 4u);
+}
+
+/**
+ * @brief Warmed-up NMS and soft-NMS reuse their buffers.
+ * 
+ */
+TEST(AllocationTests, SteadyStateNMSTest) {
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> position(0, 400), width(10, 60),
+        height(20, 120);
+    std::uniform_real_distribution<float> score(0.f, 1.f);
+    for (int i = 0; i < 300; i++) {
+        boxes.emplace_back(position(rng), position(rng), width(rng),
+            height(rng));
+        scores.push_back(score(rng));
+    }
+
+    NMSEngine nms;
+    std::vector<int> indices;
+    std::vector<float> updated;
+    for (int i = 0; i < 2; i++) {
+        nms.nms_boxes(boxes, scores, 0.3f, 0.4f, &indices);
+        nms.soft_nms_boxes(boxes, scores, 0.3f, 0.4f, 0.5f,
+            NMSEngine::GAUSSIAN, &indices, &updated);
+    }
+
+    AllocationCounter counter;
+    nms.nms_boxes(boxes, scores, 0.3f, 0.4f, &indices);
+    nms.soft_nms_boxes(boxes, scores, 0.3f, 0.4f, 0.5f, NMSEngine::GAUSSIAN,
+        &indices, &updated);
+    EXPECT_EQ(counter.count(), 0u);
+}
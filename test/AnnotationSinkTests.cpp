@@ -0,0 +1,144 @@
+/**
+ * @file AnnotationSinkTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Annotation Sink Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <condition_variable>
+#include <opencv2/opencv.hpp>
+
+#include "../include/Detection.hpp"
+#include "../include/BoundedQueue.hpp"
+#include "../include/AnnotationSink.hpp"
+
+/**
+ * @brief Boxes are scaled from NN input coordinates to the frame, and the submitted frame is left untouched.
+ * 
+ */
+TEST(AnnotationSinkTests, RenderTest) {
+    std::vector<cv::Mat> rendered;
+    AnnotationSink sink({{416, 416}}, [&rendered](const cv::Mat& frame) {
+        rendered.push_back(frame.clone());
+    });
+
+    cv::Mat frame(832, 832, CV_8UC3, cv::Scalar(0, 0, 0));
+    auto detections = std::make_shared<std::vector<Detection> >(
+        std::vector<Detection>{Detection(100, 100, 50, 100)});
+    EXPECT_TRUE(sink.submit(frame, detections));
+    sink.finish();
+
+    ASSERT_EQ(rendered.size(), 1u);
+    EXPECT_EQ(rendered[0].at<cv::Vec3b>(300, 200), cv::Vec3b(255, 178, 50));
+    EXPECT_EQ(rendered[0].at<cv::Vec3b>(300, 100), cv::Vec3b(0, 0, 0));
+    EXPECT_EQ(cv::countNonZero(frame.reshape(1)), 0);
+
+    auto stats = sink.get_stats();
+    EXPECT_EQ(stats.submitted, 1u);
+    EXPECT_EQ(stats.rendered, 1u);
+    EXPECT_EQ(stats.dropped, 0u);
+}
+
+/**
+ * @brief Without an output, the newest frame is handed once to the polling caller, with the confidence in the box label.
+ * 
+ */
+TEST(AnnotationSinkTests, TakeLatestTest) {
+    AnnotationSink sink(std::array<int, 2>{{416, 416}});
+    cv::Mat annotated;
+    EXPECT_FALSE(sink.take_latest(&annotated));
+
+    cv::Mat frame(416, 416, CV_8UC3, cv::Scalar(0, 0, 0));
+    auto unlabeled = std::make_shared<std::vector<Detection> >(
+        std::vector<Detection>{Detection(100, 200, 50, 100)});
+    auto labeled = std::make_shared<std::vector<Detection> >(
+        std::vector<Detection>{Detection(100, 200, 50, 100, 0.87f)});
+    sink.submit(frame, unlabeled);
+    sink.submit(frame, labeled);
+    sink.finish();
+
+    ASSERT_TRUE(sink.take_latest(&annotated));
+    EXPECT_FALSE(sink.take_latest(&annotated));
+    EXPECT_EQ(sink.get_stats().rendered, 2u);
+
+    // The white label background grows with the ":0.87" suffix
+    cv::Mat unlabeled_frame = frame.clone();
+    AnnotationSink::draw(*unlabeled, {{416, 416}}, &unlabeled_frame);
+    cv::Mat white;
+    cv::inRange(annotated, cv::Scalar(255, 255, 255),
+        cv::Scalar(255, 255, 255), white);
+    int labeled_white = cv::countNonZero(white);
+    cv::inRange(unlabeled_frame, cv::Scalar(255, 255, 255),
+        cv::Scalar(255, 255, 255), white);
+    EXPECT_GT(labeled_white, cv::countNonZero(white));
+}
+
+/**
+ * @brief A stalled output never blocks submit(); the oldest frames are dropped instead.
+ * 
+ */
+TEST(AnnotationSinkTests, DropWhenBehindTest) {
+    std::mutex mtx;
+    std::condition_variable cv_release;
+    bool released = false;
+    AnnotationSink sink({{416, 416}}, [&](const cv::Mat&) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv_release.wait(lock, [&released]() { return released; });
+    }, 2);
+
+    cv::Mat frame(64, 64, CV_8UC3, cv::Scalar(0, 0, 0));
+    for (int i = 0; i < 20; i++) sink.submit(frame, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        released = true;
+    }
+    cv_release.notify_all();
+    sink.finish();
+
+    auto stats = sink.get_stats();
+    EXPECT_EQ(stats.submitted, 20u);
+    EXPECT_EQ(stats.rendered + stats.dropped, 20u);
+    // At most one frame in the output plus a full queue get rendered.
+    EXPECT_LE(stats.rendered, 3u);
+    EXPECT_FALSE(sink.submit(frame, nullptr));
+}
+
+/**
+ * @brief push_evict keeps the newest items of a full queue.
+ * 
+ */
+TEST(AnnotationSinkTests, PushEvictTest) {
+    BoundedQueue<int> queue(2);
+    EXPECT_EQ(queue.push_evict(1), 0u);
+    EXPECT_EQ(queue.push_evict(2), 0u);
+    EXPECT_EQ(queue.push_evict(3), 1u);
+    int item;
+    ASSERT_TRUE(queue.pop(&item));
+    EXPECT_EQ(item, 2);
+    queue.close();
+    EXPECT_EQ(queue.push_evict(4), 1u);
+}
+
+/**
+ * @brief Errors raised by the output are reported by finish().
+ * 
+ */
+TEST(AnnotationSinkTests, OutputErrorTest) {
+    AnnotationSink sink({{416, 416}}, [](const cv::Mat&) {
+        throw std::runtime_error("output failed");
+    });
+    sink.submit(cv::Mat(8, 8, CV_8UC3), nullptr);
+    EXPECT_THROW(sink.finish(), std::runtime_error);
+}
@@ -0,0 +1,145 @@
+/**
+ * @file CameraRigTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Camera Rig Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/Detection.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/CameraRig.hpp"
+#include "../include/DetectorPool.hpp"
+#include "../include/HumanDetector.hpp"
+
+namespace {
+
+std::unordered_map<std::string, double> rig_params(int num_cameras) {
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    ret_params["RIG_CAMERAS"] = num_cameras;
+    return ret_params;
+}
+
+}  // namespace
+
+TEST(CameraRigTests, CameraParamsTest) {
+    const double PI = std::atan(1.0)*4;
+    ParamParser parser(all_params::params);
+    EXPECT_EQ(parser.get_base_name("CAMERA12_CAM_FX"), "CAM_FX");
+    EXPECT_EQ(parser.get_base_name("CAMERA_FX"), "CAMERA_FX");
+    EXPECT_EQ(parser.get_base_name("CAMERA3"), "CAMERA3");
+    EXPECT_EQ(parser.get_base_name("CAM_FX"), "CAM_FX");
+
+    auto params = rig_params(4);
+    auto front = CameraRig::camera_params(params, 0);
+    auto rear = CameraRig::camera_params(params, 1);
+    EXPECT_DOUBLE_EQ(front.at("PITCH_CAM2ROBOT_CENTER"), 90*PI/180);
+    // Units of block entries follow the parameter they override
+    EXPECT_NEAR(rear.at("PITCH_CAM2ROBOT_CENTER"), 270*PI/180, 1e-9);
+    EXPECT_DOUBLE_EQ(rear.at("DX_CAM2ROBOT_CENTER"), -0.3);
+    EXPECT_DOUBLE_EQ(rear.at("CAM_FOCAL_LEN"), front.at("CAM_FOCAL_LEN"));
+
+    params["CAMERA1_UNKNOWN_PARAM"] = 1;
+    EXPECT_EQ(CameraRig::camera_params(params, 1).count("UNKNOWN_PARAM"),
+        1u);
+    EXPECT_EQ(CameraRig::camera_params(params, 0).count("UNKNOWN_PARAM"),
+        0u);
+}
+
+/**
+ * @brief A person in the middle of each camera's image is in front of, behind, left and right of the robot.
+ * 
+ */
+TEST(CameraRigTests, ExtrinsicsTest) {
+    CameraRig rig(rig_params(4));
+    ASSERT_EQ(rig.size(), 4u);
+    Detection centered(198, 140, 20, 120);
+
+    auto front = rig.get_estimator(0).estimate_xyz(centered);
+    auto rear = rig.get_estimator(1).estimate_xyz(centered);
+    auto left = rig.get_estimator(2).estimate_xyz(centered);
+    auto right = rig.get_estimator(3).estimate_xyz(centered);
+    EXPECT_GT(front[0], 1);
+    EXPECT_LT(rear[0], -1);
+    EXPECT_GT(left[2], 1);
+    EXPECT_LT(right[2], -1);
+    EXPECT_NEAR(rear[0] + 0.3, -(front[0] - 0.02), 0.05);
+
+    EXPECT_THROW(CameraRig bad(rig_params(0)), std::invalid_argument);
+    std::vector<std::array<double, 3> > all_xyz;
+    EXPECT_THROW(rig.get_xyz(static_cast<HumanDetector*>(nullptr),
+        std::vector<cv::Mat>(2), &all_xyz), std::invalid_argument);
+}
+
+TEST(CameraRigTests, MergeTest) {
+    auto params = rig_params(3);
+    params["RIG_MERGE_DISTANCE"] = 0.5;
+    CameraRig rig(params);
+
+    std::vector<std::vector<std::array<double, 3> > > per_camera{
+        {{{2, 0, 1}}, {{2, 0, 1.3}}},
+        {{{-3, 0, 0}}},
+        {{{2.2, 0, 1.1}}, {{2.1, 0, 1.25}}, {{5, 0, 5}}}};
+    std::vector<std::array<double, 3> > all_xyz{{{9, 9, 9}}};
+    rig.merge(per_camera, &all_xyz);
+
+    // Two people close together in camera 0 stay apart, and each one
+    // takes the closest position of camera 2.
+    ASSERT_EQ(all_xyz.size(), 4u);
+    EXPECT_NEAR(all_xyz[0][0], 2.1, 1e-9);
+    EXPECT_NEAR(all_xyz[0][2], 1.05, 1e-9);
+    EXPECT_NEAR(all_xyz[1][0], 2.05, 1e-9);
+    EXPECT_NEAR(all_xyz[1][2], 1.275, 1e-9);
+    EXPECT_DOUBLE_EQ(all_xyz[2][0], -3);
+    EXPECT_DOUBLE_EQ(all_xyz[3][2], 5);
+
+    rig.merge({{}, {}, {}}, &all_xyz);
+    EXPECT_TRUE(all_xyz.empty());
+}
+
+/**
+ * @brief The concurrent, pooled rig finds the same people as the batched one.
+ * 
+ */
+TEST(CameraRigTests, PooledRigTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        auto params = rig_params(2);
+        CameraRig rig(params);
+        std::vector<cv::Mat> frames{cv::imread("../dataset/1/1_260.png"),
+            cv::imread("../dataset/1/1_300.png")};
+
+        HumanDetector detector(params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+        std::vector<std::array<double, 3> > batched;
+        rig.get_xyz(&detector, frames, &batched);
+
+        DetectorPool pool(params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights",
+            rig.size());
+        std::vector<std::array<double, 3> > pooled;
+        rig.get_xyz(&pool, frames, &pooled);
+
+        ASSERT_EQ(pooled.size(), batched.size());
+        for (std::size_t i = 0; i < pooled.size(); i++)
+            for (int j = 0; j < 3; j++)
+                EXPECT_NEAR(pooled[i][j], batched[i][j], 0.2);
+    }
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,177 @@
+/**
+ * @file DarknetPrunerTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Darknet Pruner Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/DarknetPruner.hpp"
+#include "../include/HumanDetector.hpp"
+
+namespace {
+
+/**
+ * @brief Unique path in the temp directory
+ * 
+ */
+std::string temp_path(const std::string& name) {
+    return (boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("%%%%-" + name)).string();
+}
+
+/**
+ * @brief Writes a two-layer model: a batch normalized 3x3 convolution and a 3-class, 2-anchor YOLO head. Every weight is its own index.
+ * 
+ * @return number of floats in the weight file
+ */
+int write_tiny_model(const std::string& cfg_path,
+        const std::string& weight_path) {
+    std::ofstream(cfg_path.c_str()) << "[net]\nwidth=32\nheight=32\n"
+        "channels=3\n\n[convolutional]\nbatch_normalize=1\nfilters=4\n"
+        "size=3\nactivation=leaky\n\n[convolutional]\nsize=1\nfilters=16\n"
+        "activation=linear\n\n[yolo]\nmask = 0,1\nanchors = 1,2, 3,4\n"
+        "classes=3\nnum=2\n";
+
+    int floats = 4*(4 + 3*3*3) + 16*(1 + 4);
+    std::ofstream weight_file(weight_path.c_str(), std::ios::binary);
+    int32_t version[] = {0, 2, 5};
+    int64_t seen = 0;
+    weight_file.write(reinterpret_cast<const char*>(version), sizeof(version));
+    weight_file.write(reinterpret_cast<const char*>(&seen), sizeof(seen));
+    for (int i = 0; i < floats; i++) {
+        float value = static_cast<float>(i);
+        weight_file.write(reinterpret_cast<const char*>(&value),
+            sizeof(value));
+    }
+    return floats;
+}
+
+std::vector<float> read_floats(const std::string& path, std::size_t skip) {
+    std::ifstream infile(path.c_str(), std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(infile)),
+        std::istreambuf_iterator<char>());
+    std::vector<float> floats((bytes.size() - skip)/sizeof(float));
+    std::memcpy(floats.data(), bytes.data() + skip,
+        floats.size()*sizeof(float));
+    return floats;
+}
+
+}  // namespace
+
+/**
+ * @brief Only the box, objectness and kept-class filters of the head are written; the other layers are copied as is.
+ * 
+ */
+TEST(DarknetPrunerTests, TinyModelTest) {
+    auto cfg_path = temp_path("tiny.cfg"), weight_path = temp_path("tiny.w");
+    auto out_cfg = temp_path("out.cfg"), out_weights = temp_path("out.w");
+    write_tiny_model(cfg_path, weight_path);
+
+    DarknetPruner pruner(cfg_path, weight_path);
+    EXPECT_EQ(pruner.get_head_count(), 1u);
+    EXPECT_THROW(pruner.prune(3, out_cfg, out_weights), std::invalid_argument);
+    auto report = pruner.prune(1, out_cfg, out_weights);
+    EXPECT_EQ(report.heads, 1u);
+    EXPECT_EQ(report.head_filters_before, 16);
+    EXPECT_EQ(report.head_filters_after, 12);
+
+    auto pruned = read_floats(out_weights, 20);
+    ASSERT_EQ(pruned.size(), 4u*(4 + 27) + 12u*(1 + 4));
+    EXPECT_EQ(report.weight_bytes_after, 20 + 4*pruned.size());
+    for (int i = 0; i < 4*(4 + 27); i++) EXPECT_EQ(pruned[i], i);
+
+    // Filters kept per anchor of 8: 0-4 and 6 (class 1).
+    std::vector<int> kept{0, 1, 2, 3, 4, 6, 8, 9, 10, 11, 12, 14};
+    const float* biases = pruned.data() + 4*(4 + 27);
+    const float* rows = biases + kept.size();
+    int head_start = 4*(4 + 27);
+    for (std::size_t i = 0; i < kept.size(); i++) {
+        EXPECT_EQ(biases[i], head_start + kept[i]);
+        for (int c = 0; c < 4; c++)
+            EXPECT_EQ(rows[4*i + c], head_start + 16 + 4*kept[i] + c);
+    }
+
+    DarknetPruner reread(out_cfg, out_weights);
+    EXPECT_EQ(reread.get_head_count(), 1u);
+    for (const auto& path : {cfg_path, weight_path, out_cfg, out_weights})
+        boost::filesystem::remove(path);
+}
+
+/**
+ * @brief Weights that do not match the cfg are rejected.
+ * 
+ */
+TEST(DarknetPrunerTests, MismatchTest) {
+    auto cfg_path = temp_path("tiny.cfg"), weight_path = temp_path("tiny.w");
+    write_tiny_model(cfg_path, weight_path);
+    boost::filesystem::resize_file(weight_path,
+        boost::filesystem::file_size(weight_path) - 4);
+    EXPECT_THROW(DarknetPruner(cfg_path, weight_path), InvalidFile);
+    EXPECT_THROW(DarknetPruner("no.cfg", weight_path), InvalidFile);
+    boost::filesystem::remove(cfg_path);
+    boost::filesystem::remove(weight_path);
+}
+
+/**
+ * @brief The person-only model finds the same people as the full model on the dataset.
+ * 
+ */
+TEST(DarknetPrunerTests, PersonOnlyMatchTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        auto out_cfg = temp_path("person.cfg");
+        auto out_weights = temp_path("person.weights");
+        auto out_names = temp_path("person.names");
+        DarknetPruner pruner("../robot_params/yolov4.cfg",
+            "../robot_params/yolov4.weights");
+        auto report = pruner.prune(0, out_cfg, out_weights);
+        EXPECT_EQ(report.head_filters_after, 54);
+        std::ofstream(out_names.c_str()) << "person\n";
+
+        ParamParser parser(all_params::params);
+        auto ret_params = parser.parse_robot_params(
+            "../robot_params/robot_params.txt");
+        HumanDetector full(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+        HumanDetector person_only(ret_params, out_names, out_cfg, out_weights);
+
+        for (int i = 231; i <= 506; i += 25) {
+            auto frame = cv::imread("../dataset/1/1_" + std::to_string(i) +
+                ".png");
+            auto expected = full.detect_frame(frame);
+            auto detected = person_only.detect_frame(frame);
+            ASSERT_EQ(detected->size(), expected->size()) << "frame " << i;
+            for (std::size_t j = 0; j < detected->size(); j++) {
+                EXPECT_LE(std::abs((*detected)[j].x - (*expected)[j].x), 1);
+                EXPECT_LE(std::abs((*detected)[j].y - (*expected)[j].y), 1);
+                EXPECT_LE(std::abs((*detected)[j].width -
+                    (*expected)[j].width), 1);
+                EXPECT_LE(std::abs((*detected)[j].height -
+                    (*expected)[j].height), 1);
+            }
+        }
+        for (const auto& path : {out_cfg, out_weights, out_names})
+            boost::filesystem::remove(path);
+    }
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file DetectionBatchTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection Batch Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <opencv2/opencv.hpp>
+
+#include "../include/Detection.hpp"
+#include "../include/DetectionBatch.hpp"
+#include "../include/DetectionMetrics.hpp"
+#include "../include/NMSEngine.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/PositionEstimator.hpp"
+
+TEST(DetectionBatchTests, RoundTripTest) {
+    std::vector<Detection> detections{{1, 2, 30, 40, .25f},
+        {-5, 7, 12, 90, .75f}, {100, 200, 0, 3, .5f}};
+    DetectionBatch batch(detections, 4);
+    batch.push_back(10.4f, 19.6f, 8.5f, 20.f, .9f, 2, 5);
+    ASSERT_EQ(batch.size(), 4u);
+    EXPECT_EQ(batch.frame_id()[0], 4);
+    EXPECT_FLOAT_EQ(batch.confidence()[2], .5f);
+    EXPECT_EQ(batch.class_id()[3], 2);
+
+    std::vector<Detection> round_trip;
+    batch.to_detections(&round_trip);
+    ASSERT_EQ(round_trip.size(), 4u);
+    for (std::size_t i = 0; i < detections.size(); i++) {
+        EXPECT_EQ(round_trip[i].x, detections[i].x);
+        EXPECT_EQ(round_trip[i].y, detections[i].y);
+        EXPECT_EQ(round_trip[i].width, detections[i].width);
+        EXPECT_EQ(round_trip[i].height, detections[i].height);
+        EXPECT_FLOAT_EQ(round_trip[i].confidence, detections[i].confidence);
+    }
+    EXPECT_EQ(round_trip[3].x, 10);
+    EXPECT_EQ(round_trip[3].y, 20);
+    EXPECT_FLOAT_EQ(round_trip[3].confidence, .9f);
+}
+
+TEST(DetectionBatchTests, AlignedArraysTest) {
+    DetectionBatch batch;
+    for (int i = 0; i < 37; i++)
+        batch.push_back(i, i, 10, 10, .5f, 0, i);
+    auto aligned = [](const void* ptr) {
+        return reinterpret_cast<std::uintptr_t>(ptr) % 64 == 0; };
+    EXPECT_TRUE(aligned(batch.x()));
+    EXPECT_TRUE(aligned(batch.y()));
+    EXPECT_TRUE(aligned(batch.width()));
+    EXPECT_TRUE(aligned(batch.height()));
+    EXPECT_TRUE(aligned(batch.confidence()));
+    EXPECT_TRUE(aligned(batch.class_id()));
+    EXPECT_TRUE(aligned(batch.frame_id()));
+
+    const float* x = batch.x();
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+    batch.push_back(1, 1, 1, 1);
+    EXPECT_EQ(batch.x(), x);
+}
+
+/**
+ * @brief A single-frame batch must keep the same boxes as the vector overload, and frames must not suppress each other.
+ * 
+ */
+TEST(DetectionBatchTests, NMSMatchesVectorTest) {
+    std::mt19937 gen(3);
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    DetectionBatch batch;
+    for (int i = 0; i < 500; i++) {
+        boxes.emplace_back(gen() % 400, gen() % 400, 20 + gen() % 80,
+            40 + gen() % 120);
+        scores.push_back((gen() % 1000)/1000.f);
+        const cv::Rect& box = boxes.back();
+        batch.push_back(box.x, box.y, box.width, box.height, scores.back());
+    }
+
+    NMSEngine nms;
+    std::vector<int> expected, indices;
+    nms.nms_boxes(boxes, scores, .2f, .4f, &expected);
+    nms.nms_boxes(batch, .2f, .4f, &indices);
+    EXPECT_EQ(indices, expected);
+
+    DetectionBatch two_frames;
+    for (std::size_t i = 0; i < boxes.size(); i++)
+        two_frames.push_back(boxes[i].x, boxes[i].y, boxes[i].width,
+            boxes[i].height, scores[i], 0, 0);
+    for (std::size_t i = 0; i < boxes.size(); i++)
+        two_frames.push_back(boxes[i].x, boxes[i].y, boxes[i].width,
+            boxes[i].height, scores[i], 0, 1);
+    nms.nms_boxes(two_frames, .2f, .4f, &indices);
+    EXPECT_EQ(indices.size(), 2*expected.size());
+}
+
+TEST(DetectionBatchTests, EstimateAllXYZMatchesVectorTest) {
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+      "../test/robot_params_textfiles/position_estimator_params_test.txt");
+    PositionEstimator testimator(ret_params);
+
+    // Even sizes, so the Detection overload's integer centers are exact.
+    std::vector<Detection> detections{{70, 60, 20, 100}, {0, 0, 40, 200},
+        {150, 20, 10, 50}};
+    std::vector<std::array<double, 3> > expected, all_xyz;
+    testimator.estimate_all_xyz(detections, &expected);
+    testimator.estimate_all_xyz(DetectionBatch(detections), &all_xyz);
+    ASSERT_EQ(all_xyz.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++)
+        for (int j = 0; j < 3; j++)
+            EXPECT_NEAR(all_xyz[i][j], expected[i][j], 1e-9);
+}
+
+TEST(DetectionBatchTests, ClosestDiffTest) {
+    std::vector<Detection> all_true{{0, 0, 10, 10}, {50, 50, 20, 40}};
+    Detection diff = get_closest_diff({52, 49, 20, 43},
+        DetectionBatch(all_true));
+    EXPECT_EQ(diff.x, 2);
+    EXPECT_EQ(diff.y, 1);
+    EXPECT_EQ(diff.width, 0);
+    EXPECT_EQ(diff.height, 3);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file DetectionTrackerTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detection Tracker Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include "../include/Detection.hpp"
+#include "../include/DetectionTracker.hpp"
+
+namespace {
+
+/**
+ * @brief Smooth random texture that optical flow can lock onto
+ * 
+ */
+cv::Mat make_texture() {
+    cv::Mat noise(40, 40, CV_8UC1);
+    cv::randu(noise, cv::Scalar(0), cv::Scalar(255));
+    cv::Mat texture;
+    cv::resize(noise, texture, cv::Size(320, 320), 0, 0, cv::INTER_LINEAR);
+    return texture;
+}
+
+}  // namespace
+
+/**
+ * @brief Boxes follow a known global shift of the frame.
+ * 
+ */
+TEST(DetectionTrackerTests, FollowsShiftTest) {
+    cv::Mat texture = make_texture();
+    DetectionTracker tracker(8, 0.5);
+    EXPECT_TRUE(tracker.needs_keyframe());
+
+    std::vector<Detection> keyframe{{60, 40, 50, 120}, {150, 100, 40, 90}};
+    tracker.reset(texture(cv::Rect(30, 30, 256, 256)).clone(), keyframe);
+    EXPECT_FALSE(tracker.needs_keyframe());
+
+    // Content moves 3 px left and 2 px down per frame.
+    std::vector<Detection> tracked;
+    for (int i = 1; i <= 3; i++) {
+        cv::Mat frame = texture(cv::Rect(30 + 3*i, 30 - 2*i, 256, 256)).clone();
+        ASSERT_TRUE(tracker.track(frame, &tracked));
+        ASSERT_EQ(tracked.size(), keyframe.size());
+        for (std::size_t k = 0; k < keyframe.size(); k++) {
+            EXPECT_NEAR(tracked[k].x, keyframe[k].x - 3*i, 1);
+            EXPECT_NEAR(tracked[k].y, keyframe[k].y + 2*i, 1);
+            EXPECT_NEAR(tracked[k].width, keyframe[k].width, 1);
+            EXPECT_NEAR(tracked[k].height, keyframe[k].height, 1);
+        }
+    }
+    EXPECT_GE(tracker.get_confidence(), 0.5);
+}
+
+/**
+ * @brief A scene cut fails tracking and asks for a keyframe right away.
+ * 
+ */
+TEST(DetectionTrackerTests, SceneCutTest) {
+    DetectionTracker tracker(8, 0.5);
+    tracker.reset(make_texture()(cv::Rect(0, 0, 256, 256)).clone(),
+        {{60, 40, 50, 120}});
+
+    std::vector<Detection> tracked;
+    EXPECT_FALSE(tracker.track(make_texture()(cv::Rect(0, 0, 256, 256))
+        .clone(), &tracked));
+    EXPECT_TRUE(tracked.empty());
+    EXPECT_TRUE(tracker.needs_keyframe());
+}
+
+/**
+ * @brief The keyframe interval grows over confident spans up to its maximum, and restarts at one after a failure.
+ * 
+ */
+TEST(DetectionTrackerTests, AdaptiveIntervalTest) {
+    cv::Mat frame = make_texture()(cv::Rect(0, 0, 256, 256)).clone();
+    std::vector<Detection> keyframe{{60, 40, 50, 120}};
+    DetectionTracker tracker(3, 0.5);
+
+    std::vector<Detection> tracked;
+    std::vector<int> intervals;
+    for (int i = 0; i < 20; i++) {
+        if (tracker.needs_keyframe()) {
+            tracker.reset(frame, keyframe);
+            intervals.push_back(tracker.get_interval());
+        } else {
+            ASSERT_TRUE(tracker.track(frame, &tracked));
+        }
+    }
+    ASSERT_GE(intervals.size(), 4u);
+    EXPECT_EQ(intervals[0], 1);
+    EXPECT_EQ(intervals[1], 2);
+    EXPECT_EQ(intervals[2], 3);
+    EXPECT_EQ(intervals.back(), 3);
+
+    tracker.track(make_texture()(cv::Rect(0, 0, 256, 256)).clone(), &tracked);
+    tracker.reset(frame, keyframe);
+    EXPECT_EQ(tracker.get_interval(), 1);
+}
+
+TEST(DetectionTrackerTests, InvalidParamsTest) {
+    EXPECT_THROW(DetectionTracker(0, 0.5), std::invalid_argument);
+    EXPECT_THROW(DetectionTracker(4, 1.5), std::invalid_argument);
+}
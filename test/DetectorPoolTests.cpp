@@ -0,0 +1,126 @@
+/**
+ * @file DetectorPoolTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Detector Pool Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/params_vec.hpp"
+#include "../include/LeasePool.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/DetectorPool.hpp"
+
+/**
+ * @brief Many threads hammering a small pool never share an object and every lease is returned.
+ * 
+ */
+TEST(DetectorPoolTests, LeaseExclusivityTest) {
+    const std::size_t pool_size = 3;
+    std::vector<std::unique_ptr<std::atomic<int> > > items;
+    for (std::size_t i = 0; i < pool_size; i++)
+        items.emplace_back(new std::atomic<int>(0));
+    LeasePool<std::atomic<int> > pool(std::move(items));
+
+    std::atomic<bool> shared{false};
+    std::atomic<int> max_in_use{0};
+    std::atomic<int> in_use{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 2000; i++) {
+                auto lease = pool.acquire();
+                if (lease->fetch_add(1) != 0) shared = true;
+                int now = ++in_use;
+                int prev = max_in_use.load();
+                while (now > prev && !max_in_use.compare_exchange_weak(prev,
+                    now)) {}
+                std::this_thread::yield();
+                --in_use;
+                if (lease->fetch_sub(1) != 1) shared = true;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_FALSE(shared);
+    EXPECT_LE(max_in_use.load(), static_cast<int>(pool_size));
+    EXPECT_EQ(pool.available(), pool_size);
+}
+
+/**
+ * @brief try_acquire fails once the pool is drained, and moved or released leases return their object exactly once.
+ * 
+ */
+TEST(DetectorPoolTests, TryAcquireTest) {
+    std::vector<std::unique_ptr<int> > items;
+    items.emplace_back(new int(1));
+    items.emplace_back(new int(2));
+    LeasePool<int> pool(std::move(items));
+
+    auto first = pool.try_acquire();
+    auto second = pool.try_acquire();
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_NE(*first, *second);
+    EXPECT_FALSE(pool.try_acquire());
+
+    auto moved = std::move(first);
+    EXPECT_FALSE(first);
+    EXPECT_EQ(pool.available(), 0u);
+    moved.release();
+    EXPECT_EQ(pool.available(), 1u);
+    second = LeasePool<int>::Lease();
+    EXPECT_EQ(pool.available(), 2u);
+}
+
+/**
+ * @brief Concurrent detections through the pool match a single detector run on the same frame.
+ * 
+ */
+TEST(DetectorPoolTests, ConcurrentDetectTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        ParamParser parser(all_params::params);
+        auto ret_params = parser.parse_robot_params(
+            "../robot_params/robot_params.txt");
+        DetectorPool pool(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights",
+            2);
+        EXPECT_EQ(pool.size(), 2u);
+
+        cv::Mat img = cv::imread("../dataset/1/1_260.png");
+        std::size_t expected;
+        {
+            auto lease = pool.acquire();
+            expected = lease->detect_frame(img)->size();
+        }
+
+        std::atomic<int> mismatches{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < 2; i++) {
+                    auto lease = pool.acquire();
+                    if (lease->detect_frame(img)->size() != expected)
+                        ++mismatches;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        EXPECT_EQ(mismatches.load(), 0);
+    }
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file FramePreprocessorTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame Preprocessor Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "../include/FramePreprocessor.hpp"
+
+/**
+ * @brief The fused kernel must agree with resize + blobFromImage up to the 8-bit rounding of cv::resize.
+ * 
+ */
+TEST(FramePreprocessorTests, MatchesBlobFromImageTest) {
+    cv::Mat img = cv::imread("../dataset/1/1_269.png");
+    ASSERT_FALSE(img.empty());
+    const int width = 416;
+    const int height = 416;
+
+    cv::Mat prepped, blob;
+    cv::resize(img, prepped, cv::Size(width, height), cv::INTER_LINEAR);
+    cv::dnn::blobFromImage(prepped, blob, 1/255.0, cv::Size(width, height),
+        cv::Scalar(0, 0, 0), true, false);
+
+    FramePreprocessor preprocessor(width, height);
+    std::vector<float> tensor(3*width*height);
+    preprocessor.run(img.data, img.cols, img.rows, img.step, tensor.data());
+
+    const float* expected = blob.ptr<float>();
+    float max_diff = 0;
+    for (std::size_t i = 0; i < tensor.size(); i++)
+        max_diff = std::max(max_diff, std::fabs(tensor[i] - expected[i]));
+    EXPECT_LT(max_diff, 1.5f/255.f);
+}
+
+TEST(FramePreprocessorTests, LetterboxTest) {
+    const int src_w = 640;
+    const int src_h = 480;
+    cv::Mat img(src_h, src_w, CV_8UC3, cv::Scalar(255, 255, 255));
+
+    FramePreprocessor preprocessor(416, 416, true);
+    std::vector<float> tensor(3*416*416, -1.f);
+    preprocessor.run(img.data, img.cols, img.rows, img.step, tensor.data());
+
+    // 640x480 is scaled to 416x312, leaving 52 padded rows above and below.
+    EXPECT_FLOAT_EQ(tensor[0], 0.5f);
+    EXPECT_FLOAT_EQ(tensor[51*416], 0.5f);
+    EXPECT_FLOAT_EQ(tensor[52*416], 1.f);
+    EXPECT_FLOAT_EQ(tensor[363*416], 1.f);
+    EXPECT_FLOAT_EQ(tensor[364*416], 0.5f);
+
+    const Letterbox& letterbox = preprocessor.get_letterbox();
+    EXPECT_NEAR(letterbox.offset[0], 0, 1e-6);
+    EXPECT_NEAR(letterbox.offset[1], 52/416.0, 1e-6);
+    EXPECT_NEAR(letterbox.gain[1], 416/312.0, 1e-6);
+}
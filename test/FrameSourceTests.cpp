@@ -0,0 +1,155 @@
+/**
+ * @file FrameSourceTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Frame Source Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/FrameSource.hpp"
+
+namespace {
+
+/**
+ * @brief Decoder of count 4x4 frames, each filled with its index
+ * 
+ */
+FrameSource::Decoder counting_decoder(int count) {
+    auto next = std::make_shared<int>(0);
+    return [next, count](cv::Mat* image, double* timestamp) {
+        if (*next == count) return false;
+        image->create(4, 4, CV_8UC1);
+        image->setTo(cv::Scalar(*next));
+        *timestamp = *next*0.1;
+        ++*next;
+        return true;
+    };
+}
+
+}  // namespace
+
+/**
+ * @brief Images come out in natural file name order, match cv::imread, and are timestamped from the frame rate.
+ * 
+ */
+TEST(FrameSourceTests, DirectoryTest) {
+    auto source = FrameSource::directory("../dataset/0", 10, 3);
+    cv::Mat frame;
+    double timestamp = -1;
+    std::size_t count = 0;
+    while (source->read(&frame, &timestamp)) {
+        if (count == 2 || count == 10) {
+            cv::Mat expected = cv::imread("../dataset/0/0_" +
+                std::to_string(count) + ".png");
+            ASSERT_EQ(frame.size(), expected.size());
+            EXPECT_EQ(cv::norm(frame, expected, cv::NORM_L1), 0);
+        }
+        EXPECT_DOUBLE_EQ(timestamp, count/10.0);
+        count++;
+    }
+    // 231 numbered frames, then the 5 other images
+    EXPECT_EQ(count, 236u);
+    EXPECT_FALSE(source->read(&frame, &timestamp));
+
+    auto stats = source->get_stats();
+    EXPECT_EQ(stats.decoded, count);
+    EXPECT_EQ(stats.delivered, count);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_GT(stats.decode_fps, 0);
+
+    EXPECT_THROW(FrameSource::directory("../dataset/none", 10), InvalidFile);
+    EXPECT_THROW(FrameSource::directory("../dataset/0", 0),
+        std::invalid_argument);
+}
+
+/**
+ * @brief A file source delivers every frame in order, decoding into the same few buffers.
+ * 
+ */
+TEST(FrameSourceTests, RingReuseTest) {
+    FrameSource source(counting_decoder(100), false, 3);
+    cv::Mat frame;
+    double timestamp;
+    std::set<const uchar*> buffers;
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(source.read(&frame, &timestamp));
+        EXPECT_EQ(frame.at<uchar>(3, 3), i);
+        EXPECT_DOUBLE_EQ(timestamp, i*0.1);
+        buffers.insert(frame.data);
+        if (i % 10 == 0) std::this_thread::yield();
+    }
+    EXPECT_FALSE(source.read(&frame, &timestamp));
+    // The ring, the decoder's spare and the caller's buffer
+    EXPECT_LE(buffers.size(), 5u);
+    EXPECT_EQ(source.get_stats().dropped, 0u);
+}
+
+/**
+ * @brief A live source that is not read keeps only its newest frames, stamped when they were decoded rather than read.
+ * 
+ */
+TEST(FrameSourceTests, LiveDropTest) {
+    auto start = std::chrono::steady_clock::now();
+    FrameSource source(counting_decoder(50), true, 2);
+    while (source.get_stats().decoded < 50) std::this_thread::yield();
+    auto decoded = std::chrono::steady_clock::now();
+
+    cv::Mat frame;
+    double timestamp;
+    std::chrono::steady_clock::time_point first, second;
+    ASSERT_TRUE(source.read(&frame, &timestamp, &first));
+    EXPECT_EQ(frame.at<uchar>(0, 0), 48);
+    ASSERT_TRUE(source.read(&frame, &timestamp, &second));
+    EXPECT_EQ(frame.at<uchar>(0, 0), 49);
+    EXPECT_LE(start, first);
+    EXPECT_LE(first, second);
+    EXPECT_LE(second, decoded);
+    EXPECT_FALSE(source.read(&frame, &timestamp));
+
+    auto stats = source.get_stats();
+    EXPECT_EQ(stats.delivered, 2u);
+    EXPECT_EQ(stats.dropped, 48u);
+}
+
+/**
+ * @brief Decoder errors are raised by read() after the frames before them, and close() stops decoding.
+ * 
+ */
+TEST(FrameSourceTests, ErrorAndCloseTest) {
+    auto decode = counting_decoder(2);
+    FrameSource failing([decode](cv::Mat* image, double* timestamp) {
+        if (!decode(image, timestamp))
+            throw std::runtime_error("decode failed");
+        return true;
+    }, false);
+    cv::Mat frame;
+    double timestamp;
+    EXPECT_TRUE(failing.read(&frame, &timestamp));
+    EXPECT_TRUE(failing.read(&frame, &timestamp));
+    EXPECT_THROW(failing.read(&frame, &timestamp), std::runtime_error);
+
+    FrameSource endless([](cv::Mat* image, double* timestamp) {
+        *image = cv::Mat(4, 4, CV_8UC1, cv::Scalar(0));
+        *timestamp = 0;
+        return true;
+    }, false, 2);
+    EXPECT_TRUE(endless.read(&frame, &timestamp));
+    endless.close();
+    int remaining = 0;
+    while (endless.read(&frame, &timestamp)) remaining++;
+    EXPECT_LE(remaining, 2);
+}
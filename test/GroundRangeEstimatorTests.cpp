@@ -0,0 +1,129 @@
+/**
+ * @file GroundRangeEstimatorTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Ground Range Estimator Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "../include/Detection.hpp"
+#include "../include/DetectionBatch.hpp"
+#include "../include/PositionEstimator.hpp"
+#include "../include/GroundRangeEstimator.hpp"
+
+namespace {
+
+const double PI = std::atan(1.0)*4;
+// 416x416 frame, f*density = 400 px, camera 1.2 m above the floor
+const double focal_px = 400;
+const double cam_height = 1.2;
+
+/**
+ * @brief Box of a person of a given height standing on the floor at a given depth
+ * 
+ */
+Detection standing(double depth, double person_height, double u = 208) {
+    double bottom = 208 + focal_px*cam_height/depth;
+    double top = 208 + focal_px*(cam_height - person_height)/depth;
+    double width = 0.3*(bottom - top);
+    return Detection(static_cast<int>(std::round(u - width/2)),
+        static_cast<int>(std::round(top)), static_cast<int>(std::round(width)),
+        static_cast<int>(std::round(bottom - top)));
+}
+
+}  // namespace
+
+TEST(GroundRangeEstimatorTests, FloorRangeTest) {
+    PositionEstimator estimator(0, 0, 0, 90*PI/180.0, 0.004, 100000,
+        416, 416, 1.77);
+    GroundRangeEstimator ground(estimator.get_cam2robot_transform(),
+        focal_px, 208, 416, cam_height, 0.1, 2);
+
+    for (double depth : {2.5, 3.5, 6.0, 10.0}) {
+        float foot = static_cast<float>(208 + focal_px*cam_height/depth);
+        EXPECT_NEAR(ground.range(foot), depth, 1e-3*depth*depth);
+    }
+    EXPECT_EQ(ground.range(100), 0.f);
+    EXPECT_EQ(ground.range(208), 0.f);
+    EXPECT_NEAR(ground.inverse_range_from_ray(0.3), 0.3/cam_height, 1e-9);
+    EXPECT_EQ(ground.inverse_range_from_ray(-0.1), 0);
+}
+
+/**
+ * @brief A child is placed too far by box height alone; fusing in the ground range corrects most of it.
+ * 
+ */
+TEST(GroundRangeEstimatorTests, FusedChildTest) {
+    PositionEstimator estimator(0.1, 0, 0, 90*PI/180.0, 0.004, 100000,
+        416, 416, 1.77);
+    const double depth = 3;
+    Detection child = standing(depth, 1.1);
+    double height_z = estimator.approximate_camera_z(child);
+    EXPECT_GT(height_z, depth*1.5);
+
+    estimator.set_ground_range(std::make_shared<const GroundRangeEstimator>(
+        estimator.get_cam2robot_transform(), focal_px, 208, 416, cam_height,
+        0.1, 2));
+    double fused_z = estimator.approximate_camera_z(child);
+    EXPECT_NEAR(fused_z, depth, 0.1);
+
+    std::vector<Detection> detections{child, standing(5, 1.77, 120),
+        standing(2.5, 1.5, 300)};
+    std::vector<std::array<double, 3> > all_xyz;
+    estimator.estimate_all_xyz(DetectionBatch(detections), &all_xyz);
+    for (std::size_t i = 0; i < detections.size(); i++) {
+        auto single = estimator.estimate_xyz(detections[i]);
+        for (int j = 0; j < 3; j++)
+            EXPECT_NEAR(all_xyz[i][j], single[j], 0.02);
+    }
+    // Robot x is camera depth plus the camera offset
+    EXPECT_NEAR(all_xyz[0][0], depth + 0.1, 0.1);
+}
+
+TEST(GroundRangeEstimatorTests, CutBoxesTest) {
+    PositionEstimator estimator(0, 0, 0, 90*PI/180.0, 0.004, 100000,
+        416, 416, 1.77);
+    GroundRangeEstimator ground(estimator.get_cam2robot_transform(),
+        focal_px, 208, 416, cam_height, 0.1, 2);
+
+    // Feet below the frame: only the height estimate is usable
+    EXPECT_DOUBLE_EQ(ground.fuse_inverse(1/4., 1/3., 100, 416), 1/4.);
+    // Head above the frame: only the ground estimate is usable
+    EXPECT_DOUBLE_EQ(ground.fuse_inverse(1/4., 1/3., 0, 380), 1/3.);
+    // Feet above the horizon
+    EXPECT_DOUBLE_EQ(ground.fuse_inverse(1/4., 0, 100, 200), 1/4.);
+    // Close by, the ground estimate is far more precise than the height one
+    double fused_z = 1/ground.fuse_inverse(1/2.4, 1/2., 20, 400);
+    EXPECT_GT(fused_z, 2);
+    EXPECT_LT(fused_z, 2.05);
+
+    // Whole and cut boxes, more than one vector's worth plus a tail
+    std::vector<float> top, height;
+    for (int i = 0; i < 37; i++) {
+        top.push_back(static_cast<float>((i*53) % 300) - 20);
+        height.push_back(static_cast<float>(40 + (i*29) % 200));
+    }
+    const float scale = static_cast<float>(1.77*focal_px);
+    std::vector<float> fused_top(top.size()), fused_height(top.size());
+    ground.fuse_heights(top.data(), height.data(), top.size(), scale,
+        fused_top.data(), fused_height.data());
+    for (std::size_t i = 0; i < top.size(); i++) {
+        float bottom = top[i] + height[i];
+        double expected = scale*ground.fuse_inverse(height[i]/scale,
+            ground.inverse_range(bottom), top[i], bottom);
+        EXPECT_NEAR(fused_height[i], expected, 1e-3*expected);
+        EXPECT_NEAR(fused_top[i] + fused_height[i]/2, top[i] + height[i]/2,
+            1e-3*expected);
+    }
+}
@@ -25,6 +25,7 @@
 #include "../include/LabelParser.hpp"
 #include "../include/ParamParser.hpp"
 #include "../include/HumanDetector.hpp"
+#include "../include/DetectionMetrics.hpp"
 
 const auto coco_name_path = "../robot_params/coco.names";
 const auto yolo_cfg_path = "../robot_params/yolov4.cfg";
@@ -68,21 +69,6 @@ TEST(HumanDetectorTests, CorrectFrameSizeTest) {
     ASSERT_EQ(height, prep_frame_height);
 }
 
-Detection getClosestDiff(const Detection& detection,
-        const std::vector<Detection>& all_true) {
-    int min_sum = 5000;
-    Detection closest_diff{};
-    for (const auto& single_true : all_true) {
-        Detection diff = detection - single_true;
-        int sum = diff.x + diff.y + diff.width + diff.height;
-        if (sum < min_sum) {
-            min_sum = sum;
-            closest_diff = diff;
-        }
-    }
-    return closest_diff;
-}
-
 /**
  * @brief This test specifically looks through images that have >= 1 detection.
  * 
@@ -96,51 +82,18 @@ TEST(HumanDetectorTests, HumanDetectionAccuracyTest) {
         HumanDetector detector(ret_params, coco_name_path,
             yolo_cfg_path, yolo_weights_path);
 
-        int num_imgs = 0;
-        int num_true_detections = 0;
-        int num_detected_detections = 0;
-        Detection sum_detect_diff{};
-
         LabelParser label_parser;
-        auto labels = label_parser.read_labeled_test_images(
-            "../dataset/labels");
-        for (const auto& label : labels) {
-            if (num_imgs > 50) break;
-            const std::vector<Detection>&
-                true_detections = label->all_detections;
-            cv::Mat& img = label->img;
-            auto prep_img = detector.prep_frame(img);
-            auto output_detections = detector.detect(*prep_img);
-
-            num_true_detections += true_detections.size();
-            num_detected_detections += output_detections->size();
-
-            for (const auto& output_detection : *output_detections) {
-                sum_detect_diff += getClosestDiff(
-                    output_detection, true_detections);
-            }
-            num_imgs++;
-        }
+        auto report = evaluate_accuracy(&detector,
+            label_parser.read_labeled_test_images("../dataset/labels"));
 
-        double percent_detections = num_detected_detections/
-            static_cast<double>(num_true_detections);
-        double average_x_diff = sum_detect_diff.x/
-            static_cast<double>(num_true_detections);
-        double average_y_diff = sum_detect_diff.y/
-            static_cast<double>(num_true_detections);
-        double average_width_diff = sum_detect_diff.width/
-            static_cast<double>(num_true_detections);
-        double average_height_diff = sum_detect_diff.height/
-            static_cast<double>(num_true_detections);
-
-        std::cout << "Percent detected: " << 100*percent_detections
+        std::cout << "Percent detected: " << 100*report.percent_detected
             << " %" << std::endl;
 
-        EXPECT_GE(percent_detections, 0.80);
-        EXPECT_LT(average_x_diff, 10);
-        EXPECT_LT(average_y_diff, 10);
-        EXPECT_LT(average_width_diff, 10);
-        EXPECT_LT(average_height_diff, 10);
+        EXPECT_GE(report.percent_detected, 0.80);
+        EXPECT_LT(report.average_x_diff, 10);
+        EXPECT_LT(report.average_y_diff, 10);
+        EXPECT_LT(report.average_width_diff, 10);
+        EXPECT_LT(report.average_height_diff, 10);
     }
     EXPECT_TRUE(true);
 }
@@ -0,0 +1,82 @@
+/**
+ * @file InferenceEngineTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Inference Engine Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/DnnEngine.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/InferenceEngine.hpp"
+
+TEST(InferenceEngineTests, MissingModelTest) {
+    std::unordered_map<std::string, double> ret_params{};
+    EXPECT_THROW(InferenceEngine::create(ret_params,
+        "../robot_params/yolov4.cfg", "../robot_params/missing.weights"),
+        InvalidFile);
+    EXPECT_THROW(InferenceEngine::create(ret_params, "",
+        "../robot_params/missing.onnx"), InvalidFile);
+}
+
+TEST(InferenceEngineTests, BackendParamsTest) {
+    std::unordered_map<std::string, double> ret_params{};
+    EXPECT_EQ(DnnEngine::get_backend(ret_params),
+        cv::dnn::DNN_BACKEND_DEFAULT);
+    EXPECT_EQ(DnnEngine::get_target(ret_params), cv::dnn::DNN_TARGET_CPU);
+
+    ret_params["DNN_BACKEND"] = cv::dnn::DNN_BACKEND_OPENCV;
+    ret_params["DNN_TARGET"] = cv::dnn::DNN_TARGET_OPENCL;
+    EXPECT_EQ(DnnEngine::get_backend(ret_params), cv::dnn::DNN_BACKEND_OPENCV);
+    EXPECT_EQ(DnnEngine::get_target(ret_params), cv::dnn::DNN_TARGET_OPENCL);
+}
+
+/**
+ * @brief The default backend and an explicit OpenCV CPU backend give the same detections, and unknown backends are rejected.
+ * 
+ */
+TEST(InferenceEngineTests, DarknetBackendTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        ParamParser parser(all_params::params);
+        auto ret_params = parser.parse_robot_params(
+            "../robot_params/robot_params.txt");
+        DarknetModel model("../robot_params/yolov4.cfg",
+            "../robot_params/yolov4.weights");
+        cv::Mat img = cv::imread("../dataset/1/1_260.png");
+
+        HumanDetector default_detector(ret_params, "../robot_params/coco.names",
+            std::unique_ptr<InferenceEngine>(new DarknetEngine(model)));
+        HumanDetector opencv_detector(ret_params, "../robot_params/coco.names",
+            std::unique_ptr<InferenceEngine>(new DarknetEngine(model,
+                cv::dnn::DNN_BACKEND_OPENCV, cv::dnn::DNN_TARGET_CPU)));
+
+        auto expected = default_detector.detect_frame(img);
+        auto actual = opencv_detector.detect_frame(img);
+        ASSERT_EQ(actual->size(), expected->size());
+        for (std::size_t i = 0; i < expected->size(); i++) {
+            EXPECT_NEAR((*actual)[i].x, (*expected)[i].x, 1);
+            EXPECT_NEAR((*actual)[i].y, (*expected)[i].y, 1);
+        }
+
+        EXPECT_THROW(DarknetEngine(model, -1, cv::dnn::DNN_TARGET_CPU),
+            std::invalid_argument);
+    }
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,86 @@
+/**
+ * @file Int8EngineTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief INT8 Engine Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/params_vec.hpp"
+#include "../include/Int8Engine.hpp"
+#include "../include/LabelParser.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/WeightStore.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/DetectionMetrics.hpp"
+
+TEST(Int8EngineTests, EmptyCalibrationTest) {
+    EXPECT_THROW(Int8Engine(cv::dnn::Net(), std::vector<cv::Mat>()),
+        std::invalid_argument);
+}
+
+TEST(Int8EngineTests, CalibrationBlobsTest) {
+    std::unordered_map<std::string, double> ret_params{};
+    ret_params["IMG_WIDTH_REQ"] = 96;
+    ret_params["IMG_HEIGHT_REQ"] = 64;
+    ret_params["INT8_CALIBRATION_FRAMES"] = 4;
+
+    auto blobs = Int8Engine::read_calibration_blobs(ret_params);
+    ASSERT_EQ(blobs.size(), 4u);
+    for (const auto& blob : blobs) {
+        ASSERT_EQ(blob.dims, 4);
+        EXPECT_EQ(blob.size[1], 3);
+        EXPECT_EQ(blob.size[2], 64);
+        EXPECT_EQ(blob.size[3], 96);
+    }
+
+    // The dataset is read once, and only the frame count and size matter
+    auto cached = Int8Engine::read_calibration_blobs(ret_params);
+    ASSERT_EQ(cached.size(), blobs.size());
+    EXPECT_EQ(cached.front().data, blobs.front().data);
+    ret_params["INT8_CALIBRATION_FRAMES"] = 2;
+    EXPECT_EQ(Int8Engine::read_calibration_blobs(ret_params).size(), 2u);
+}
+
+/**
+ * @brief The calibrated INT8 detector meets the same accuracy bounds as HumanDetectionAccuracyTest.
+ * 
+ */
+TEST(Int8EngineTests, Int8AccuracyTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        ParamParser parser(all_params::params);
+        auto ret_params = parser.parse_robot_params(
+            "../robot_params/robot_params.txt");
+        ret_params["INT8_INFERENCE"] = 1;
+        HumanDetector detector(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+
+        LabelParser label_parser;
+        auto report = evaluate_accuracy(&detector,
+            label_parser.read_labeled_test_images("../dataset/labels"));
+        std::cout << "INT8 percent detected: " << 100*report.percent_detected
+            << " %" << std::endl;
+
+        EXPECT_GE(report.percent_detected, 0.80);
+        EXPECT_LT(report.average_x_diff, 10);
+        EXPECT_LT(report.average_y_diff, 10);
+        EXPECT_LT(report.average_width_diff, 10);
+        EXPECT_LT(report.average_height_diff, 10);
+    }
+    EXPECT_TRUE(true);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file MotionGateTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Motion Gate Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+
+#include "../include/MotionGate.hpp"
+
+/**
+ * @brief A static scene is skipped, with inference forced every max_skipped + 1 frames.
+ * 
+ */
+TEST(MotionGateTests, StaticSceneTest) {
+    MotionGate gate(0.05, 0.01, 15);
+    cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(40, 90, 160));
+
+    int inferred = 0;
+    for (int i = 0; i < 48; i++) {
+        bool infer = gate.should_infer(frame);
+        EXPECT_EQ(infer, i % 16 == 0);
+        if (infer) {
+            inferred++;
+            gate.record_inference_ms(100);
+        }
+    }
+    EXPECT_EQ(inferred, 3);
+
+    auto stats = gate.get_stats();
+    EXPECT_EQ(stats.frames, 48u);
+    EXPECT_EQ(stats.skipped, 45u);
+    EXPECT_DOUBLE_EQ(stats.skip_ratio, 45/48.0);
+    EXPECT_NEAR(stats.saved_ms, 4500 - stats.gate_ms, 1e-9);
+}
+
+/**
+ * @brief A person-sized change is inferred right away; sensor noise below the pixel threshold is not.
+ * 
+ */
+TEST(MotionGateTests, ChangeTest) {
+    MotionGate gate(0.05, 0.01, 100);
+    cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(100, 100, 100));
+    EXPECT_TRUE(gate.should_infer(frame));
+
+    cv::Mat noisy = frame.clone();
+    cv::Mat noise(240, 320, CV_8UC3);
+    cv::randu(noise, cv::Scalar(0, 0, 0), cv::Scalar(8, 8, 8));
+    noisy += noise;
+    EXPECT_FALSE(gate.should_infer(noisy));
+
+    cv::Mat person = frame.clone();
+    person(cv::Rect(150, 60, 30, 100)).setTo(cv::Scalar(20, 30, 200));
+    EXPECT_TRUE(gate.should_infer(person));
+    EXPECT_FALSE(gate.should_infer(person));
+}
+
+/**
+ * @brief Slow changes are compared with the last inferred frame, so they add up until they trigger inference.
+ * 
+ */
+TEST(MotionGateTests, SlowDriftTest) {
+    MotionGate gate(0.05, 0.01, 100);
+    int first_inferred = -1;
+    for (int i = 0; i < 30; i++) {
+        cv::Mat frame(120, 160, CV_8UC1, cv::Scalar(100 + i));
+        bool infer = gate.should_infer(frame);
+        if (i > 0 && infer && first_inferred < 0) first_inferred = i;
+    }
+    // 5 % of full scale is 12 gray levels.
+    EXPECT_EQ(first_inferred, 13);
+}
+
+TEST(MotionGateTests, InvalidParamsTest) {
+    EXPECT_THROW(MotionGate(1.5, 0.01, 15), std::invalid_argument);
+    EXPECT_THROW(MotionGate(0.05, -0.1, 15), std::invalid_argument);
+    EXPECT_THROW(MotionGate(0.05, 0.01, -1), std::invalid_argument);
+}
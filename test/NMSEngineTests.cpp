@@ -0,0 +1,89 @@
+/**
+ * @file NMSEngineTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief NMS Engine Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "../include/NMSEngine.hpp"
+
+/**
+ * @brief Random crowded scenes, with tied scores and some degenerate boxes, must match cv::dnn::NMSBoxes exactly.
+ * 
+ */
+TEST(NMSEngineTests, MatchesNMSBoxesTest) {
+    std::mt19937 gen(7);
+    NMSEngine nms;
+    for (int trial = 0; trial < 100; trial++) {
+        int num_boxes = 1 + gen() % 2000;
+        int extent = 100 + gen() % 2000;
+        std::vector<cv::Rect> boxes;
+        std::vector<float> scores;
+        for (int i = 0; i < num_boxes; i++) {
+            int w = gen() % 10 == 0 ? static_cast<int>(gen() % 5) - 2 :
+                1 + gen() % 120;
+            int h = gen() % 10 == 0 ? static_cast<int>(gen() % 5) - 2 :
+                1 + gen() % 200;
+            boxes.emplace_back(static_cast<int>(gen() % extent) - 50,
+                static_cast<int>(gen() % extent) - 50, w, h);
+            scores.push_back((gen() % 20)/20.f);
+        }
+        float nms_threshold = (gen() % 10)/10.f;
+        float score_threshold = (gen() % 5)/10.f;
+
+        std::vector<int> expected, result;
+        cv::dnn::NMSBoxes(boxes, scores, score_threshold, nms_threshold,
+            expected);
+        nms.nms_boxes(boxes, scores, score_threshold, nms_threshold, &result);
+        ASSERT_EQ(result, expected) << "trial " << trial;
+    }
+}
+
+TEST(NMSEngineTests, InvalidInputTest) {
+    NMSEngine nms;
+    std::vector<int> indices;
+    EXPECT_ANY_THROW(nms.nms_boxes({cv::Rect(0, 0, 1, 1)}, {}, 0.f, 0.5f,
+        &indices));
+    EXPECT_ANY_THROW(nms.nms_boxes({}, {}, 0.f, -0.5f, &indices));
+}
+
+TEST(NMSEngineTests, SoftNMSTest) {
+    std::vector<cv::Rect> boxes{cv::Rect(0, 0, 100, 100),
+        cv::Rect(0, 50, 100, 100), cv::Rect(500, 500, 10, 10)};
+    std::vector<float> scores{0.9f, 0.8f, 0.7f};
+
+    NMSEngine nms;
+    std::vector<int> indices;
+    std::vector<float> updated;
+    nms.soft_nms_boxes(boxes, scores, 0.1f, 0.3f, 0.5f, NMSEngine::GAUSSIAN,
+        &indices, &updated);
+
+    // The overlapping box (IoU 1/3) is decayed rather than suppressed, and
+    // drops below the untouched third box.
+    ASSERT_EQ(indices, std::vector<int>({0, 2, 1}));
+    EXPECT_FLOAT_EQ(updated[0], 0.9f);
+    EXPECT_FLOAT_EQ(updated[1], 0.7f);
+    EXPECT_NEAR(updated[2], 0.8*std::exp(-1/9.0/0.5), 1e-5);
+
+    nms.soft_nms_boxes(boxes, scores, 0.1f, 0.3f, 0.5f, NMSEngine::LINEAR,
+        &indices, &updated);
+    ASSERT_EQ(indices, std::vector<int>({0, 2, 1}));
+    EXPECT_NEAR(updated[2], 0.8*(1 - 1/3.0), 1e-5);
+
+    // Decaying below the score threshold drops the box.
+    nms.soft_nms_boxes(boxes, scores, 0.6f, 0.3f, 0.5f, NMSEngine::LINEAR,
+        &indices, &updated);
+    EXPECT_EQ(indices, std::vector<int>({0, 2}));
+}
@@ -67,13 +67,15 @@ TEST(ParamParserTest, UnitTest) {
 TEST(ParamParserTest, UnitNotAllowedTest) {
     typedef std::vector<Var> vec;
     vec params{{"a", "m"}, {"b", "rad"}, {"c", "frac"},
-        {"d", "px"}, {"e", "ppm"}};
+        {"d", "px"}, {"e", "ppm"}, {"f", "ms"}, {"g", "s"}, {"h", "bool"},
+        {"i", "frames"}};
     ParamParser parser(params);
 
     std::ofstream ofs;
     std::string path = "../test/robot_params_textfiles/UnitNotAllowed.txt";
     std::vector<std::string> vector{"a = 1 [px]", "b = 1 [e]",
-        "c = 1 [m]", "d = 1 [ppm]", "e = 1 [%]"};
+        "c = 1 [m]", "d = 1 [ppm]", "e = 1 [%]", "f = 1 [m]", "g = 1 [min]",
+        "h = 1 [frames]", "i = 1 [s]"};
     for (const auto& str : vector) {
         ofs.open(path, std::ofstream::out | std::ofstream::trunc);
         ofs << str << std::endl;
@@ -83,6 +85,30 @@ TEST(ParamParserTest, UnitNotAllowedTest) {
     }
 }
 
+TEST(ParamParserTest, TimeUnitTest) {
+    typedef std::vector<Var> vec;
+    vec params{{"a", "ms"}, {"b", "s"}, {"c", "bool"}};
+    ParamParser parser(params);
+
+    std::ofstream ofs;
+    std::string path = "../test/robot_params_textfiles/TimeUnit.txt";
+    ofs.open(path, std::ofstream::out | std::ofstream::trunc);
+    ofs << "a = 0.1 [s]\nb = 250 [ms]\nc = 1 [bool]" << std::endl;
+    ofs.close();
+    auto result = parser.parse_robot_params(path);
+    EXPECT_NEAR(result.at("a"), 100, 1e-9);
+    EXPECT_NEAR(result.at("b"), .25, 1e-9);
+    EXPECT_EQ(result.at("c"), 1);
+
+    ofs.open(path, std::ofstream::out | std::ofstream::trunc);
+    ofs << "a = 40 [ms]\nb = 2 [s]\nc = 0" << std::endl;
+    ofs.close();
+    result = parser.parse_robot_params(path);
+    EXPECT_EQ(result.at("a"), 40);
+    EXPECT_EQ(result.at("b"), 2);
+    EXPECT_EQ(result.at("c"), 0);
+}
+
 TEST(ParamParserTest, VariousInputsTest) {
     typedef std::vector<Var> vec;
     vec params{{"a", "m"}};
@@ -0,0 +1,166 @@
+/**
+ * @file PersonTrackerTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Person Tracker Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+#include "../include/PersonTracker.hpp"
+
+namespace {
+
+const double frame_dt = 0.1;
+
+/**
+ * @brief Id of the confirmed track closest to a position
+ * 
+ */
+std::uint64_t closest_id(const std::vector<PersonTrack>& confirmed,
+        const std::array<double, 3>& xyz) {
+    std::uint64_t id = 0;
+    double best = 1e9;
+    for (const auto& track : confirmed) {
+        double d = std::hypot(track.xyz[0] - xyz[0], track.xyz[2] - xyz[2]);
+        if (d < best) {
+            best = d;
+            id = track.id;
+        }
+    }
+    return id;
+}
+
+}  // namespace
+
+TEST(PersonTrackerTests, ConfirmTest) {
+    PersonTracker tracker(2, 0.1, 1.5, 3, 2);
+    std::vector<PersonTrack> confirmed;
+    // Walking forward at 1 m/s, 1 m to the left
+    for (int f = 0; f < 30; f++) {
+        tracker.update({{{2 + f*frame_dt, 0.9, 1}}}, f*frame_dt, &confirmed);
+        if (f < 2) EXPECT_TRUE(confirmed.empty());
+        else
+            ASSERT_EQ(confirmed.size(), 1u);
+    }
+    EXPECT_EQ(confirmed[0].id, 1u);
+    EXPECT_EQ(confirmed[0].hits, 30);
+    EXPECT_NEAR(confirmed[0].xyz[0], 2 + 29*frame_dt, 0.05);
+    EXPECT_NEAR(confirmed[0].velocity[0], 1, 0.1);
+    EXPECT_NEAR(confirmed[0].velocity[2], 0, 0.1);
+
+    EXPECT_THROW(PersonTracker(0, 0.1, 1.5, 3, 2), std::invalid_argument);
+    EXPECT_THROW(PersonTracker(2, 0.1, 1.5, 0, 2), std::invalid_argument);
+    EXPECT_NO_THROW(PersonTracker(
+        std::unordered_map<std::string, double>{}));
+}
+
+TEST(PersonTrackerTests, MissesTest) {
+    PersonTracker tracker(2, 0.1, 1.5, 3, 2);
+    std::vector<PersonTrack> confirmed;
+    int f = 0;
+    for (; f < 5; f++)
+        tracker.update({{{3, 0.9, 0}}}, f*frame_dt, &confirmed);
+    // A one-frame false positive never shows up
+    tracker.update({{{3, 0.9, 0}}, {{8, 0.9, 4}}}, f++*frame_dt, &confirmed);
+    EXPECT_EQ(confirmed.size(), 1u);
+    EXPECT_EQ(tracker.size(), 2u);
+
+    // The person is missed twice, coasting, then seen again
+    for (int miss = 1; miss <= 2; miss++) {
+        tracker.update({}, f++*frame_dt, &confirmed);
+        ASSERT_EQ(confirmed.size(), 1u);
+        EXPECT_EQ(confirmed[0].misses, miss);
+    }
+    EXPECT_EQ(tracker.size(), 1u);
+    tracker.update({{{3, 0.9, 0}}}, f++*frame_dt, &confirmed);
+    ASSERT_EQ(confirmed.size(), 1u);
+    EXPECT_EQ(confirmed[0].id, 1u);
+    EXPECT_EQ(confirmed[0].misses, 0);
+
+    for (int miss = 0; miss < 3; miss++)
+        tracker.update({}, f++*frame_dt, &confirmed);
+    EXPECT_TRUE(confirmed.empty());
+    EXPECT_EQ(tracker.size(), 0u);
+}
+
+/**
+ * @brief Two people crossing paths keep their ids, as the velocity carries each prediction past the other.
+ * 
+ */
+TEST(PersonTrackerTests, CrossingTest) {
+    PersonTracker tracker(1, 0.05, 1.5, 3, 2);
+    std::vector<PersonTrack> confirmed;
+    std::uint64_t id_a = 0, id_b = 0;
+    for (int f = 0; f < 60; f++) {
+        double t = f*frame_dt;
+        // A walks left to right, B walks away from the robot, and they
+        // pass within 0.2 m of each other at t = 3 s
+        std::array<double, 3> a{{5, 0.9, 3 - 1.0*t}};
+        std::array<double, 3> b{{2 + 1.0*t, 0.9, -0.2}};
+        tracker.update({a, b}, t, &confirmed);
+        if (f == 5) {
+            id_a = closest_id(confirmed, a);
+            id_b = closest_id(confirmed, b);
+            ASSERT_NE(id_a, id_b);
+        } else if (f > 5) {
+            ASSERT_EQ(confirmed.size(), 2u);
+            EXPECT_EQ(closest_id(confirmed, a), id_a);
+            EXPECT_EQ(closest_id(confirmed, b), id_b);
+        }
+    }
+}
+
+/**
+ * @brief Hundreds of people walking with noisy, unordered and sometimes missing positions keep their ids. They start 5 m apart and walk for 2 s, so no two come within 1 m.
+ * 
+ */
+TEST(PersonTrackerTests, CrowdTest) {
+    const int people = 300;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> heading(0, 2*std::atan(1.0)*4);
+    std::normal_distribution<double> noise(0, 0.05);
+    std::uniform_real_distribution<double> chance(0, 1);
+    std::vector<std::array<double, 4> > walkers;
+    for (int i = 0; i < people; i++)
+        walkers.push_back({{(i % 20)*5.0, (i/20)*5.0, heading(gen), 0}});
+
+    PersonTracker tracker(2, 0.05, 1.0, 3, 3);
+    std::vector<PersonTrack> confirmed;
+    std::vector<std::uint64_t> ids(people, 0);
+    for (int f = 0; f < 20; f++) {
+        std::vector<std::array<double, 3> > all_xyz;
+        for (auto& walker : walkers) {
+            walker[0] += frame_dt*std::cos(walker[2]);
+            walker[1] += frame_dt*std::sin(walker[2]);
+            if (f < 3 || chance(gen) > 0.05)
+                all_xyz.push_back({{walker[0] + noise(gen), 0.9,
+                    walker[1] + noise(gen)}});
+        }
+        std::shuffle(all_xyz.begin(), all_xyz.end(), gen);
+        tracker.update(all_xyz, f*frame_dt, &confirmed);
+        if (f < 2) continue;
+
+        ASSERT_EQ(confirmed.size(), static_cast<std::size_t>(people));
+        for (int i = 0; i < people; i++) {
+            auto id = closest_id(confirmed,
+                {{walkers[i][0], 0.9, walkers[i][1]}});
+            if (f == 2) ids[i] = id;
+            EXPECT_EQ(id, ids[i]);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file PixelProjectionTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Pixel Projection Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <gtest/gtest.h>
+#include <eigen3/Eigen/Dense>
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include "../include/DetectionBatch.hpp"
+#include "../include/PixelProjection.hpp"
+#include "../include/PositionEstimator.hpp"
+
+namespace {
+
+/**
+ * @brief Reference: the per-detection camera frame math, then the full 4x4 transform.
+ * 
+ */
+std::array<double, 3> reference_xyz(const Eigen::Matrix<double, 4, 4>& T,
+        double f, double density, double cx, double cy, double avg_height,
+        double x, double y, double w, double h) {
+    double camera_z = avg_height*f*density/h;
+    double scale = camera_z/(f*density);
+    Eigen::Vector4d camera_frame;
+    camera_frame << (x + w/2 - cx)*scale, (y + h/2 - cy)*scale, camera_z, 1;
+    Eigen::Vector4d rob_frame = T*camera_frame;
+    return {rob_frame[0], rob_frame[1], rob_frame[2]};
+}
+
+}  // namespace
+
+/**
+ * @brief Both precisions must match the reference, including the scalar tail of odd-sized batches.
+ * 
+ */
+TEST(PixelProjectionTests, MatchesReferenceTest) {
+    const double PI = std::atan(1.0)*4;
+    PositionEstimator estimator(0.3, -0.1, 1.2, 15*PI/180.0, 0.004, 150000,
+        608, 608, 1.7);
+    const auto& T = estimator.get_cam2robot_transform();
+
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<float> pos(-50.f, 600.f);
+    std::uniform_real_distribution<float> size(8.f, 400.f);
+    for (std::size_t n : {1, 3, 8, 13, 1001}) {
+        DetectionBatch batch;
+        for (std::size_t i = 0; i < n; i++)
+            batch.push_back(pos(gen), pos(gen), size(gen), size(gen));
+
+        std::vector<double> dx(n), dy(n), dz(n);
+        std::vector<float> fx(n), fy(n), fz(n);
+        const PixelProjection& projection = estimator.get_projection();
+        projection.project(batch.x(), batch.y(), batch.width(), batch.height(),
+            n, dx.data(), dy.data(), dz.data());
+        projection.project(batch.x(), batch.y(), batch.width(), batch.height(),
+            n, fx.data(), fy.data(), fz.data());
+
+        for (std::size_t i = 0; i < n; i++) {
+            auto expected = reference_xyz(T, 0.004, 150000, 304, 304, 1.7,
+                batch.x()[i], batch.y()[i], batch.width()[i],
+                batch.height()[i]);
+            EXPECT_NEAR(dx[i], expected[0], 1e-9);
+            EXPECT_NEAR(dy[i], expected[1], 1e-9);
+            EXPECT_NEAR(dz[i], expected[2], 1e-9);
+            double tolerance = 1e-5*(1 + std::abs(expected[2]));
+            EXPECT_NEAR(fx[i], expected[0], tolerance);
+            EXPECT_NEAR(fy[i], expected[1], tolerance);
+            EXPECT_NEAR(fz[i], expected[2], tolerance);
+        }
+    }
+}
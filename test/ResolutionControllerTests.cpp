@@ -0,0 +1,97 @@
+/**
+ * @file ResolutionControllerTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Resolution Controller Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../include/ResolutionController.hpp"
+
+namespace {
+
+/**
+ * @brief Synthetic latency proportional to the pixel count of the input
+ * 
+ */
+double latency_ms(const ResolutionController& controller,
+        double ms_per_kpx) {
+    auto size = controller.get_input_size();
+    return ms_per_kpx*size[0]*size[1]/1000;
+}
+
+}  // namespace
+
+/**
+ * @brief Input heights keep the aspect ratio, rounded to a multiple of 32.
+ * 
+ */
+TEST(ResolutionControllerTests, InputSizeTest) {
+    ResolutionController controller({320, 416, 512, 608}, 0.75, 100, 400);
+    auto size = controller.get_input_size();
+    EXPECT_EQ(size[0], 416);
+    EXPECT_EQ(size[1], 320);
+    EXPECT_EQ(size[1] % 32, 0);
+
+    EXPECT_THROW(ResolutionController({}, 1, 100, 416),
+        std::invalid_argument);
+    EXPECT_THROW(ResolutionController({416, 500}, 1, 100, 416),
+        std::invalid_argument);
+    EXPECT_THROW(ResolutionController({416}, 1, 0, 416),
+        std::invalid_argument);
+}
+
+/**
+ * @brief A slow machine settles at the largest size under the target, and stays there.
+ * 
+ */
+TEST(ResolutionControllerTests, StepDownTest) {
+    ResolutionController controller({320, 416, 512, 608}, 1, 100, 608);
+    // 608 takes 185 ms, 512 takes 131 ms, 416 takes 87 ms.
+    for (int i = 0; i < 200; i++)
+        controller.record(latency_ms(controller, 0.5));
+    EXPECT_EQ(controller.get_input_size()[0], 416);
+
+    auto stats = controller.get_stats();
+    EXPECT_EQ(stats.changes, 2u);
+    EXPECT_EQ(stats.frames_at_size[0], 0u);
+    EXPECT_EQ(stats.frames_at_size[1], 190u);
+    std::size_t frames = 0;
+    for (auto count : stats.frames_at_size) frames += count;
+    EXPECT_EQ(frames, 200u);
+}
+
+/**
+ * @brief With headroom to spare the controller steps up to the largest size.
+ * 
+ */
+TEST(ResolutionControllerTests, StepUpTest) {
+    std::unordered_map<std::string, double> params{
+        {"IMG_WIDTH_REQ", 416}, {"IMG_HEIGHT_REQ", 416},
+        {"LATENCY_TARGET", 100}, {"ADAPTIVE_MIN_WIDTH", 320},
+        {"ADAPTIVE_MAX_WIDTH", 608}, {"ADAPTIVE_WIDTH_STEP", 96}};
+    ResolutionController controller(params);
+    EXPECT_EQ(controller.get_input_size()[0], 416);
+
+    for (int i = 0; i < 50; i++)
+        controller.record(latency_ms(controller, 0.1));
+    EXPECT_EQ(controller.get_input_size()[0], 608);
+    EXPECT_EQ(controller.get_stats().changes, 2u);
+
+    // A load spike moves it back down.
+    for (int i = 0; i < 50; i++)
+        controller.record(latency_ms(controller, 0.5));
+    EXPECT_LE(controller.get_input_size()[0], 416);
+}
@@ -0,0 +1,151 @@
+/**
+ * @file StageTimersTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Stage Timers Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+
+#include "../include/Detection.hpp"
+#include "../include/StageTimers.hpp"
+#include "../include/PositionEstimator.hpp"
+#include "../include/utils.hpp"
+
+namespace {
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path.c_str());
+    return std::string(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+/**
+ * @brief Scoped timers record into their own stage, and nothing without timers.
+ * 
+ */
+TEST(StageTimersTests, ScopedTimerTest) {
+    StageTimers timers;
+    {
+        STAGE_TIMER(&timers, Stage::FRAME);
+        {
+            STAGE_TIMER(&timers, Stage::FORWARD);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        STAGE_TIMER(nullptr, Stage::NMS);
+    }
+
+#ifdef NO_STAGE_TIMERS
+    EXPECT_EQ(timers.summary(Stage::FRAME).count, 0u);
+#else
+    EXPECT_EQ(timers.summary(Stage::FORWARD).count, 1u);
+    EXPECT_GE(timers.summary(Stage::FORWARD).max_ms, 5);
+    EXPECT_EQ(timers.summary(Stage::FRAME).count, 1u);
+    EXPECT_GE(timers.summary(Stage::FRAME).max_ms,
+        timers.summary(Stage::FORWARD).max_ms);
+#endif
+    EXPECT_EQ(timers.summary(Stage::NMS).count, 0u);
+
+    // Estimators record only once given the timers
+    PositionEstimator estimator(0, 0, 1, 0, 0.004, 250000, 416, 416, 1.7);
+    std::vector<Detection> detections(3, Detection{200, 100, 50, 200});
+    std::vector<std::array<double, 3> > all_xyz;
+    estimator.estimate_all_xyz(detections, &all_xyz);
+    estimator.set_stage_timers(&timers);
+    estimator.estimate_all_xyz(detections, &all_xyz);
+#ifndef NO_STAGE_TIMERS
+    EXPECT_EQ(timers.summary(Stage::ESTIMATE_XYZ).count, 1u);
+#endif
+
+    timers.reset();
+    EXPECT_EQ(timers.summary(Stage::FRAME).count, 0u);
+}
+
+TEST(StageTimersTests, ExportTest) {
+    StageTimers timers;
+    for (int ms = 1; ms <= 3; ms++)
+        timers[Stage::FORWARD].record(std::chrono::milliseconds(ms));
+    timers[Stage::NMS].record(std::chrono::microseconds(250));
+
+    std::ostringstream json;
+    timers.write_json(json);
+    EXPECT_NE(json.str().find("\"forward\": {\"count\": 3, \"mean_ms\": 2, "
+        "\"p50_ms\": 2.0"), std::string::npos);
+    EXPECT_NE(json.str().find("\"max_ms\": 3}"), std::string::npos);
+    EXPECT_NE(json.str().find("\"prep_frame\": {\"count\": 0"),
+        std::string::npos);
+    EXPECT_EQ(json.str().front(), '{');
+    EXPECT_EQ(json.str().substr(json.str().size() - 2), "}\n");
+
+    std::ostringstream prometheus;
+    timers.write_prometheus(prometheus);
+    const std::string text = prometheus.str();
+    EXPECT_NE(text.find("# TYPE vision_stage_latency_seconds summary\n"),
+        std::string::npos);
+    EXPECT_NE(text.find("vision_stage_latency_seconds{stage=\"forward\","
+        "quantile=\"0.5\"} 0.0020"), std::string::npos);
+    EXPECT_NE(text.find("vision_stage_latency_seconds_count{stage=\"forward\"}"
+        " 3\n"), std::string::npos);
+    EXPECT_NE(text.find("vision_stage_latency_seconds_sum{stage=\"forward\"}"
+        " 0.006\n"), std::string::npos);
+    EXPECT_NE(text.find("vision_stage_latency_max_seconds{stage=\"nms\"} "
+        "0.00025\n"), std::string::npos);
+}
+
+/**
+ * @brief The dump thread keeps both files current, and its errors come out of stop_dump().
+ * 
+ */
+TEST(StageTimersTests, DumpTest) {
+    auto dir = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("%%%%-stage-timers");
+    boost::filesystem::create_directories(dir);
+    std::string json_path = (dir / "timings.json").string();
+    std::string prometheus_path = (dir / "timings.prom").string();
+
+    StageTimers timers;
+    EXPECT_THROW(timers.start_dump(json_path, prometheus_path,
+        std::chrono::milliseconds(0)), std::invalid_argument);
+    timers.start_dump(json_path, prometheus_path,
+        std::chrono::milliseconds(10));
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!boost::filesystem::exists(prometheus_path) &&
+            std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_TRUE(boost::filesystem::exists(json_path));
+    ASSERT_TRUE(boost::filesystem::exists(prometheus_path));
+
+    // The last dump on stopping has everything recorded before it
+    timers[Stage::FRAME].record(std::chrono::milliseconds(150));
+    timers.stop_dump();
+    EXPECT_NE(read_file(json_path).find("\"frame\": {\"count\": 1"),
+        std::string::npos);
+    EXPECT_NE(read_file(prometheus_path).find(
+        "vision_stage_latency_seconds_count{stage=\"frame\"} 1\n"),
+        std::string::npos);
+    EXPECT_FALSE(boost::filesystem::exists(json_path + ".tmp"));
+
+    timers.start_dump((dir / "missing" / "timings.json").string(), "",
+        std::chrono::milliseconds(10));
+    EXPECT_THROW(timers.stop_dump(), InvalidFile);
+    EXPECT_NO_THROW(timers.stop_dump());
+    boost::filesystem::remove_all(dir);
+}
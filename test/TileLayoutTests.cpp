@@ -0,0 +1,175 @@
+/**
+ * @file TileLayoutTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Tile Layout Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/params_vec.hpp"
+#include "../include/Detection.hpp"
+#include "../include/TileLayout.hpp"
+#include "../include/LabelParser.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/HumanDetector.hpp"
+
+/**
+ * @brief Tiles are inside the frame, the same size, cover the band and overlap by at least the requested fraction.
+ * 
+ */
+TEST(TileLayoutTests, BandCoverageTest) {
+    TileLayout layout(0.1, 0.6, 0.25, cv::Size(416, 416));
+    cv::Size frame(1920, 1080);
+    const auto& tiles = layout.get_tiles(frame);
+    ASSERT_FALSE(tiles.empty());
+
+    std::vector<int> xs, ys;
+    for (const auto& tile : tiles) {
+        EXPECT_EQ(tile.size(), cv::Size(416, 416));
+        EXPECT_GE(tile.x, 0);
+        EXPECT_GE(tile.y, 0);
+        EXPECT_LE(tile.x + tile.width, frame.width);
+        EXPECT_LE(tile.y + tile.height, frame.height);
+        if (ys.empty() || ys.back() != tile.y) ys.push_back(tile.y);
+        if (ys.size() == 1) xs.push_back(tile.x);
+    }
+
+    EXPECT_EQ(xs.front(), 0);
+    EXPECT_EQ(xs.back() + 416, frame.width);
+    for (std::size_t i = 1; i < xs.size(); i++)
+        EXPECT_GE(xs[i - 1] + 416 - xs[i], 0.25*416);
+
+    EXPECT_EQ(ys.front(), 108);
+    EXPECT_GE(ys.back() + 416, 648);
+    for (std::size_t i = 1; i < ys.size(); i++)
+        EXPECT_GE(ys[i - 1] + 416 - ys[i], 0.25*416);
+}
+
+TEST(TileLayoutTests, SmallFrameTest) {
+    TileLayout layout(0.8, 1.0, 0.2, cv::Size(416, 416));
+    const auto& small = layout.get_tiles(cv::Size(300, 200));
+    ASSERT_EQ(small.size(), 1u);
+    EXPECT_EQ(small[0], cv::Rect(0, 0, 300, 200));
+
+    // A band at the bottom of the frame is shifted back inside it.
+    const auto& bottom = layout.get_tiles(cv::Size(416, 1000));
+    ASSERT_EQ(bottom.size(), 1u);
+    EXPECT_EQ(bottom[0], cv::Rect(0, 584, 416, 416));
+}
+
+TEST(TileLayoutTests, InvalidLayoutTest) {
+    EXPECT_THROW(TileLayout(0.5, 0.5, 0.2, cv::Size(416, 416)),
+        std::invalid_argument);
+    EXPECT_THROW(TileLayout(0, 1.2, 0.2, cv::Size(416, 416)),
+        std::invalid_argument);
+    EXPECT_THROW(TileLayout(0, 0.5, 1, cv::Size(416, 416)),
+        std::invalid_argument);
+}
+
+namespace {
+
+/**
+ * @brief Converts a detection from the IMG_WIDTH_REQ x IMG_HEIGHT_REQ space back to frame pixels
+ * 
+ */
+cv::Rect2d to_frame(const Detection& detection, const cv::Size& frame) {
+    double scale_x = frame.width/416.0;
+    double scale_y = frame.height/416.0;
+    return cv::Rect2d(detection.x*scale_x, detection.y*scale_y,
+        detection.width*scale_x, detection.height*scale_y);
+}
+
+/**
+ * @brief Counts the detections centered inside a box given in frame pixels
+ * 
+ */
+int count_centered_in(const std::vector<Detection>& detections,
+        const cv::Rect2d& box, const cv::Size& frame) {
+    int count = 0;
+    for (const auto& detection : detections) {
+        cv::Rect2d rect = to_frame(detection, frame);
+        if (box.contains(cv::Point2d(rect.x + rect.width/2,
+                rect.y + rect.height/2)))
+            count++;
+    }
+    return count;
+}
+
+}  // namespace
+
+/**
+ * @brief A small person, a person cut by a tile seam and a person in the last tile are each found exactly once with tiles.
+ * 
+ */
+TEST(TileLayoutTests, TiledDetectionTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        ParamParser parser(all_params::params);
+        auto ret_params = parser.parse_robot_params(
+            "../robot_params/robot_params.txt");
+        HumanDetector detector(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+
+        // Labels are in 416 x 416 pixels. The second person of 1_262 is
+        // well separated from the others.
+        LabelParser label_parser;
+        auto label = label_parser.parse_file("../dataset/labels/1_262.txt");
+        ASSERT_EQ(label->all_detections.size(), 4u);
+        const Detection& person = label->all_detections[1];
+
+        cv::Size frame_size(1280, 720);
+        cv::Mat frame(frame_size, CV_8UC3, cv::Scalar(114, 114, 114));
+        TileLayout layout(ret_params);
+        const auto& tiles = layout.get_tiles(frame_size);
+        ASSERT_GE(tiles.size(), 2u);
+        int seam = tiles[0].x + tiles[0].width;
+
+        // Half size at the left, centered on the first seam, and in the
+        // last tile at the right edge of the frame
+        std::vector<cv::Rect> copies{
+            cv::Rect(0, 0, 128, 128),
+            cv::Rect(seam - 128, 0, 256, 256),
+            cv::Rect(frame_size.width - 256, 0, 256, 256)};
+        std::vector<cv::Rect2d> people;
+        for (const auto& copy : copies) {
+            cv::Mat img;
+            cv::resize(label->img, img, copy.size());
+            img.copyTo(frame(copy));
+            double scale = copy.width/416.0;
+            people.emplace_back(copy.x + person.x*scale,
+                copy.y + person.y*scale, person.width*scale,
+                person.height*scale);
+        }
+        ASSERT_LT(people[1].x, seam);
+        ASSERT_GT(people[1].x + people[1].width, seam);
+
+        auto tiled = detector.detect_tiled(frame);
+        for (std::size_t i = 0; i < people.size(); i++)
+            EXPECT_EQ(count_centered_in(*tiled, people[i], frame_size), 1)
+                << "copy " << i;
+
+        // A seam must not leave a partial box next to the whole one
+        for (std::size_t i = 0; i < tiled->size(); i++) {
+            cv::Rect2d a = to_frame((*tiled)[i], frame_size);
+            for (std::size_t j = i + 1; j < tiled->size(); j++) {
+                cv::Rect2d b = to_frame((*tiled)[j], frame_size);
+                double smaller = std::min(a.area(), b.area());
+                EXPECT_LT((a & b).area(), 0.5*smaller)
+                    << "boxes " << i << " and " << j;
+            }
+        }
+    }
+    EXPECT_TRUE(true);
+}
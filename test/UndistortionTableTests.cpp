@@ -0,0 +1,129 @@
+/**
+ * @file UndistortionTableTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Undistortion Table Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <math.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../include/Detection.hpp"
+#include "../include/DetectionBatch.hpp"
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/PositionEstimator.hpp"
+#include "../include/UndistortionTable.hpp"
+
+namespace {
+
+/**
+ * @brief A 1280x720 wide-angle camera with strong barrel distortion
+ * 
+ */
+CameraIntrinsics wide_angle() {
+    CameraIntrinsics intrinsics;
+    intrinsics.width = 1280;
+    intrinsics.height = 720;
+    intrinsics.fx = intrinsics.fy = 640;
+    intrinsics.cx = 650;
+    intrinsics.cy = 355;
+    intrinsics.distortion = {{-0.3, 0.09, 0.001, -0.0005, -0.01}};
+    return intrinsics;
+}
+
+}  // namespace
+
+TEST(UndistortionTableTests, PinholeRaysTest) {
+    CameraIntrinsics intrinsics = wide_angle();
+    intrinsics.distortion = {};
+    UndistortionTable table(intrinsics, 416, 416);
+    for (float u : {0.f, 13.f, 207.5f, 416.f}) {
+        for (float v : {0.f, 101.f, 399.9f}) {
+            auto ray = table.ray(u, v);
+            EXPECT_NEAR(ray[0], (u*1280/416 - 650)/640, 1e-5);
+            EXPECT_NEAR(ray[1], (v*720/416 - 355)/640, 1e-5);
+        }
+    }
+}
+
+/**
+ * @brief Rays distorted into pixels must be recovered by the table, up to interpolation error.
+ * 
+ */
+TEST(UndistortionTableTests, RoundTripTest) {
+    CameraIntrinsics intrinsics = wide_angle();
+    UndistortionTable table(intrinsics, 416, 416, 4);
+    for (double x = -0.9; x <= 0.9; x += 0.15) {
+        for (double y = -0.5; y <= 0.5; y += 0.1) {
+            auto pixel = intrinsics.distort(x, y);
+            auto exact = intrinsics.undistort(pixel[0], pixel[1]);
+            EXPECT_NEAR(exact[0], x, 1e-6);
+            EXPECT_NEAR(exact[1], y, 1e-6);
+
+            auto ray = table.ray(pixel[0]*416/1280, pixel[1]*416/720);
+            EXPECT_NEAR(ray[0], x, 2e-3);
+            EXPECT_NEAR(ray[1], y, 2e-3);
+        }
+    }
+}
+
+/**
+ * @brief Without distortion, the table path must agree with the pinhole estimate of the same camera.
+ * 
+ */
+TEST(UndistortionTableTests, MatchesPinholeEstimateTest) {
+    const double PI = std::atan(1.0)*4;
+    // f*density = fx in 416 px wide frame pixels
+    PositionEstimator estimator(0.2, 0, 1.0, 10*PI/180.0, 0.004, 52000,
+        416, 416, 1.7);
+    std::vector<Detection> detections{{100, 40, 30, 120}, {200, 150, 16, 60},
+        {10, 0, 50, 300}};
+    std::vector<std::array<double, 3> > expected;
+    estimator.estimate_all_xyz(DetectionBatch(detections), &expected);
+
+    CameraIntrinsics intrinsics;
+    intrinsics.width = intrinsics.height = 832;
+    intrinsics.fx = intrinsics.fy = 0.004*52000*2;
+    intrinsics.cx = intrinsics.cy = 416;
+    estimator.set_undistortion(std::make_shared<const UndistortionTable>(
+        intrinsics, 416, 416));
+
+    std::vector<std::array<double, 3> > all_xyz;
+    estimator.estimate_all_xyz(DetectionBatch(detections), &all_xyz);
+    for (std::size_t i = 0; i < detections.size(); i++) {
+        auto single = estimator.estimate_xyz(detections[i]);
+        for (int j = 0; j < 3; j++) {
+            EXPECT_NEAR(all_xyz[i][j], expected[i][j], 1e-4);
+            EXPECT_NEAR(single[j], expected[i][j], 1e-4);
+        }
+    }
+}
+
+TEST(UndistortionTableTests, RobotParamsTest) {
+    ParamParser parser(all_params::params);
+    auto ret_params = parser.parse_robot_params(
+        "../robot_params/robot_params.txt");
+    CameraIntrinsics intrinsics(ret_params);
+    EXPECT_EQ(intrinsics.width, 1280);
+    EXPECT_DOUBLE_EQ(intrinsics.distortion[0], -0.28);
+
+    ret_params["LENS_UNDISTORT"] = 1;
+    PositionEstimator estimator(ret_params);
+    auto xyz = estimator.estimate_xyz({200, 100, 20, 150});
+    EXPECT_TRUE(std::isfinite(xyz[0]) && std::isfinite(xyz[2]));
+
+    ret_params["CAM_FX"] = 0;
+    EXPECT_THROW(PositionEstimator bad(ret_params), std::invalid_argument);
+}
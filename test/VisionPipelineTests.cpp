@@ -0,0 +1,113 @@
+/**
+ * @file VisionPipelineTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Vision Pipeline Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+#include <string>
+#include <opencv2/opencv.hpp>
+#include <boost/filesystem.hpp>
+
+#include "../include/params_vec.hpp"
+#include "../include/ParamParser.hpp"
+#include "../include/BoundedQueue.hpp"
+#include "../include/HumanDetector.hpp"
+#include "../include/PositionEstimator.hpp"
+#include "../include/VisionPipeline.hpp"
+
+TEST(VisionPipelineTests, BoundedQueueOrderTest) {
+    BoundedQueue<int> queue(3);
+    std::thread producer([&queue]() {
+        for (int i = 0; i < 100; i++) queue.push(i);
+        queue.close();
+    });
+
+    int expected = 0;
+    int item;
+    while (queue.pop(&item)) {
+        EXPECT_EQ(item, expected);
+        expected++;
+    }
+    producer.join();
+
+    EXPECT_EQ(expected, 100);
+    EXPECT_LE(queue.get_max_depth(), std::size_t{3});
+}
+
+TEST(VisionPipelineTests, BoundedQueueCloseTest) {
+    BoundedQueue<int> queue(2);
+    EXPECT_TRUE(queue.push(1));
+    queue.close();
+    EXPECT_FALSE(queue.push(2));
+
+    int item;
+    ASSERT_TRUE(queue.pop(&item));
+    EXPECT_EQ(item, 1);
+    EXPECT_FALSE(queue.pop(&item));
+}
+
+/**
+ * @brief Streamed results must match the sequential path frame by frame.
+ * 
+ */
+TEST(VisionPipelineTests, StreamMatchesSequentialTest) {
+    if (boost::filesystem::exists("../robot_params/yolov4.weights")) {
+        ParamParser parser(all_params::params);
+        auto ret_params = parser.parse_robot_params(
+            "../robot_params/robot_params.txt");
+        HumanDetector detector(ret_params, "../robot_params/coco.names",
+            "../robot_params/yolov4.cfg", "../robot_params/yolov4.weights");
+        PositionEstimator estimator(ret_params);
+
+        std::vector<cv::Mat> frames;
+        for (int i = 0; i < 6; i++)
+            frames.push_back(cv::imread("../dataset/1/1_" +
+                std::to_string(260 + i) + ".png"));
+
+        std::vector<std::vector<std::array<double, 3> > > expected;
+        for (const auto& frame : frames) {
+            auto prepped = detector.prep_frame(frame);
+            auto detections = detector.detect(*prepped);
+            expected.push_back(*estimator.estimate_all_xyz(*detections));
+        }
+
+        VisionPipeline pipeline(&detector, &estimator, 2);
+        std::thread producer([&]() {
+            for (const auto& frame : frames) pipeline.push(frame);
+            pipeline.finish();
+        });
+
+        // Assert only once the producer is joined, so a failure is reported
+        // instead of destroying a joinable thread.
+        std::vector<std::shared_ptr<std::vector<std::array<double, 3> > > >
+            results;
+        std::shared_ptr<std::vector<std::array<double, 3> > > all_xyz;
+        while (pipeline.pop(&all_xyz)) results.push_back(all_xyz);
+        producer.join();
+
+        ASSERT_EQ(results.size(), expected.size());
+        for (std::size_t idx = 0; idx < results.size(); idx++) {
+            ASSERT_EQ(results[idx]->size(), expected[idx].size());
+            for (std::size_t i = 0; i < results[idx]->size(); i++)
+                for (std::size_t j = 0; j < 3; j++)
+                    EXPECT_NEAR((*results[idx])[i][j], expected[idx][i][j],
+                        1e-6);
+        }
+
+        auto stats = pipeline.get_stats();
+        EXPECT_EQ(stats.frames_out, frames.size());
+        EXPECT_GT(stats.throughput_fps, 0);
+    }
+    EXPECT_TRUE(true);
+}
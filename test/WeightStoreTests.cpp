@@ -0,0 +1,83 @@
+/**
+ * @file WeightStoreTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief Weight Store Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <boost/filesystem.hpp>
+
+#include "../include/utils.hpp"
+#include "../include/MappedFile.hpp"
+#include "../include/WeightStore.hpp"
+
+namespace {
+
+std::string write_temp_file(const std::string& name,
+        const std::string& contents) {
+    auto path = boost::filesystem::temp_directory_path() / name;
+    std::ofstream outfile(path.string().c_str(), std::ios::binary);
+    outfile << contents;
+    return path.string();
+}
+
+}  // namespace
+
+TEST(WeightStoreTests, MappedFileTest) {
+    std::string contents("weights\0bytes", 13);
+    MappedFile mapped(write_temp_file("mapped_file_test.bin", contents));
+    ASSERT_EQ(mapped.size(), contents.size());
+    EXPECT_EQ(std::string(mapped.data(), mapped.size()), contents);
+
+    MappedFile empty(write_temp_file("mapped_file_empty.bin", ""));
+    EXPECT_EQ(empty.size(), 0u);
+
+    EXPECT_THROW(MappedFile("../robot_params/missing.weights"), InvalidFile);
+}
+
+/**
+ * @brief Repeated requests share one mapped model while it is held, and it is released with its last holder.
+ * 
+ */
+TEST(WeightStoreTests, SharedModelTest) {
+    auto cfg_path = write_temp_file("weight_store_test.cfg", "[net]\n");
+    auto weight_path = write_temp_file("weight_store_test.weights",
+        std::string(4096, '\1'));
+    WeightStore::clear();
+
+    auto first = WeightStore::get(cfg_path, weight_path);
+    auto second = WeightStore::get(cfg_path, weight_path);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(first->get_weight_bytes(), 4096u);
+    EXPECT_GE(first->get_load_ms(), 0.0);
+    EXPECT_EQ(WeightStore::size(), 1u);
+
+    WeightStore::clear();
+    EXPECT_EQ(WeightStore::size(), 0u);
+    EXPECT_NE(WeightStore::get(cfg_path, weight_path).get(), first.get());
+
+    // Nobody holds the model loaded after clear(), so it is gone already
+    EXPECT_EQ(WeightStore::size(), 0u);
+    std::weak_ptr<const DarknetModel> released = first;
+    first.reset();
+    second.reset();
+    EXPECT_TRUE(released.expired());
+
+    EXPECT_THROW(WeightStore::get(cfg_path, "../robot_params/missing.weights"),
+        InvalidFile);
+}
+
+TEST(WeightStoreTests, ResidentMemoryTest) {
+    EXPECT_GT(resident_memory_bytes(), 0u);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file YoloDecoderTests.cpp
+ * @author Dani Lerner
+ * @author Diane Ngo
+ * @brief YOLO Decoder Tests
+ * @version 0.1
+ * @date 2021-10-25
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+#include <string>
+#include <opencv2/opencv.hpp>
+
+#include "../include/YoloDecoder.hpp"
+#include "../include/FramePreprocessor.hpp"
+
+namespace {
+const int num_classes = 3;
+const int cols = 5 + num_classes;
+const std::vector<std::string> class_names{"bicycle", "person", "car"};
+
+/**
+ * @brief Appends an output row. Class scores are objectness*P(class), like the region layer output.
+ * 
+ */
+void add_row(std::vector<float>* data, float cx, float cy, float w, float h,
+        float objectness, const std::array<float, num_classes>& probs) {
+    data->insert(data->end(), {cx, cy, w, h, objectness});
+    for (float prob : probs) data->push_back(objectness*prob);
+}
+}  // namespace
+
+TEST(YoloDecoderTests, MissingPersonClassTest) {
+    EXPECT_ANY_THROW(YoloDecoder decoder({"bicycle", "car"}, 0.5));
+    YoloDecoder decoder(class_names, 0.5);
+    EXPECT_EQ(decoder.get_person_idx(), 1);
+}
+
+TEST(YoloDecoderTests, PersonOnlyDecodeTest) {
+    std::vector<float> data;
+    // Enough rows to exercise both the 8-row SIMD blocks and the tail.
+    for (int i = 0; i < 20; i++)
+        add_row(&data, 0.5f, 0.5f, 0.1f, 0.2f, 0.1f, {{0.f, 1.f, 0.f}});
+    add_row(&data, 0.5f, 0.25f, 0.25f, 0.5f, 0.9f, {{0.f, 0.9f, 0.1f}});
+    add_row(&data, 0.5f, 0.5f, 0.5f, 0.5f, 0.9f, {{0.f, 0.1f, 0.9f}});
+    add_row(&data, 0.75f, 0.5f, 0.1f, 0.1f, 0.9f, {{0.f, 0.6f, 0.f}});
+    int rows = static_cast<int>(data.size()/cols);
+
+    YoloDecoder decoder(class_names, 0.5);
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    decoder.decode(data.data(), rows, cols, Letterbox(), {{400, 200}},
+        &boxes, &scores);
+
+    ASSERT_EQ(boxes.size(), std::size_t{2});
+    ASSERT_EQ(scores.size(), std::size_t{2});
+    EXPECT_NEAR(scores[0], 0.81, 1e-5);
+    EXPECT_EQ(boxes[0].x, 150);
+    EXPECT_EQ(boxes[0].y, 0);
+    EXPECT_EQ(boxes[0].width, 100);
+    EXPECT_EQ(boxes[0].height, 100);
+    EXPECT_NEAR(scores[1], 0.54, 1e-5);
+    EXPECT_EQ(boxes[1].x, 280);
+
+    // Buffers are appended to, so several layers can share them.
+    decoder.decode(data.data(), rows, cols, Letterbox(), {{400, 200}},
+        &boxes, &scores);
+    EXPECT_EQ(boxes.size(), std::size_t{4});
+}
+
+TEST(YoloDecoderTests, LetterboxDecodeTest) {
+    std::vector<float> data;
+    add_row(&data, 0.5f, 0.5f, 0.5f, 0.5f, 0.9f, {{0.f, 1.f, 0.f}});
+
+    Letterbox letterbox;
+    letterbox.offset = {{0.f, 0.125f}};
+    letterbox.gain = {{1.f, 4.f/3.f}};
+
+    YoloDecoder decoder(class_names, 0.5);
+    std::vector<cv::Rect> boxes;
+    std::vector<float> scores;
+    decoder.decode(data.data(), 1, cols, letterbox, {{416, 416}},
+        &boxes, &scores);
+
+    ASSERT_EQ(boxes.size(), std::size_t{1});
+    EXPECT_EQ(boxes[0].x, 104);
+    EXPECT_EQ(boxes[0].y, 70);
+    EXPECT_EQ(boxes[0].width, 208);
+    EXPECT_EQ(boxes[0].height, 277);
+}